@@ -63,6 +63,55 @@
 */
 #define LIS3DH_OUT_ADC_3H 0x0D
 
+/**
+*   \brief Rate of the temperature readings, paced by the SysTick timer
+*/
+#define READ_RATE_HZ 10
+
+static volatile uint8_t SysTick_read; // Flag set by the SysTick callback
+
+/*
+* SysTick callback, at READ_RATE_HZ: ask the main loop for a reading.
+*/
+static void SysTick_Callback(void)
+{
+    SysTick_read = 1;
+}
+
+/**
+*   \brief Boot time of the LIS3DH after power-up ("about 5 milliseconds"),
+*   first and longest wait between two polls of WHO_AM_I meanwhile, in us
+*/
+#define LIS3DH_BOOT_MAX_US 5000
+#define LIS3DH_BOOT_POLL_US 100
+#define LIS3DH_BOOT_POLL_MAX_US 1000
+
+/*
+* Poll WHO_AM_I until the LIS3DH acknowledges it at the end of its boot,
+* doubling the wait between two polls, for LIS3DH_BOOT_MAX_US at most.
+* Returns the outcome of the last read.
+*/
+static ErrorCode WaitBoot(uint8_t* who_am_i)
+{
+    uint16_t wait_us = LIS3DH_BOOT_POLL_US;
+    uint16_t waited_us = 0;
+    ErrorCode error;
+    
+    for (;;)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                            LIS3DH_WHO_AM_I_REG_ADDR,
+                                            who_am_i);
+        if (error == NO_ERROR || waited_us >= LIS3DH_BOOT_MAX_US)
+        {
+            return error;
+        }
+        CyDelayUs(wait_us);
+        waited_us += wait_us;
+        wait_us = (2 * wait_us > LIS3DH_BOOT_POLL_MAX_US) ? LIS3DH_BOOT_POLL_MAX_US : 2 * wait_us;
+    }
+}
+
 int main(void)
 {
     CyGlobalIntEnable; /* Enable global interrupts. */
@@ -71,7 +120,9 @@ int main(void)
     I2C_Peripheral_Start();
     UART_Debug_Start();
     
-    CyDelay(5); //"The boot procedure is complete about 5 milliseconds after device power-up."
+    //"The boot procedure is complete about 5 milliseconds after device power-up."
+    uint8_t who_am_i_reg = 0;
+    ErrorCode error = WaitBoot(&who_am_i_reg);
     
     // String to print out messages on the UART
     char message[50];
@@ -92,11 +143,7 @@ int main(void)
     /*            I2C Reading                 */
     /******************************************/
     
-    /* Read WHO AM I REGISTER register */
-    uint8_t who_am_i_reg;
-    ErrorCode error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
-                                                  LIS3DH_WHO_AM_I_REG_ADDR, 
-                                                  &who_am_i_reg);
+    /* WHO AM I REGISTER register, as read at the end of the boot */
     if (error == NO_ERROR)
     {
         sprintf(message, "WHO AM I REG: 0x%02X [Expected: 0x33]\r\n", who_am_i_reg);
@@ -275,9 +322,32 @@ int main(void)
     OutArray[0] = header;
     OutArray[3] = footer;
     
+    /* The SysTick interrupt paces the readings instead of a delay: it
+    starts at 1 kHz and is slowed down to READ_RATE_HZ */
+    SysTick_read = 0;
+    CySysTickStart();
+    CySysTickSetReload(BCLK__BUS_CLK__HZ / READ_RATE_HZ - 1);
+    CySysTickClear();
+    CySysTickSetCallback(0, SysTick_Callback);
+    
     for(;;)
     {
-        CyDelay(100);
+        /* Halt the CPU with WFI until the SysTick callback asks for a
+        reading: the clocks keep running and the SysTick interrupt ends the
+        wait. Interrupts are disabled around the check so that the callback
+        cannot slip in between the check and the halt: WFI still returns on
+        an interrupt pending while they are masked, which is serviced as
+        soon as they are enabled again. */
+        CyGlobalIntDisable;
+        while (!SysTick_read)
+        {
+            CY_PM_WFI;
+            CyGlobalIntEnable;
+            CyGlobalIntDisable;
+        }
+        CyGlobalIntEnable;
+        SysTick_read = 0;
+        
         error = I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS,
                                             LIS3DH_OUT_ADC_3L,
                                             2,
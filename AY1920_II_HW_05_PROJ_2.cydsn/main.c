@@ -95,6 +95,40 @@
 
 
 
+/**
+*   \brief Boot time of the LIS3DH after power-up ("about 5 milliseconds"),
+*   first and longest wait between two polls of WHO_AM_I meanwhile, in us
+*/
+#define LIS3DH_BOOT_MAX_US 5000
+#define LIS3DH_BOOT_POLL_US 100
+#define LIS3DH_BOOT_POLL_MAX_US 1000
+
+/*
+* Poll WHO_AM_I until the LIS3DH acknowledges it at the end of its boot,
+* doubling the wait between two polls, for LIS3DH_BOOT_MAX_US at most.
+* Returns the outcome of the last read.
+*/
+static ErrorCode WaitBoot(uint8_t* who_am_i)
+{
+    uint16_t wait_us = LIS3DH_BOOT_POLL_US;
+    uint16_t waited_us = 0;
+    ErrorCode error;
+    
+    for (;;)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                            LIS3DH_WHO_AM_I_REG_ADDR,
+                                            who_am_i);
+        if (error == NO_ERROR || waited_us >= LIS3DH_BOOT_MAX_US)
+        {
+            return error;
+        }
+        CyDelayUs(wait_us);
+        waited_us += wait_us;
+        wait_us = (2 * wait_us > LIS3DH_BOOT_POLL_MAX_US) ? LIS3DH_BOOT_POLL_MAX_US : 2 * wait_us;
+    }
+}
+
 int main(void)
 {
     CyGlobalIntEnable; /* Enable global interrupts. */
@@ -105,7 +139,9 @@ int main(void)
     Timer_Start();
     isr_Timer_StartEx(Custom_Timer_ISR);
     
-    CyDelay(5); //"The boot procedure is complete about 5 milliseconds after device power-up."
+    //"The boot procedure is complete about 5 milliseconds after device power-up."
+    uint8_t who_am_i_reg = 0;
+    ErrorCode error = WaitBoot(&who_am_i_reg);
     
     // String to print out messages on the UART
     char message[50];
@@ -126,11 +162,7 @@ int main(void)
     /*            I2C Reading                 */
     /******************************************/
     
-    /* Read WHO AM I REGISTER register */
-    uint8_t who_am_i_reg;
-    ErrorCode error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
-                                                  LIS3DH_WHO_AM_I_REG_ADDR, 
-                                                  &who_am_i_reg);
+    /* WHO AM I REGISTER register, as read at the end of the boot */
     if (error == NO_ERROR)
     {
         sprintf(message, "WHO AM I REG: 0x%02X [Expected: 0x33]\r\n", who_am_i_reg);
@@ -0,0 +1,986 @@
+/**
+*   \file AcquisitionConfig.h
+*   \brief Acquisition and link configuration.
+*
+*   This file collects the output data rate, frame format and bus speeds
+*   used by the firmware, and checks at compile time that the selected
+*   configuration fits in the UART and I2C bandwidth. A configuration that
+*   cannot keep up does not build.
+*
+*   Each setting can be overridden from the compiler command line, as in
+*   -DACQ_ODR_HZ=100, so that the configurations can be swept without
+*   editing this file; the frame sizes and the derived values cannot.
+*
+*   The I2C and UART speeds, as well as the timer clock, are set in the
+*   TopDesign for the 24 MHz bus clock of the balanced clock profile: they
+*   must be kept in sync with the values below.
+*/
+
+#ifndef __ACQUISITION_CONFIG_H
+    #define __ACQUISITION_CONFIG_H
+
+    /**
+    *   \brief Output data rate of the LIS3DH (1, 10, 25, 50, 100, 200 or 400 Hz).
+    */
+    #ifndef ACQ_ODR_HZ
+        #define ACQ_ODR_HZ 400
+    #endif
+
+    /**
+    *   \brief Decimation ratio between the LIS3DH and the stream (1, 2, 4 or 8).
+    *
+    *   Above 1, the samples are collected through the LIS3DH FIFO at each
+    *   Timer tick, low-pass filtered and decimated by the Decimator, and
+    *   the stream runs at ACQ_OUTPUT_HZ.
+    */
+    #ifndef ACQ_DECIMATION
+        #define ACQ_DECIMATION 4
+    #endif
+    #define ACQ_OUTPUT_HZ (ACQ_ODR_HZ / ACQ_DECIMATION)
+
+    /**
+    *   \brief Largest number of samples read from the FIFO in one burst.
+    */
+    #ifndef ACQ_FIFO_BURST
+        #define ACQ_FIFO_BURST 8
+    #endif
+
+    /**
+    *   \brief Length of the statistics windows (0 disables the summaries).
+    *
+    *   At the end of each window a summary frame is sent with the mean,
+    *   RMS, minimum, maximum and crest factor of each axis, in mg: header
+    *   0xA2, five int16/uint16 per axis, footer 0xC0. The frame goes out
+    *   in one blocking burst after a data frame, so the LIS3DH must hold
+    *   its samples meanwhile: this takes the FIFO of decimation or a
+    *   faster UART than the default (checked below).
+    */
+    #ifndef ACQ_STATS_WINDOW_MS
+        #define ACQ_STATS_WINDOW_MS 0
+    #endif
+    #define ACQ_STATS_FRAME_SIZE 32
+    #define ACQ_STATS_WINDOW_SAMPLES ((long)ACQ_OUTPUT_HZ * ACQ_STATS_WINDOW_MS / 1000)
+
+    /**
+    *   \brief Send a data frame for every sample (0 to send the summaries only).
+    */
+    #ifndef ACQ_RAW_FRAMES
+        #define ACQ_RAW_FRAMES 1
+    #endif
+
+    /**
+    *   \brief Points of the spectral analysis (128, 256 or 512; 0 disables it).
+    *
+    *   The stream is collected in blocks of ACQ_FFT_POINTS samples and the
+    *   Spectrum module transforms each axis. For every block a frame per
+    *   axis is sent: header 0xA3, axis (0 to 2), eight uint16, footer 0xC0.
+    *   The values are the RMS acceleration in eight bands of equal width
+    *   from 0 to ACQ_OUTPUT_HZ / 2, in mg; with ACQ_FFT_PEAKS set they are
+    *   frequency (0.01 Hz) and amplitude (mg) of the four strongest peaks.
+    */
+    #ifndef ACQ_FFT_POINTS
+        #define ACQ_FFT_POINTS 0
+    #endif
+    #ifndef ACQ_FFT_PEAKS
+        #define ACQ_FFT_PEAKS 0
+    #endif
+    #define ACQ_FFT_FRAME_SIZE 19
+
+    /**
+    *   \brief Threshold of the event-triggered capture, in mg (0 disables it).
+    *
+    *   The last ACQ_TRIGGER_PRE_SAMPLES samples of the stream are kept in
+    *   RAM; when the magnitude of the acceleration (ACQ_TRIGGER_MAGNITUDE
+    *   set) or any axis exceeds the threshold, ACQ_TRIGGER_POST_SAMPLES
+    *   more are collected and the whole capture is sent as a burst of
+    *   28-byte packets of four samples (see Trigger.h), one packet every
+    *   ACQ_TRIGGER_PACKET_TICKS Timer ticks so that the acquisition and the
+    *   other frames keep going. Without ACQ_HPF gravity is included, so
+    *   the threshold must be above 1 g. Clear ACQ_RAW_FRAMES to send the captures only.
+    */
+    #ifndef ACQ_TRIGGER_MG
+        #define ACQ_TRIGGER_MG 0
+    #endif
+    #ifndef ACQ_TRIGGER_MAGNITUDE
+        #define ACQ_TRIGGER_MAGNITUDE 1
+    #endif
+    #ifndef ACQ_TRIGGER_PRE_SAMPLES
+        #define ACQ_TRIGGER_PRE_SAMPLES 64
+    #endif
+    #ifndef ACQ_TRIGGER_POST_SAMPLES
+        #define ACQ_TRIGGER_POST_SAMPLES 192
+    #endif
+    #ifndef ACQ_TRIGGER_PACKET_TICKS
+        #define ACQ_TRIGGER_PACKET_TICKS 4
+    #endif
+    #define ACQ_TRIGGER_PACKET_SIZE 28
+
+    /**
+    *   \brief On-chip click and free-fall detection (0 mg disables each engine).
+    *
+    *   The click engine watches the high-pass filtered axes against
+    *   ACQ_CLICK_MG: a single click is a crossing shorter than
+    *   ACQ_CLICK_LIMIT_MS; with ACQ_CLICK_DOUBLE set, a second click after
+    *   ACQ_CLICK_LATENCY_MS and within ACQ_CLICK_WINDOW_MS is reported as
+    *   a double click. Free fall is reported when all the axes stay below
+    *   ACQ_FREEFALL_MG together for ACQ_FREEFALL_MS. The engines latch
+    *   their source registers, which are polled every ACQ_EVENT_POLL_TICKS
+    *   Timer ticks; each event is sent as a frame: header 0xA5, event (1
+    *   single click, 2 double click, 3 free fall), source register, Timer
+    *   tick of the poll (uint32), footer 0xC0. Clear ACQ_RAW_FRAMES and
+    *   ACQ_STATS_WINDOW_MS to run in event-only mode.
+    */
+    #ifndef ACQ_CLICK_MG
+        #define ACQ_CLICK_MG 0
+    #endif
+    #ifndef ACQ_CLICK_DOUBLE
+        #define ACQ_CLICK_DOUBLE 0
+    #endif
+    #ifndef ACQ_CLICK_LIMIT_MS
+        #define ACQ_CLICK_LIMIT_MS 20
+    #endif
+    #ifndef ACQ_CLICK_LATENCY_MS
+        #define ACQ_CLICK_LATENCY_MS 100
+    #endif
+    #ifndef ACQ_CLICK_WINDOW_MS
+        #define ACQ_CLICK_WINDOW_MS 300
+    #endif
+    #ifndef ACQ_FREEFALL_MG
+        #define ACQ_FREEFALL_MG 0
+    #endif
+    #ifndef ACQ_FREEFALL_MS
+        #define ACQ_FREEFALL_MS 30
+    #endif
+    #ifndef ACQ_EVENT_POLL_TICKS
+        #define ACQ_EVENT_POLL_TICKS 4
+    #endif
+    #define ACQ_EVENT_FRAME_SIZE 8
+
+    /**
+    *   \brief Axes acquired: bit 0 for X, 1 for Y, 2 for Z.
+    *
+    *   The other axes are disabled in Control Register 1, the enabled ones
+    *   are read in one burst and only they are sent. With all three axes
+    *   the data frames are the 14-byte ones plotted by the Bridge Control
+    *   Panel; otherwise a data frame is: header 0xA7, mode byte (the axis
+    *   mask), the enabled axes as int32 from X to Z, footer 0xC0. A single
+    *   axis takes 7 bytes per sample instead of 14, so the link carries it
+    *   at 200 Hz where it carried three at 100 Hz. Statistics and captures
+    *   see the disabled axes at zero, and no spectrum is sent for them.
+    */
+    #ifndef ACQ_AXIS_MASK
+        #define ACQ_AXIS_MASK 0x07
+    #endif
+
+    /**
+    *   \brief High-pass filter of the LIS3DH on the output data (0 disables it).
+    *
+    *   When set, the internal filter strips gravity and any slow offset
+    *   from the data registers and the FIFO, with a cut-off frequency of
+    *   ACQ_ODR_HZ / (50 << ACQ_HPF_CUTOFF): 8, 4, 2 or 1 Hz at 400 Hz. The
+    *   filter is reset by reading the REFERENCE register at start-up and
+    *   after each change of full scale. Free fall keeps the unfiltered
+    *   data. Statistics, spectrum and captures see the filtered samples.
+    *
+    *   With ACQ_NARROW_FRAMES set, the data frames carry the axes as int16
+    *   in mm/s^2, saturated at +/-32767 (3.3 g): header 0xA7, mode byte
+    *   (axis mask with bit 3 set), enabled axes, footer 0xC0. Three axes
+    *   take 9 bytes per sample instead of 14.
+    */
+    #ifndef ACQ_HPF
+        #define ACQ_HPF 0
+    #endif
+    #ifndef ACQ_HPF_CUTOFF
+        #define ACQ_HPF_CUTOFF 0
+    #endif
+    #ifndef ACQ_NARROW_FRAMES
+        #define ACQ_NARROW_FRAMES ACQ_HPF
+    #endif
+
+    /**
+    *   \brief Per-axis calibration (0 disables it).
+    *
+    *   Each value is corrected for the offset and the gain of its axis in
+    *   integer arithmetic as soon as it is converted to mg, so that all the
+    *   frames carry calibrated values. The coefficients are kept in the
+    *   emulated EEPROM (see Calibration.h) and measured on one-character
+    *   commands received by UART_Debug, each averaging
+    *   ACQ_CALIBRATION_SAMPLES samples of the LIS3DH:
+    *
+    *   'o' offsets with the board at rest, Z up;
+    *   '1' to '6' one of the six positions, +X, -X, +Y, -Y, +Z and -Z up:
+    *   offsets and gains are computed once all six have been measured;
+    *   'd' back to unit gains and no offsets.
+    *
+    *   New coefficients are stored at once. A frame reports them at
+    *   start-up and after each measure: header 0xA8, state (0 default,
+    *   1 loaded from the EEPROM, 2 position measured, 3 stored, 4 not
+    *   stored), mask of the positions measured, offsets as int16 in mg,
+    *   gains as uint16 with 14 fractional bits, footer 0xC0. The offsets
+    *   are static, so ACQ_HPF would remove them before the measures.
+    */
+    #ifndef ACQ_CALIBRATION
+        #define ACQ_CALIBRATION 0
+    #endif
+    #ifndef ACQ_CALIBRATION_SAMPLES
+        #define ACQ_CALIBRATION_SAMPLES 64
+    #endif
+    #define ACQ_CALIBRATION_FRAME_SIZE 16
+
+    /**
+    *   \brief Offline log in flash (0 disables it).
+    *
+    *   Every sample of the stream is also appended, compressed, to a ring
+    *   of ACQ_LOG_ROWS flash rows at the top of the 256 KB flash (see
+    *   FlashLog.h), so that a unit with no host attached keeps recording;
+    *   the oldest rows are overwritten once the ring is full, each row is
+    *   programmed once per turn. A row holds about 80 samples of three
+    *   axes at rest and takes 15-20 ms to program, which the LIS3DH FIFO
+    *   covers with ACQ_DECIMATION above 1. The row being filled is lost
+    *   on a reset.
+    *
+    *   The 'l' command received by UART_Debug dumps the log, oldest row
+    *   first: the UART switches to ACQ_LOG_DUMP_BAUD, waits
+    *   ACQ_LOG_DUMP_PAUSE_MS for the host to follow, sends one frame per
+    *   row and gets back to ACQ_UART_BAUD. A frame is: header 0xA9, rows
+    *   still to come (uint16), the 256 bytes of the row, footer 0xC0; an
+    *   empty log is sent as one blank row. No sample is read during the
+    *   dump. The program must stay below the rows of the log, which the
+    *   linker script does not reserve: the size_report target of HostSim
+    *   fails when the image of the map file reaches into them.
+    */
+    #ifndef ACQ_LOG
+        #define ACQ_LOG 0
+    #endif
+    #ifndef ACQ_LOG_ROWS
+        #define ACQ_LOG_ROWS 512
+    #endif
+    #ifndef ACQ_LOG_DUMP_BAUD
+        #define ACQ_LOG_DUMP_BAUD 115200
+    #endif
+    #ifndef ACQ_LOG_DUMP_PAUSE_MS
+        #define ACQ_LOG_DUMP_PAUSE_MS 50
+    #endif
+    #define ACQ_LOG_FRAME_SIZE 260
+
+    /**
+    *   \brief Full scale of the LIS3DH, in g (2, 4, 8 or 16), in High Resolution mode.
+    */
+    #ifndef ACQ_FULL_SCALE_G
+        #define ACQ_FULL_SCALE_G 4
+    #endif
+
+    /**
+    *   \brief Auto-ranging full scale.
+    *
+    *   When set, the acquisition starts at ACQ_FULL_SCALE_G and the
+    *   AutoRange module watches the samples of the LIS3DH: a sample of any
+    *   axis at ACQ_RANGE_UP_PERCENT of the full scale steps it up at once,
+    *   and the range steps back down once all the axes have stayed below
+    *   ACQ_RANGE_DOWN_PERCENT of the lower full scale for ACQ_RANGE_QUIET_MS.
+    *   Every switch is marked in the stream with a frame: header 0xA6, full
+    *   scale in g as int32 in place of the X axis, sensitivity in mg/digit
+    *   in place of Y, Z zero, footer 0xC0; one is also sent when the stream
+    *   starts. The data frames stay in mm/s^2 across a switch. The samples
+    *   taken while the range changes are replaced by the last one read.
+    */
+    #ifndef ACQ_AUTO_RANGE
+        #define ACQ_AUTO_RANGE 0
+    #endif
+    #ifndef ACQ_RANGE_UP_PERCENT
+        #define ACQ_RANGE_UP_PERCENT 90
+    #endif
+    #ifndef ACQ_RANGE_DOWN_PERCENT
+        #define ACQ_RANGE_DOWN_PERCENT 70
+    #endif
+    #ifndef ACQ_RANGE_QUIET_MS
+        #define ACQ_RANGE_QUIET_MS 2000
+    #endif
+
+    /**
+    *   \brief Measure the cycles taken by the Decimator, the Spectrum and the hot path at start-up.
+    */
+    #ifndef ACQ_BENCHMARK
+        #define ACQ_BENCHMARK 1
+    #endif
+
+    /**
+    *   \brief Run the hot path from SRAM (0 to keep it in flash).
+    *
+    *   When set, the I2C register transfers, the Timer ISR and the sample
+    *   encoder are placed in the .ram section of the linker script, which
+    *   the start-up code copies to SRAM with the initialized data: they run
+    *   without flash wait states and cache misses, and take their size in
+    *   both flash and SRAM. They are reached with long calls, and their own
+    *   calls to the component APIs, which stay in flash, through linker
+    *   veneers. With ACQ_BENCHMARK the boot reports the mean and the spread
+    *   of the cycles of the encoder and of a 6-byte register read, to be
+    *   compared between the two placements. The host build ignores it.
+    */
+    #ifndef ACQ_RAM_HOT_PATH
+        #define ACQ_RAM_HOT_PATH 0
+    #endif
+
+    /**
+    *   \brief Fast boot (0 for the register dump at start-up).
+    *
+    *   Without it the firmware scans the I2C bus and reads, writes and
+    *   prints the LIS3DH registers one at a time, which takes most of the
+    *   boot at ACQ_UART_BAUD. With it the firmware checks WHO_AM_I, writes
+    *   TEMP_CFG_REG to CTRL_REG6 in one burst and reads them back, then
+    *   sets the other registers of the enabled features without a word on
+    *   the UART; the benchmarks are skipped. In both modes a boot record
+    *   is sent just before the first data frame: header 0xAA, WHO_AM_I,
+    *   flags (bit 0 WHO_AM_I as expected, bit 1 registers read back as
+    *   written, bit 7 fast boot), time from the start of main() to the
+    *   first sample in us (uint32), footer 0xC0. A wrong WHO_AM_I in fast
+    *   boot leaves the LIS3DH alone and sends the record at once, with
+    *   the time set to 0xFFFFFFFF.
+    */
+    #ifndef ACQ_FAST_BOOT
+        #define ACQ_FAST_BOOT 0
+    #endif
+    #define ACQ_BOOT_FRAME_SIZE 8
+
+    /**
+    *   \brief Register dump as text (0 for binary status records).
+    *
+    *   The lines of text are formatted by DebugText, without sprintf. The
+    *   binary records replace each line with: header 0xAB, register
+    *   address (0x80 for a device found on the I2C bus), value read or
+    *   written (the device address for 0x80), status (0 for done, 1 for
+    *   an I2C error), footer 0xC0. The benchmarks are only sent as text.
+    */
+    #ifndef ACQ_TEXT_DIAGNOSTICS
+        #define ACQ_TEXT_DIAGNOSTICS 1
+    #endif
+    #define ACQ_STATUS_FRAME_SIZE 5
+
+    /**
+    *   \brief Profile of the acquisition loop (0 to disable it).
+    *
+    *   When set, the cycles the main loop takes to serve each Timer tick
+    *   are counted with the cycle counter, from the wake-up to the end of
+    *   the tick, and a frame is sent every ACQ_PROFILE_TICKS ticks: header
+    *   0xAC, ticks served (uint16), mean and worst cycles per tick (uint32
+    *   each), samples read (uint16) and cycles elapsed (uint32) since the
+    *   previous frame, bus clock in MHz (uint8), footer 0xC0. The waits on
+    *   the I2C bus and on the UART are included, the halt between two ticks
+    *   is not. Ticks that arrive while the loop is still busy are merged, so
+    *   that the frames grow apart when the loop falls behind. The cycles
+    *   elapsed are the Timer ticks elapsed times the bus cycles per tick,
+    *   as the cycle counter stops while the CPU is halted. The samples per
+    *   second are samples * MHz * 10^6 / cycles elapsed, the idle time the
+    *   share of the cycles elapsed left by ticks * mean. Build the
+    *   Release configuration to profile the production code.
+    */
+    #ifndef ACQ_PROFILE
+        #define ACQ_PROFILE 0
+    #endif
+    #ifndef ACQ_PROFILE_TICKS
+        #define ACQ_PROFILE_TICKS 200
+    #endif
+    #define ACQ_PROFILE_FRAME_SIZE 19
+
+    /**
+    *   \brief Timer ticks between two stack reports (0 to disable them).
+    *
+    *   When set, the free stack is painted at boot and its high-water mark
+    *   is sent once before the acquisition loop and then every
+    *   ACQ_STACK_REPORT_TICKS ticks: header 0xAD, stack size and bytes used
+    *   (uint16 each), footer 0xC0. Run the worst-case scenarios and compare
+    *   the mark with the static worst case of stack_report before shrinking
+    *   the stack in the System settings of the design.
+    */
+    #ifndef ACQ_STACK_REPORT_TICKS
+        #define ACQ_STACK_REPORT_TICKS 0
+    #endif
+    #define ACQ_STACK_FRAME_SIZE 6
+
+    /**
+    *   \brief Length of a data frame: header, 3 axes as int32, footer.
+    *   The rate and range markers always take this length.
+    */
+    #define ACQ_FRAME_SIZE 14
+
+    /**
+    *   \brief Baud rate of UART_Debug and bits on the line per byte (8N1).
+    */
+    #ifndef ACQ_UART_BAUD
+        #define ACQ_UART_BAUD 19200
+    #endif
+    #define ACQ_UART_BITS_PER_BYTE 10
+
+    /**
+    *   \brief Bytes of the UART_Debug buffer, its hardware FIFO: longer
+    *   frames block UART_Debug_PutArray() until the rest is on the line.
+    */
+    #ifndef ACQ_UART_FIFO_BYTES
+        #define ACQ_UART_FIFO_BYTES 4
+    #endif
+
+    /**
+    *   \brief Largest share of the UART bandwidth the data frames may use (%).
+    */
+    #ifndef ACQ_UART_MAX_LOAD
+        #define ACQ_UART_MAX_LOAD 90
+    #endif
+
+    /**
+    *   \brief Data rate of I2C_Master.
+    */
+    #ifndef ACQ_I2C_HZ
+        #define ACQ_I2C_HZ 100000
+    #endif
+
+    /**
+    *   \brief Largest share of the I2C bandwidth the acquisition may use (%).
+    */
+    #ifndef ACQ_I2C_MAX_LOAD
+        #define ACQ_I2C_MAX_LOAD 50
+    #endif
+
+    /**
+    *   \brief SRAM of the CY8C5888 and SRAM used by the firmware without
+    *   the acquisition buffers, 2048-byte stack included and no heap (from
+    *   the build report, 2561 bytes less the 128-byte heap now removed).
+    */
+    #define ACQ_SRAM_BYTES 65536
+    #ifndef ACQ_RAM_BASE_BYTES
+        #define ACQ_RAM_BASE_BYTES 2433
+    #endif
+
+    /**
+    *   \brief Low-power acquisition.
+    *
+    *   When set, the CPU is halted with WFI between Timer ticks.
+    *   When cleared, the CPU stays awake: with decimation it spins until
+    *   each tick, and the FIFO source register is still read once per
+    *   tick; without, the Status Register is polled back to back and each
+    *   sample is read as soon as it is there, instead of once per tick.
+    */
+    #ifndef ACQ_LOW_POWER
+        #define ACQ_LOW_POWER 1
+    #endif
+
+    /**
+    *   \brief Activity-adaptive ODR.
+    *
+    *   When set, the sleep-to-wake engine of the LIS3DH drops the rate to
+    *   10 Hz low-power mode once all the axes stay within ACQ_ACT_THS_MG
+    *   for ACQ_ACT_DUR_S, and goes back to ACQ_ODR_HZ when one of them
+    *   exceeds it. The threshold is compared with the acceleration of each
+    *   axis, gravity included, so it must be above 1 g. The rate is told
+    *   from the gap between data-ready samples, so it cannot be used
+    *   together with decimation.
+    */
+    #ifndef ACQ_ADAPTIVE_ODR
+        #define ACQ_ADAPTIVE_ODR 0
+    #endif
+    #ifndef ACQ_ACT_THS_MG
+        #define ACQ_ACT_THS_MG 1200
+    #endif
+    #ifndef ACQ_ACT_DUR_S
+        #define ACQ_ACT_DUR_S 5
+    #endif
+
+    /**
+    *   \brief Output data rate of the LIS3DH while asleep for inactivity.
+    */
+    #ifndef ACQ_SLEEP_ODR_HZ
+        #define ACQ_SLEEP_ODR_HZ 10
+    #endif
+
+    /**
+    *   \brief Clock and period of the Timer setting the reading rate.
+    *
+    *   With ACQ_PHASE_LOCK the period set in the TopDesign is only used
+    *   until the first tick: the Timer then ticks once per sample.
+    */
+    #ifndef ACQ_TIMER_CLOCK_HZ
+        #define ACQ_TIMER_CLOCK_HZ 20000
+    #endif
+    #ifndef ACQ_TIMER_PERIOD
+        #define ACQ_TIMER_PERIOD 99
+    #endif
+    #define ACQ_TICK_HZ (ACQ_PHASE_LOCK ? ACQ_ODR_HZ : ACQ_TIMER_CLOCK_HZ / (ACQ_TIMER_PERIOD + 1))
+
+    /**
+    *   \brief Phase-locked sampling (0 to poll at the Timer rate).
+    *
+    *   Without decimation the Status Register is polled at every tick, so
+    *   that the Timer has to run faster than the ODR and a sample waits up
+    *   to a tick before being read. When set, the Timer period is adjusted
+    *   at each tick by the PhaseLock module so that the ticks follow the
+    *   data-ready instants of the LIS3DH, one per sample and a fraction of
+    *   a Timer count after them. Now and then a tick comes just before the
+    *   sample by design: the Status Register is then polled again at once.
+    *   The correction of the period gives the drift of the LIS3DH clock.
+    */
+    #ifndef ACQ_PHASE_LOCK
+        #define ACQ_PHASE_LOCK 0
+    #endif
+
+    /**
+    *   \brief Timer ticks between two phase reports (0 to disable them).
+    *
+    *   When set, the jitter of the Timer interrupt and the phase between
+    *   the ticks and the samples are measured, and a frame is sent every
+    *   ACQ_PHASE_REPORT_TICKS ticks: header 0xAE, ticks served, ticks
+    *   merged while the loop was busy, ticks that found no new sample,
+    *   samples overwritten before being read (uint16 each), drift of the
+    *   LIS3DH clock in ppm (int16, 0 without ACQ_PHASE_LOCK), smallest and
+    *   largest deviation of a tick interval from the Timer period and
+    *   longest delay from the interrupt to the service of the tick (int32,
+    *   int32 and uint32 cycles), footer 0xC0. The intervals are read from
+    *   the Timer counter, which keeps running in the halts of
+    *   ACQ_LOW_POWER, so they come in whole Timer counts. With decimation
+    *   only the tick timing is measured.
+    */
+    #ifndef ACQ_PHASE_REPORT_TICKS
+        #define ACQ_PHASE_REPORT_TICKS 0
+    #endif
+    #define ACQ_PHASE_FRAME_SIZE 24
+
+    /**
+    *   \brief Interrupt priorities (0 highest to 7 lowest).
+    *
+    *   Set at boot by IsrBudget_SetPriorities() in place of the defaults of
+    *   the components. The Timer tick preempts the byte handling of
+    *   I2C_Master, which only stretches the bus meanwhile. UART_Debug has no
+    *   interrupt with buffers of 4 bytes, its hardware FIFO: its priority
+    *   applies once a larger buffer is set in the TopDesign.
+    */
+    #ifndef ACQ_TIMER_ISR_PRIORITY
+        #define ACQ_TIMER_ISR_PRIORITY 0
+    #endif
+    #ifndef ACQ_I2C_ISR_PRIORITY
+        #define ACQ_I2C_ISR_PRIORITY 2
+    #endif
+    #ifndef ACQ_UART_ISR_PRIORITY
+        #define ACQ_UART_ISR_PRIORITY 4
+    #endif
+
+    /**
+    *   \brief Timer ticks between two interrupt reports (0 to disable them).
+    *
+    *   When set, the interrupts are timed with the cycle counter and a
+    *   frame is sent every ACQ_ISR_REPORT_TICKS ticks: header 0xAF, longest
+    *   run of the Timer, I2C_Master and UART_Debug interrupts in cycles,
+    *   without the time spent in the interrupts preempting them, and
+    *   longest delay from a Timer terminal count to its interrupt in us
+    *   (uint16 each), priorities of the three interrupts as set in the
+    *   controller (0xFF for none), footer 0xC0. The delay is read from the
+    *   Timer counter, to 1 / ACQ_TIMER_CLOCK_HZ, so that it holds across
+    *   the halts of ACQ_LOW_POWER.
+    */
+    #ifndef ACQ_ISR_REPORT_TICKS
+        #define ACQ_ISR_REPORT_TICKS 0
+    #endif
+    #define ACQ_ISR_FRAME_SIZE 13
+
+    /**
+    *   \brief Clock profile of the CPU (0 low-power, 1 balanced, 2 max-throughput).
+    *
+    *   The design starts at 24 MHz from the PLL, which is the balanced
+    *   profile. At boot ClockProfile_Apply() moves the master clock to the
+    *   selected one, 12 MHz from the IMO with the PLL off or 80 MHz from
+    *   the PLL, and sets again the dividers of timer_clock,
+    *   UART_Debug_IntClock and I2C_Master so that the tick rate, baud rate
+    *   and I2C speed stay the ones above. Enable ACQ_PROFILE to compare
+    *   the samples per second and the idle time of the loop between them.
+    */
+    #ifndef ACQ_CLOCK_PROFILE
+        #define ACQ_CLOCK_PROFILE 1
+    #endif
+
+    /*
+    *  ODR bits of Control Register 1 for the selected rate
+    */
+    #if ACQ_ODR_HZ == 1
+        #define ACQ_CTRL_REG1_ODR 0x1
+    #elif ACQ_ODR_HZ == 10
+        #define ACQ_CTRL_REG1_ODR 0x2
+    #elif ACQ_ODR_HZ == 25
+        #define ACQ_CTRL_REG1_ODR 0x3
+    #elif ACQ_ODR_HZ == 50
+        #define ACQ_CTRL_REG1_ODR 0x4
+    #elif ACQ_ODR_HZ == 100
+        #define ACQ_CTRL_REG1_ODR 0x5
+    #elif ACQ_ODR_HZ == 200
+        #define ACQ_CTRL_REG1_ODR 0x6
+    #elif ACQ_ODR_HZ == 400
+        #define ACQ_CTRL_REG1_ODR 0x7
+    #else
+        #error "ACQ_ODR_HZ is not an output data rate of the LIS3DH"
+    #endif
+
+    /*
+    *  Bus clock of the selected profile and PLL dividers (3 MHz IMO * P / Q)
+    */
+    #define ACQ_CLOCK_LOW_POWER 0
+    #define ACQ_CLOCK_BALANCED 1
+    #define ACQ_CLOCK_MAX_THROUGHPUT 2
+    #if ACQ_CLOCK_PROFILE == ACQ_CLOCK_LOW_POWER
+        #define ACQ_BUS_CLK_HZ 12000000L
+    #elif ACQ_CLOCK_PROFILE == ACQ_CLOCK_BALANCED
+        #define ACQ_BUS_CLK_HZ 24000000L
+        #define ACQ_PLL_P 8
+        #define ACQ_PLL_Q 1
+    #elif ACQ_CLOCK_PROFILE == ACQ_CLOCK_MAX_THROUGHPUT
+        #define ACQ_BUS_CLK_HZ 80000000L
+        #define ACQ_PLL_P 80
+        #define ACQ_PLL_Q 3
+    #else
+        #error "ACQ_CLOCK_PROFILE must be 0, 1 or 2"
+    #endif
+    #define ACQ_BUS_CLK_MHZ (ACQ_BUS_CLK_HZ / 1000000L)
+
+    /*
+    *  Dividers of the bus clock for the timer clock, the UART clock (8
+    *  clocks per bit, closest divider) and the fixed-function I2C block
+    *  (16 clocks per bit, rounded up so that the bus is never faster than
+    *  ACQ_I2C_HZ)
+    */
+    #define ACQ_TIMER_CLOCK_DIVIDER (ACQ_BUS_CLK_HZ / ACQ_TIMER_CLOCK_HZ)
+    #define ACQ_UART_CLOCK_DIVIDER ((ACQ_BUS_CLK_HZ + 4L * ACQ_UART_BAUD) / (8L * ACQ_UART_BAUD))
+    #define ACQ_I2C_CLOCK_DIVIDER ((ACQ_BUS_CLK_HZ + 16L * ACQ_I2C_HZ - 1) / (16L * ACQ_I2C_HZ))
+
+    _Static_assert(ACQ_BUS_CLK_HZ % ACQ_TIMER_CLOCK_HZ == 0 && ACQ_TIMER_CLOCK_DIVIDER <= 65536,
+                   "The bus clock cannot be divided down to ACQ_TIMER_CLOCK_HZ");
+    _Static_assert(50L * (ACQ_BUS_CLK_HZ / (8L * ACQ_UART_CLOCK_DIVIDER) - ACQ_UART_BAUD) <= ACQ_UART_BAUD &&
+                   50L * (ACQ_UART_BAUD - ACQ_BUS_CLK_HZ / (8L * ACQ_UART_CLOCK_DIVIDER)) <= ACQ_UART_BAUD,
+                   "The baud rate is more than 2% off with this bus clock");
+    _Static_assert(ACQ_I2C_CLOCK_DIVIDER <= 0xFFFF,
+                   "The bus clock cannot be divided down to ACQ_I2C_HZ");
+
+    _Static_assert(ACQ_TIMER_ISR_PRIORITY < ACQ_I2C_ISR_PRIORITY && ACQ_TIMER_ISR_PRIORITY < ACQ_UART_ISR_PRIORITY &&
+                   ACQ_I2C_ISR_PRIORITY <= 7 && ACQ_UART_ISR_PRIORITY <= 7,
+                   "The Timer interrupt must have the highest of the priorities 0 to 7");
+
+    /**
+    *   \brief Control Register 1 value: selected ODR and axes.
+    */
+    #define ACQ_CTRL_REG1 ((ACQ_CTRL_REG1_ODR << 4) | ACQ_AXIS_MASK)
+
+    /*
+    *  Number of enabled axes, first one and span of output registers from
+    *  the first to the last (disabled axes in between included), length
+    *  of the data frames and mode byte of the 0xA7 ones
+    */
+    #define ACQ_AXES ((ACQ_AXIS_MASK & 1) + ((ACQ_AXIS_MASK >> 1) & 1) + ((ACQ_AXIS_MASK >> 2) & 1))
+    #define ACQ_AXIS_FIRST ((ACQ_AXIS_MASK & 1) ? 0 : (ACQ_AXIS_MASK & 2) ? 1 : 2)
+    #define ACQ_AXIS_LAST ((ACQ_AXIS_MASK & 4) ? 2 : (ACQ_AXIS_MASK & 2) ? 1 : 0)
+    #define ACQ_AXIS_SPAN (ACQ_AXIS_LAST - ACQ_AXIS_FIRST + 1)
+    #define ACQ_FRAME_MODE (ACQ_AXIS_MASK | (ACQ_NARROW_FRAMES ? 0x08 : 0))
+    #define ACQ_DATA_FRAME_SIZE (ACQ_FRAME_MODE == 0x07 ? ACQ_FRAME_SIZE : \
+                                 3 + (ACQ_NARROW_FRAMES ? 2 : 4) * ACQ_AXES)
+
+    #if ACQ_AXIS_MASK < 0x01 || ACQ_AXIS_MASK > 0x07
+        #error "ACQ_AXIS_MASK must enable from one to three axes"
+    #endif
+
+    /*
+    *  FS bits of Control Register 4 for the selected full scale
+    */
+    #if ACQ_FULL_SCALE_G == 2
+        #define ACQ_CTRL_REG4_FS 0x0
+    #elif ACQ_FULL_SCALE_G == 4
+        #define ACQ_CTRL_REG4_FS 0x1
+    #elif ACQ_FULL_SCALE_G == 8
+        #define ACQ_CTRL_REG4_FS 0x2
+    #elif ACQ_FULL_SCALE_G == 16
+        #define ACQ_CTRL_REG4_FS 0x3
+    #else
+        #error "ACQ_FULL_SCALE_G is not a full scale of the LIS3DH"
+    #endif
+
+    /**
+    *   \brief Control Register 4 value: selected full scale, High Resolution mode.
+    */
+    #define ACQ_CTRL_REG4 ((ACQ_CTRL_REG4_FS << 4) | 0x08)
+
+    #if ACQ_HPF_CUTOFF < 0 || ACQ_HPF_CUTOFF > 3
+        #error "ACQ_HPF_CUTOFF must be 0 to 3"
+    #endif
+
+    /**
+    *   \brief Control Register 2 value: normal filter mode (reset by reading
+    *   REFERENCE), selected cut-off and filtered output data with ACQ_HPF;
+    *   filter on the click engine with ACQ_CLICK_MG.
+    */
+    #define ACQ_CTRL_REG2 ((ACQ_HPF ? (ACQ_HPF_CUTOFF << 4) | 0x08 : 0) | (ACQ_CLICK_MG > 0 ? 0x04 : 0))
+
+    /*
+    *  Step of the ACT_THS and INT1_THS registers at a full scale, in mg
+    */
+    #define ACQ_THS_LSB_MG(g) ((g) == 2 ? 16 : (g) == 4 ? 32 : (g) == 8 ? 62 : 186)
+
+    /*
+    *  Activity threshold (ACQ_THS_LSB_MG per LSB) and duration ((8 ACT_DUR + 1) / ODR)
+    */
+    #define ACQ_ACT_THS_AT(g) (ACQ_ACT_THS_MG / ACQ_THS_LSB_MG(g))
+    #define ACQ_ACT_THS ACQ_ACT_THS_AT(ACQ_FULL_SCALE_G)
+    #define ACQ_ACT_DUR ((ACQ_ACT_DUR_S * ACQ_ODR_HZ - 1) / 8)
+
+    /*
+    *  Click threshold (FS / 128 per LSB) and time limit, latency and window
+    *  (1 / ODR per LSB); free-fall threshold (ACQ_THS_LSB_MG per LSB) and
+    *  duration (1 / ODR per LSB)
+    */
+    #define ACQ_CLICK_THS_AT(g) ((ACQ_CLICK_MG * 128L + 500L * (g)) / (1000L * (g)))
+    #define ACQ_CLICK_THS ACQ_CLICK_THS_AT(ACQ_FULL_SCALE_G)
+    #define ACQ_CLICK_TIME_LIMIT ((long)ACQ_CLICK_LIMIT_MS * ACQ_ODR_HZ / 1000)
+    #define ACQ_CLICK_TIME_LATENCY ((long)ACQ_CLICK_LATENCY_MS * ACQ_ODR_HZ / 1000)
+    #define ACQ_CLICK_TIME_WINDOW ((long)ACQ_CLICK_WINDOW_MS * ACQ_ODR_HZ / 1000)
+    #define ACQ_FREEFALL_THS_AT(g) (ACQ_FREEFALL_MG / ACQ_THS_LSB_MG(g))
+    #define ACQ_FREEFALL_THS ACQ_FREEFALL_THS_AT(ACQ_FULL_SCALE_G)
+    #define ACQ_FREEFALL_DURATION ((long)ACQ_FREEFALL_MS * ACQ_ODR_HZ / 1000)
+    #define ACQ_EVENTS (ACQ_CLICK_MG > 0 || ACQ_FREEFALL_MG > 0)
+
+    /*
+    *  One-character commands received by UART_Debug
+    */
+    #define ACQ_COMMANDS (ACQ_CALIBRATION || ACQ_LOG)
+
+    /*
+    *  Samples of the LIS3DH in the quiet period before stepping the range down
+    */
+    #define ACQ_RANGE_QUIET_SAMPLES ((long)ACQ_RANGE_QUIET_MS * ACQ_ODR_HZ / 1000)
+
+    /*
+    *  Gap between data-ready samples, in Timer ticks, above which the
+    *  device is taken to be asleep: halfway between the two rates.
+    */
+    #define ACQ_SLEEP_GAP_TICKS ((ACQ_TICK_HZ / ACQ_ODR_HZ + ACQ_TICK_HZ / ACQ_SLEEP_ODR_HZ) / 2)
+
+    /*
+    *  I2C bits of a register read (start, address, sub-address, restart,
+    *  address, data, stop): each byte takes 9 bits with the ACK,
+    *  start/restart/stop one bit each. A sample is read in one burst from
+    *  the first to the last enabled axis.
+    */
+    #define ACQ_I2C_BITS_READ(bytes) (3 + 9 * (3 + (bytes)))
+    #define ACQ_I2C_BITS_PER_SAMPLE ACQ_I2C_BITS_READ(2 * ACQ_AXIS_SPAN)
+
+    /*
+    *  I2C bits per second: with decimation the FIFO source register and
+    *  one burst of 6 bytes per sample are read at each tick; otherwise,
+    *  in low-power mode the Status Register is polled once per tick, or
+    *  it is polled back to back and only half of the budget is left to the
+    *  samples.
+    */
+    #if ACQ_DECIMATION > 1
+        #define ACQ_I2C_BITS_PER_S ((long)ACQ_TICK_HZ * (ACQ_I2C_BITS_READ(1) + ACQ_I2C_BITS_READ(0)) + \
+                                    (long)ACQ_ODR_HZ * 9 * 6)
+    #elif ACQ_LOW_POWER
+        #define ACQ_I2C_BITS_PER_S ((long)ACQ_TICK_HZ * ACQ_I2C_BITS_READ(1) + \
+                                    (long)ACQ_ODR_HZ * ACQ_I2C_BITS_PER_SAMPLE)
+    #else
+        #define ACQ_I2C_BITS_PER_S (2L * ACQ_ODR_HZ * (ACQ_I2C_BITS_READ(1) + ACQ_I2C_BITS_PER_SAMPLE))
+    #endif
+
+    /*
+    *  I2C bits per second spent polling the event sources
+    */
+    #define ACQ_I2C_EVENT_BITS_PER_S ((long)ACQ_TICK_HZ * ACQ_I2C_BITS_READ(1) / ACQ_EVENT_POLL_TICKS * \
+                                      ((ACQ_CLICK_MG > 0) + (ACQ_FREEFALL_MG > 0)))
+
+    #if ACQ_DECIMATION > 1
+        #if ACQ_ADAPTIVE_ODR
+            #error "ACQ_ADAPTIVE_ODR cannot be used together with ACQ_DECIMATION"
+        #endif
+        _Static_assert(ACQ_ODR_HZ % ACQ_DECIMATION == 0,
+                       "ACQ_ODR_HZ is not a multiple of ACQ_DECIMATION");
+        /* Leave room for a tick delayed by a few frames blocking on the UART */
+        _Static_assert(4 * ACQ_ODR_HZ / ACQ_TICK_HZ <= 32,
+                       "Timer ticks too slow: the LIS3DH FIFO would fill up between two ticks");
+        #if ACQ_PHASE_LOCK
+            #error "ACQ_PHASE_LOCK cannot be used together with ACQ_DECIMATION"
+        #endif
+    #else
+        _Static_assert(ACQ_TICK_HZ >= ACQ_ODR_HZ,
+                       "Timer ticks slower than the ODR: samples would be skipped");
+    #endif
+    #if ACQ_PHASE_LOCK
+        #if !ACQ_LOW_POWER || ACQ_ADAPTIVE_ODR
+            #error "ACQ_PHASE_LOCK needs ACQ_LOW_POWER and a fixed ODR"
+        #endif
+        /*
+        *  Timer counts per sample, which must leave room for the
+        *  corrections of the period
+        */
+        #define ACQ_PHASE_LOCK_COUNTS (ACQ_TIMER_CLOCK_HZ / ACQ_ODR_HZ)
+        _Static_assert(ACQ_TIMER_CLOCK_HZ % ACQ_ODR_HZ == 0 && ACQ_PHASE_LOCK_COUNTS >= 20,
+                       "The Timer clock is too slow to lock on ACQ_ODR_HZ");
+    #endif
+
+    /*
+    *  Statically allocated acquisition buffers: one block per axis and the
+    *  complex transform
+    */
+    #if ACQ_FFT_POINTS > 0
+        #if ACQ_FFT_POINTS != 128 && ACQ_FFT_POINTS != 256 && ACQ_FFT_POINTS != 512
+            #error "ACQ_FFT_POINTS must be 128, 256 or 512"
+        #endif
+        #define ACQ_FFT_RAM_BYTES (3 * 2 * ACQ_FFT_POINTS + 4 * ACQ_FFT_POINTS)
+        #define ACQ_FFT_BYTES_PER_S (((long)ACQ_AXES * ACQ_FFT_FRAME_SIZE * ACQ_OUTPUT_HZ + ACQ_FFT_POINTS - 1) / ACQ_FFT_POINTS)
+
+        _Static_assert(ACQ_OUTPUT_HZ * 50L <= 0xFFFF,
+                       "ACQ_OUTPUT_HZ too high for peak frequencies in hundredths of Hz");
+    #else
+        #define ACQ_FFT_RAM_BYTES 0
+        #define ACQ_FFT_BYTES_PER_S 0L
+    #endif
+
+    /*
+    *  Ring of the captured samples
+    */
+    #if ACQ_TRIGGER_MG > 0
+        #define ACQ_TRIGGER_RAM_BYTES (6L * (ACQ_TRIGGER_PRE_SAMPLES + ACQ_TRIGGER_POST_SAMPLES))
+        #define ACQ_TRIGGER_BYTES_PER_S ((long)ACQ_TRIGGER_PACKET_SIZE * ACQ_TICK_HZ / ACQ_TRIGGER_PACKET_TICKS)
+
+        _Static_assert(ACQ_TRIGGER_PRE_SAMPLES % 4 == 0 && ACQ_TRIGGER_POST_SAMPLES % 4 == 0 &&
+                       ACQ_TRIGGER_PRE_SAMPLES > 0 && ACQ_TRIGGER_POST_SAMPLES > 0,
+                       "The trigger samples must be a positive multiple of the 4 samples of a packet");
+        _Static_assert(ACQ_TRIGGER_PRE_SAMPLES + ACQ_TRIGGER_POST_SAMPLES <= 0x7FFF,
+                       "Too many trigger samples for the int16 index of the packets");
+    #else
+        #define ACQ_TRIGGER_RAM_BYTES 0
+        #define ACQ_TRIGGER_BYTES_PER_S 0L
+    #endif
+
+    /*
+    *  Row being filled by the flash log and state of the ring
+    */
+    #define ACQ_LOG_RAM_BYTES (ACQ_LOG ? 256 + 20 : 0)
+    #define ACQ_RAM_BYTES (ACQ_RAM_BASE_BYTES + ACQ_FFT_RAM_BYTES + ACQ_TRIGGER_RAM_BYTES + ACQ_LOG_RAM_BYTES)
+
+    _Static_assert(ACQ_RAM_BYTES <= ACQ_SRAM_BYTES,
+                   "Acquisition buffers do not fit in the SRAM: lower ACQ_FFT_POINTS or the trigger samples");
+
+    /*
+    *  Bytes per second sent over the UART: data frames, summaries, spectra
+    *  and captures while a burst is being sent
+    */
+    #if ACQ_STATS_WINDOW_MS > 0
+        #define ACQ_STATS_BYTES_PER_S (ACQ_STATS_FRAME_SIZE * 1000L / ACQ_STATS_WINDOW_MS)
+
+        _Static_assert(ACQ_STATS_WINDOW_SAMPLES >= 1 && ACQ_STATS_WINDOW_SAMPLES <= 0xFFFF,
+                       "ACQ_STATS_WINDOW_MS must span 1 to 65535 samples");
+        /* The summary follows a data frame in one burst, which must end
+        before the LIS3DH overwrites a sample: one sample period in the
+        output registers, the 32 samples of the FIFO with decimation, less
+        the tick a sample may wait for its read */
+        _Static_assert((long)(ACQ_DATA_FRAME_SIZE + ACQ_STATS_FRAME_SIZE - ACQ_UART_FIFO_BYTES) *
+                       ACQ_UART_BITS_PER_BYTE * ACQ_ODR_HZ * ACQ_TICK_HZ
+                       <= (long)ACQ_UART_BAUD * ((ACQ_DECIMATION > 1 ? 32 : 1) * ACQ_TICK_HZ - ACQ_ODR_HZ),
+                       "The summary burst outlasts the samples the LIS3DH holds: raise ACQ_UART_BAUD or use decimation");
+    #else
+        #define ACQ_STATS_BYTES_PER_S 0L
+    #endif
+    #if ACQ_RAM_HOT_PATH && defined(__arm__)
+        #define ACQ_RAMFUNC __attribute__((section(".ram"), long_call, noinline))
+    #else
+        #define ACQ_RAMFUNC
+    #endif
+    #if ACQ_PROFILE
+        #define ACQ_PROFILE_BYTES_PER_S ((long)ACQ_PROFILE_FRAME_SIZE * ACQ_TICK_HZ / ACQ_PROFILE_TICKS)
+
+        _Static_assert(ACQ_PROFILE_TICKS >= 1 && ACQ_PROFILE_TICKS <= 0xFFFF,
+                       "ACQ_PROFILE_TICKS must be 1 to 65535");
+    #else
+        #define ACQ_PROFILE_BYTES_PER_S 0L
+    #endif
+    #if ACQ_PHASE_REPORT_TICKS > 0
+        #define ACQ_PHASE_BYTES_PER_S ((long)ACQ_PHASE_FRAME_SIZE * ACQ_TICK_HZ / ACQ_PHASE_REPORT_TICKS)
+
+        _Static_assert(ACQ_PHASE_REPORT_TICKS <= 0xFFFF,
+                       "ACQ_PHASE_REPORT_TICKS must be 1 to 65535");
+    #else
+        #define ACQ_PHASE_BYTES_PER_S 0L
+    #endif
+    #if ACQ_ISR_REPORT_TICKS > 0
+        #define ACQ_ISR_BYTES_PER_S ((long)ACQ_ISR_FRAME_SIZE * ACQ_TICK_HZ / ACQ_ISR_REPORT_TICKS)
+
+        _Static_assert(ACQ_ISR_REPORT_TICKS <= 0xFFFF,
+                       "ACQ_ISR_REPORT_TICKS must be 1 to 65535");
+    #else
+        #define ACQ_ISR_BYTES_PER_S 0L
+    #endif
+    #if ACQ_STACK_REPORT_TICKS > 0
+        #define ACQ_STACK_BYTES_PER_S ((long)ACQ_STACK_FRAME_SIZE * ACQ_TICK_HZ / ACQ_STACK_REPORT_TICKS)
+
+        _Static_assert(ACQ_STACK_REPORT_TICKS <= 0xFFFF,
+                       "ACQ_STACK_REPORT_TICKS must be 0 to 65535");
+    #else
+        #define ACQ_STACK_BYTES_PER_S 0L
+    #endif
+    #define ACQ_UART_BYTES_PER_S ((long)ACQ_OUTPUT_HZ * ACQ_DATA_FRAME_SIZE * ACQ_RAW_FRAMES + \
+                                  ACQ_STATS_BYTES_PER_S + ACQ_FFT_BYTES_PER_S + ACQ_TRIGGER_BYTES_PER_S + \
+                                  ACQ_PROFILE_BYTES_PER_S + ACQ_STACK_BYTES_PER_S + ACQ_PHASE_BYTES_PER_S + \
+                                  ACQ_ISR_BYTES_PER_S)
+
+    _Static_assert(ACQ_UART_BYTES_PER_S * ACQ_UART_BITS_PER_BYTE * 100
+                   <= (long)ACQ_UART_BAUD * ACQ_UART_MAX_LOAD,
+                   "Frames do not fit in the UART bandwidth: lower ACQ_OUTPUT_HZ, clear ACQ_RAW_FRAMES or raise ACQ_UART_BAUD");
+
+    /*
+    *  With auto-ranging the thresholds of the engines are written again at
+    *  each switch: they must fit the registers from ± 2g to ± 16g
+    */
+    #if ACQ_AUTO_RANGE
+        #define ACQ_RANGE_LOW_G 2
+        #define ACQ_RANGE_HIGH_G 16
+
+        _Static_assert(ACQ_RANGE_DOWN_PERCENT < ACQ_RANGE_UP_PERCENT && ACQ_RANGE_UP_PERCENT <= 100,
+                       "ACQ_RANGE_DOWN_PERCENT must be below ACQ_RANGE_UP_PERCENT, up to 100");
+        _Static_assert(ACQ_RANGE_QUIET_SAMPLES >= 1 && ACQ_RANGE_QUIET_SAMPLES <= 0xFFFF,
+                       "ACQ_RANGE_QUIET_MS must span 1 to 65535 samples");
+    #else
+        #define ACQ_RANGE_LOW_G ACQ_FULL_SCALE_G
+        #define ACQ_RANGE_HIGH_G ACQ_FULL_SCALE_G
+    #endif
+
+    #if ACQ_ADAPTIVE_ODR
+        _Static_assert(ACQ_ACT_THS_AT(ACQ_RANGE_HIGH_G) >= 1 && ACQ_ACT_THS_AT(ACQ_RANGE_LOW_G) <= 0x7F,
+                       "ACQ_ACT_THS_MG out of the ACT_THS range at the full scale");
+        _Static_assert(ACQ_ACT_DUR <= 0xFF,
+                       "ACQ_ACT_DUR_S too long for ACT_DUR at the selected ODR");
+        _Static_assert(ACQ_ODR_HZ > ACQ_SLEEP_ODR_HZ,
+                       "Adaptive ODR needs an ODR above the 10 Hz of the sleep state");
+    #endif
+
+    #if ACQ_CLICK_MG > 0
+        _Static_assert(ACQ_CLICK_THS_AT(ACQ_RANGE_HIGH_G) >= 1 && ACQ_CLICK_THS_AT(ACQ_RANGE_LOW_G) <= 0x7F,
+                       "ACQ_CLICK_MG out of the CLICK_THS range at the full scale");
+        _Static_assert(ACQ_CLICK_TIME_LIMIT >= 1 && ACQ_CLICK_TIME_LIMIT <= 0x7F &&
+                       ACQ_CLICK_TIME_LATENCY <= 0xFF && ACQ_CLICK_TIME_WINDOW <= 0xFF,
+                       "Click times out of the TIME_LIMIT, TIME_LATENCY or TIME_WINDOW range at the selected ODR");
+    #endif
+    #if ACQ_FREEFALL_MG > 0
+        _Static_assert(ACQ_FREEFALL_THS_AT(ACQ_RANGE_HIGH_G) >= 1 && ACQ_FREEFALL_THS_AT(ACQ_RANGE_LOW_G) <= 0x7F,
+                       "ACQ_FREEFALL_MG out of the INT1_THS range at the full scale");
+        _Static_assert(ACQ_FREEFALL_DURATION <= 0x7F,
+                       "ACQ_FREEFALL_MS too long for INT1_DURATION at the selected ODR");
+    #endif
+    #if ACQ_EVENTS
+        _Static_assert(ACQ_EVENT_POLL_TICKS >= 1 && ACQ_EVENT_POLL_TICKS <= 0xFF,
+                       "ACQ_EVENT_POLL_TICKS must be 1 to 255");
+    #endif
+    #if ACQ_LOG
+        _Static_assert(ACQ_LOG_ROWS >= 2 && ACQ_LOG_ROWS <= 768,
+                       "ACQ_LOG_ROWS must be 2 to 768, leaving a quarter of the flash to the program");
+    #endif
+    #if ACQ_CALIBRATION
+        _Static_assert(!ACQ_HPF,
+                       "ACQ_CALIBRATION measures static offsets, which ACQ_HPF removes");
+        _Static_assert(ACQ_CALIBRATION_SAMPLES >= 1 && ACQ_CALIBRATION_SAMPLES <= 4096,
+                       "ACQ_CALIBRATION_SAMPLES must be 1 to 4096");
+    #endif
+
+    _Static_assert((ACQ_I2C_BITS_PER_S + ACQ_I2C_EVENT_BITS_PER_S) * 100 <= (long)ACQ_I2C_HZ * ACQ_I2C_MAX_LOAD,
+                   "Sample reads do not fit in the I2C bandwidth: lower ACQ_ODR_HZ or raise ACQ_I2C_HZ");
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,66 @@
+/*
+* This file includes the full-scale selection logic.
+*/
+
+#include "AutoRange.h"
+
+#if ACQ_AUTO_RANGE
+
+/*
+* Levels in mg, for each range, above which the range steps up and below
+* which it steps down.
+*/
+#define AUTORANGE_UP_MG(range) (AUTORANGE_FULL_SCALE_MG(range) * AUTORANGE_UP_PERCENT / 100)
+#define AUTORANGE_DOWN_MG(range) (AUTORANGE_FULL_SCALE_MG((range) - 1) * AUTORANGE_DOWN_PERCENT / 100)
+
+static const int16_t UpMg[AUTORANGE_RANGES] = {
+    AUTORANGE_UP_MG(0), AUTORANGE_UP_MG(1), AUTORANGE_UP_MG(2), INT16_MAX
+};
+static const int16_t DownMg[AUTORANGE_RANGES] = {
+    0, AUTORANGE_DOWN_MG(1), AUTORANGE_DOWN_MG(2), AUTORANGE_DOWN_MG(3)
+};
+
+void AutoRange_Init(AutoRange* autorange, uint8_t range)
+{
+    autorange->range = range;
+    autorange->quiet = 0;
+}
+
+uint8_t AutoRange_Add(AutoRange* autorange, const int16_t sample[3])
+{
+    int16_t peak = 0;
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        int16_t value = sample[axis] < 0 ? -sample[axis] : sample[axis];
+        if (value > peak)
+        {
+            peak = value;
+        }
+    }
+
+    if (peak >= UpMg[autorange->range])
+    {
+        // Clipping is lost data: step up without waiting
+        autorange->range++;
+        autorange->quiet = 0;
+        return 1;
+    }
+    if (peak >= DownMg[autorange->range])
+    {
+        autorange->quiet = 0;
+        return 0;
+    }
+    if (++autorange->quiet >= AUTORANGE_QUIET_SAMPLES)
+    {
+        autorange->range--;
+        autorange->quiet = 0;
+        return 1;
+    }
+    return 0;
+}
+
+#endif
+
+/* [] END OF FILE */
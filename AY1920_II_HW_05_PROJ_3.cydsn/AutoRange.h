@@ -0,0 +1,63 @@
+/**
+*   \file AutoRange.h
+*   \brief Full-scale selection on saturation.
+*
+*   This file declares the logic that picks the full scale of the LIS3DH
+*   from the samples it produces. A sample of any axis at
+*   AUTORANGE_UP_PERCENT of the full scale steps the range up at once; the
+*   range steps back down once all the axes have stayed below
+*   AUTORANGE_DOWN_PERCENT of the lower full scale for AUTORANGE_QUIET_SAMPLES
+*   samples in a row. The gap between the two levels keeps a signal close
+*   to one of them from switching back and forth.
+*
+*   The ranges are numbered as the FS bits of Control Register 4: 0 to 3
+*   for ± 2, 4, 8 and 16 g.
+*/
+
+#ifndef __AUTO_RANGE_H
+    #define __AUTO_RANGE_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief Number of ranges and full scale of each, in mg.
+    */
+    #define AUTORANGE_RANGES 4
+    #define AUTORANGE_FULL_SCALE_MG(range) ((range) == 3 ? 16000 : 2000 << (range))
+
+    /**
+    *   \brief Levels of the switches, in percent of the full scale.
+    */
+    #define AUTORANGE_UP_PERCENT ACQ_RANGE_UP_PERCENT
+    #define AUTORANGE_DOWN_PERCENT ACQ_RANGE_DOWN_PERCENT
+
+    /**
+    *   \brief Samples in a row below the lower level before stepping down.
+    */
+    #define AUTORANGE_QUIET_SAMPLES ACQ_RANGE_QUIET_SAMPLES
+
+    /**
+    *   \brief State of the range selection.
+    */
+    typedef struct {
+        uint8_t range;              ///< Current range
+        uint16_t quiet;             ///< Samples in a row below the step-down level
+    } AutoRange;
+
+    /**
+    *   \brief Start from the given range.
+    */
+    void AutoRange_Init(AutoRange* autorange, uint8_t range);
+
+    /**
+    *   \brief Add a sample of the three axes, in mg.
+    *
+    *   \param autorange Range selection.
+    *   \param sample Sample taken at the current range.
+    *   \retval Returns 1 when the range has changed, 0 otherwise.
+    */
+    uint8_t AutoRange_Add(AutoRange* autorange, const int16_t sample[3]);
+
+#endif
+/* [] END OF FILE */
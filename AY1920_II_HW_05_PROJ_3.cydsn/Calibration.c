@@ -0,0 +1,200 @@
+/*
+* This file includes the per-axis calibration and its storage in the
+* emulated EEPROM.
+*/
+
+#include "Calibration.h"
+#include "CyFlash.h"
+#include "cy_em_eeprom.h"
+
+#if ACQ_CALIBRATION
+
+/*
+* Record stored in the emulated EEPROM: the magic number tells stored
+* coefficients from a blank EEPROM, which reads as zeros.
+*/
+#define CALIBRATION_MAGIC 0xCA1Bu
+
+typedef struct {
+    uint16_t magic;
+    Calibration_Coefficients coefficients;
+} Calibration_Record;
+
+/*
+* Rows of the emulated EEPROM used in turn, and redundant copy to recover
+* from a write interrupted by a reset
+*/
+#define CALIBRATION_WEAR_LEVELING 2u
+#define CALIBRATION_REDUNDANT_COPY 1u
+
+/*
+* Spans between an axis up and down, in mg, accepted by the six-position
+* measure: outside of them the board was not in the expected positions.
+*/
+#define CALIBRATION_MIN_SPAN_MG 1000
+#define CALIBRATION_MAX_SPAN_MG 4000
+
+/*
+* Flash rows of the emulated EEPROM, aligned to a row
+*/
+CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t CalibrationFlash[CY_EM_EEPROM_GET_PHYSICAL_SIZE(sizeof(Calibration_Record),
+                                                                     CALIBRATION_WEAR_LEVELING,
+                                                                     CALIBRATION_REDUNDANT_COPY)] = {0};
+
+static cy_stc_eeprom_context_t EepromContext;
+
+void Calibration_Init(Calibration* calibration)
+{
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        calibration->coefficients.offset[axis] = 0;
+        calibration->coefficients.gain[axis] = CALIBRATION_UNIT_GAIN;
+    }
+    calibration->measure = CALIBRATION_IDLE;
+    calibration->measured = 0;
+}
+
+ErrorCode Calibration_Load(Calibration* calibration)
+{
+    cy_stc_eeprom_config_t config;
+    Calibration_Record record;
+
+    config.eepromSize = sizeof(Calibration_Record);
+    config.wearLevelingFactor = CALIBRATION_WEAR_LEVELING;
+    config.redundantCopy = CALIBRATION_REDUNDANT_COPY;
+    config.blockingWrite = 1u;
+    config.userFlashStartAddr = (uintptr_t)CalibrationFlash;
+
+    if (Cy_Em_EEPROM_Init(&config, &EepromContext) != CY_EM_EEPROM_SUCCESS ||
+        Cy_Em_EEPROM_Read(0u, &record, sizeof(record), &EepromContext) != CY_EM_EEPROM_SUCCESS ||
+        record.magic != CALIBRATION_MAGIC)
+    {
+        return ERROR;
+    }
+    calibration->coefficients = record.coefficients;
+    return NO_ERROR;
+}
+
+ErrorCode Calibration_Save(const Calibration* calibration)
+{
+    Calibration_Record record;
+
+    record.magic = CALIBRATION_MAGIC;
+    record.coefficients = calibration->coefficients;
+
+    // Flash programming needs the die temperature
+    if (CySetTemp() != CYRET_SUCCESS ||
+        Cy_Em_EEPROM_Write(0u, &record, sizeof(record), &EepromContext) != CY_EM_EEPROM_SUCCESS)
+    {
+        return ERROR;
+    }
+    return NO_ERROR;
+}
+
+void Calibration_Start(Calibration* calibration, uint8_t measure)
+{
+    uint8_t axis;
+
+    if (measure > CALIBRATION_REST)
+    {
+        return;
+    }
+    for (axis = 0; axis < 3; axis++)
+    {
+        calibration->sum[axis] = 0;
+    }
+    calibration->count = 0;
+    calibration->measure = measure;
+}
+
+Calibration_Result Calibration_Add(Calibration* calibration, const int16_t sample[3])
+{
+    Calibration_Coefficients* coefficients = &calibration->coefficients;
+    int16_t mean[3];
+    int32_t span;
+    uint8_t measure = calibration->measure;
+    uint8_t axis;
+
+    if (measure == CALIBRATION_IDLE)
+    {
+        return CALIBRATION_NONE;
+    }
+    for (axis = 0; axis < 3; axis++)
+    {
+        calibration->sum[axis] += sample[axis];
+    }
+    if (++calibration->count < CALIBRATION_SAMPLES)
+    {
+        return CALIBRATION_NONE;
+    }
+    calibration->measure = CALIBRATION_IDLE;
+
+    // Means rounded to the nearest mg
+    for (axis = 0; axis < 3; axis++)
+    {
+        int32_t half = (calibration->sum[axis] < 0) ? -CALIBRATION_SAMPLES / 2 : CALIBRATION_SAMPLES / 2;
+        mean[axis] = (int16_t)((calibration->sum[axis] + half) / CALIBRATION_SAMPLES);
+    }
+
+    if (measure == CALIBRATION_REST)
+    {
+        // Z reads 1 g through its gain, the other axes zero
+        coefficients->offset[0] = mean[0];
+        coefficients->offset[1] = mean[1];
+        coefficients->offset[2] = mean[2] - (int16_t)((1000L * CALIBRATION_UNIT_GAIN + coefficients->gain[2] / 2) /
+                                                      coefficients->gain[2]);
+        return CALIBRATION_UPDATED;
+    }
+
+    axis = measure / 2;
+    if (measure & 1)
+    {
+        calibration->down[axis] = mean[axis];
+    }
+    else
+    {
+        calibration->up[axis] = mean[axis];
+    }
+    calibration->measured |= (uint8_t)(1 << measure);
+    if (calibration->measured != (1 << CALIBRATION_POSITIONS) - 1)
+    {
+        return CALIBRATION_MEASURED;
+    }
+
+    // Each axis reads +1 g up and -1 g down
+    calibration->measured = 0;
+    for (axis = 0; axis < 3; axis++)
+    {
+        span = (int32_t)calibration->up[axis] - calibration->down[axis];
+        if (span < CALIBRATION_MIN_SPAN_MG || span > CALIBRATION_MAX_SPAN_MG)
+        {
+            continue;
+        }
+        coefficients->offset[axis] = (int16_t)(((int32_t)calibration->up[axis] + calibration->down[axis]) / 2);
+        coefficients->gain[axis] = (uint16_t)((2000L * CALIBRATION_UNIT_GAIN + span / 2) / span);
+    }
+    return CALIBRATION_UPDATED;
+}
+
+int16_t Calibration_Apply(const Calibration* calibration, uint8_t axis, int16_t value)
+{
+    int32_t corrected = ((int32_t)(value - calibration->coefficients.offset[axis]) *
+                         calibration->coefficients.gain[axis] + CALIBRATION_UNIT_GAIN / 2) >> 14;
+
+    if (corrected > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (corrected < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)corrected;
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,118 @@
+/**
+*   \file Calibration.h
+*   \brief Per-axis calibration of the accelerometer.
+*
+*   This file declares the offset and gain correction of the three axes,
+*   the measures that compute them and their storage in the emulated
+*   EEPROM, so that each board keeps its own coefficients across resets.
+*
+*   A corrected value is (value - offset) * gain / 2^14, in mg: one
+*   subtraction, one multiplication and one shift per axis. The offsets
+*   can be measured with the board at rest, Z up; the six-position
+*   measure (each axis up, then down) gives both offsets and gains.
+*/
+
+#ifndef __CALIBRATION_H
+    #define __CALIBRATION_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+    #include "ErrorCodes.h"
+
+    /**
+    *   \brief Gain of 1 in the Q14 format of the coefficients.
+    */
+    #define CALIBRATION_UNIT_GAIN 16384
+
+    /**
+    *   \brief Measures: the six positions, numbered as +X, -X, +Y, -Y,
+    *   +Z and -Z up, and the offsets at rest. No measure in progress.
+    */
+    #define CALIBRATION_POSITIONS 6
+    #define CALIBRATION_REST CALIBRATION_POSITIONS
+    #define CALIBRATION_IDLE 0xFF
+
+    /**
+    *   \brief Samples averaged by each measure.
+    */
+    #define CALIBRATION_SAMPLES ACQ_CALIBRATION_SAMPLES
+
+    /**
+    *   \brief Outcome of a sample added to a measure.
+    */
+    typedef enum {
+        CALIBRATION_NONE,           ///< No measure ended
+        CALIBRATION_MEASURED,       ///< A position measured, others still missing
+        CALIBRATION_UPDATED         ///< New coefficients in use
+    } Calibration_Result;
+
+    /**
+    *   \brief Coefficients of the three axes, as stored in the EEPROM.
+    */
+    typedef struct {
+        int16_t offset[3];          ///< Offset of each axis, in mg
+        uint16_t gain[3];           ///< Gain of each axis, Q14
+    } Calibration_Coefficients;
+
+    /**
+    *   \brief Coefficients in use and state of the measures.
+    */
+    typedef struct {
+        Calibration_Coefficients coefficients;  ///< Coefficients applied to the samples
+        int32_t sum[3];                         ///< Sum of the samples of the current measure
+        uint16_t count;                         ///< Samples of the current measure
+        uint8_t measure;                        ///< Current measure, or CALIBRATION_IDLE
+        uint8_t measured;                       ///< Bit mask of the positions measured
+        int16_t up[3];                          ///< Mean of each axis pointing up, in mg
+        int16_t down[3];                        ///< Mean of each axis pointing down, in mg
+    } Calibration;
+
+    /**
+    *   \brief Start with unit gains and no offsets.
+    */
+    void Calibration_Init(Calibration* calibration);
+
+    /**
+    *   \brief Prepare the emulated EEPROM and load the coefficients stored in it.
+    *
+    *   \param calibration Calibration, left unchanged if no coefficients are stored.
+    *   \retval Returns NO_ERROR when stored coefficients have been loaded.
+    */
+    ErrorCode Calibration_Load(Calibration* calibration);
+
+    /**
+    *   \brief Store the coefficients in use in the emulated EEPROM.
+    *
+    *   The write blocks for the flash rows it programs.
+    */
+    ErrorCode Calibration_Save(const Calibration* calibration);
+
+    /**
+    *   \brief Start a measure.
+    *
+    *   \param calibration Calibration.
+    *   \param measure One of the six positions, or CALIBRATION_REST.
+    */
+    void Calibration_Start(Calibration* calibration, uint8_t measure);
+
+    /**
+    *   \brief Add an uncorrected sample of the three axes to the measure in progress.
+    *
+    *   \param calibration Calibration.
+    *   \param sample Sample in mg, before Calibration_Apply.
+    *   \retval Returns CALIBRATION_UPDATED when new coefficients are in use:
+    *   the offsets after the measure at rest, offsets and gains once all
+    *   the six positions have been measured (an axis whose span between up
+    *   and down is not about 2 g keeps its coefficients). Returns
+    *   CALIBRATION_MEASURED when a position has been measured and others
+    *   are missing, CALIBRATION_NONE otherwise.
+    */
+    Calibration_Result Calibration_Add(Calibration* calibration, const int16_t sample[3]);
+
+    /**
+    *   \brief Correct a value of an axis, in mg.
+    */
+    int16_t Calibration_Apply(const Calibration* calibration, uint8_t axis, int16_t value);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,55 @@
+/*
+* This file includes the clock profiles, based on the clocking API of the
+* PSoC 5LP system library. The master clock is moved to the IMO while the
+* PLL is reconfigured, and the flash wait cycles are set for the faster of
+* the two clocks during the switch. The balanced profile is the one of the
+* design and leaves everything as it is.
+*/
+
+#include "ClockProfile.h"
+#include "project.h"
+
+/**
+*   \brief Charge pump current of the PLL, in uA.
+*/
+#define CLOCK_PROFILE_PLL_CURRENT 2u
+
+void ClockProfile_Apply(void)
+{
+#if ACQ_BUS_CLK_HZ != BCLK__BUS_CLK__HZ
+    uint8 interrupts = CyEnterCriticalSection();
+
+    if (ACQ_BUS_CLK_HZ > BCLK__BUS_CLK__HZ)
+    {
+        CyFlash_SetWaitCycles((uint8)ACQ_BUS_CLK_MHZ);
+    }
+
+    // Run from the 3 MHz IMO while the PLL is changed
+    CyMasterClk_SetSource(CY_MASTER_SOURCE_IMO);
+    CyPLL_OUT_Stop();
+#if ACQ_CLOCK_PROFILE == ACQ_CLOCK_LOW_POWER
+    CyIMO_SetFreq(CY_IMO_FREQ_12MHZ);
+#else
+    CyPLL_OUT_SetPQ(ACQ_PLL_P, ACQ_PLL_Q, CLOCK_PROFILE_PLL_CURRENT);
+    (void)CyPLL_OUT_Start(1u); // Wait for the lock
+    CyMasterClk_SetSource(CY_MASTER_SOURCE_PLL);
+#endif
+
+    if (ACQ_BUS_CLK_HZ < BCLK__BUS_CLK__HZ)
+    {
+        CyFlash_SetWaitCycles((uint8)ACQ_BUS_CLK_MHZ);
+    }
+    CyDelayFreq(ACQ_BUS_CLK_HZ);
+
+    timer_clock_SetDividerValue(ACQ_TIMER_CLOCK_DIVIDER);
+    UART_Debug_IntClock_SetDividerValue(ACQ_UART_CLOCK_DIVIDER);
+    I2C_Master_Init();
+    I2C_Master_CLKDIV1_REG = LO8(ACQ_I2C_CLOCK_DIVIDER);
+    I2C_Master_CLKDIV2_REG = HI8(ACQ_I2C_CLOCK_DIVIDER);
+    I2C_Master_initVar = 1u;
+
+    CyExitCriticalSection(interrupts);
+#endif
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,28 @@
+/**
+*   \file ClockProfile.h
+*   \brief Clock profile of the CPU.
+*
+*   This is an interface to move the master clock from the 24 MHz set in
+*   the design to the profile selected by ACQ_CLOCK_PROFILE, together with
+*   the dividers of the clocks derived from the bus clock, so that the
+*   Timer, UART_Debug and I2C_Master keep their rates in every profile.
+*/
+
+#ifndef __CLOCK_PROFILE_H
+    #define __CLOCK_PROFILE_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief Switch to the clock profile of the configuration.
+    *
+    *   To be called in main before the components are started: I2C_Master
+    *   is initialized here with the divider of the profile, so that
+    *   I2C_Master_Start() only enables it. The cycle counter counts at
+    *   ACQ_BUS_CLK_HZ from here on.
+    */
+    void ClockProfile_Apply(void);
+
+#endif
+/* [] END OF FILE */
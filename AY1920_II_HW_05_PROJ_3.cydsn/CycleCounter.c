@@ -0,0 +1,34 @@
+/*
+* This file includes the cycle counter, based on the DWT unit of the
+* Cortex-M3 core.
+*/
+
+#include "CycleCounter.h"
+
+/**
+*   \brief Debug Exception and Monitor Control Register and its trace enable bit.
+*/
+#define CYCLE_COUNTER_DEMCR         (*(reg32 *)0xE000EDFCu)
+#define CYCLE_COUNTER_DEMCR_TRCENA  0x01000000u
+
+/**
+*   \brief DWT Control Register, its counter enable bit and the cycle counter.
+*/
+#define CYCLE_COUNTER_DWT_CTRL      (*(reg32 *)0xE0001000u)
+#define CYCLE_COUNTER_DWT_CYCCNTENA 0x00000001u
+#define CYCLE_COUNTER_DWT_CYCCNT    (*(reg32 *)0xE0001004u)
+
+void CycleCounter_Start(void)
+{
+    // The DWT is powered only while trace is enabled
+    CYCLE_COUNTER_DEMCR |= CYCLE_COUNTER_DEMCR_TRCENA;
+    CYCLE_COUNTER_DWT_CYCCNT = 0;
+    CYCLE_COUNTER_DWT_CTRL |= CYCLE_COUNTER_DWT_CYCCNTENA;
+}
+
+uint32 CycleCounter_Read(void)
+{
+    return CYCLE_COUNTER_DWT_CYCCNT;
+}
+
+/* [] END OF FILE */
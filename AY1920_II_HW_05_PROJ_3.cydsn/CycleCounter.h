@@ -0,0 +1,29 @@
+/**
+*   \file CycleCounter.h
+*   \brief CPU cycle counter.
+*
+*   This is an interface to the cycle counter of the Cortex-M3 Data
+*   Watchpoint and Trace unit (DWT_CYCCNT), used to measure the execution
+*   time of the firmware in bus clock cycles.
+*/
+
+#ifndef __CYCLE_COUNTER_H
+    #define __CYCLE_COUNTER_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Enable the cycle counter.
+    */
+    void CycleCounter_Start(void);
+
+    /**
+    *   \brief Current value of the cycle counter.
+    *
+    *   The counter wraps around every 2^32 cycles: differences between two
+    *   readings are valid as long as they are computed as uint32.
+    */
+    uint32 CycleCounter_Read(void);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,45 @@
+/*
+* This file includes the minimal text formatting of the diagnostics.
+*/
+
+#include "DebugText.h"
+
+static const char HexDigits[] = "0123456789ABCDEF";
+
+uint8_t DebugText_Hex(char* text, uint8_t value)
+{
+    text[0] = '0';
+    text[1] = 'x';
+    text[2] = HexDigits[value >> 4];
+    text[3] = HexDigits[value & 0x0F];
+    text[4] = '\0';
+    return 4;
+}
+
+uint8_t DebugText_Decimal(char* text, int32_t value)
+{
+    char digits[10];
+    // Work on the magnitude as unsigned, so that INT32_MIN has one too
+    uint32_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+    uint8_t count = 0;
+    uint8_t length = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0)
+    {
+        text[length++] = '-';
+    }
+    while (count > 0)
+    {
+        text[length++] = digits[--count];
+    }
+    text[length] = '\0';
+    return length;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,43 @@
+/**
+*   \file DebugText.h
+*   \brief Minimal text formatting for the diagnostics.
+*
+*   This file declares the few conversions the diagnostics need, in place
+*   of sprintf: a byte in hexadecimal and a signed integer in decimal. Each
+*   one writes its digits to a buffer, adds the terminator and returns the
+*   number of characters written, so that the caller can append the next
+*   field. Nothing is pulled in from the C library.
+*/
+
+#ifndef __DEBUG_TEXT_H
+    #define __DEBUG_TEXT_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Characters taken by the longest field, terminator included:
+    *   "0xFF" and "-2147483648".
+    */
+    #define DEBUG_TEXT_HEX_SIZE 5
+    #define DEBUG_TEXT_DECIMAL_SIZE 12
+
+    /**
+    *   \brief Write a byte as "0x" and two upper-case hexadecimal digits.
+    *
+    *   \param text Buffer of at least DEBUG_TEXT_HEX_SIZE characters.
+    *   \param value Byte to be written.
+    *   \retval Returns the number of characters written, terminator excluded.
+    */
+    uint8_t DebugText_Hex(char* text, uint8_t value);
+
+    /**
+    *   \brief Write a signed integer in decimal, with a minus sign if negative.
+    *
+    *   \param text Buffer of at least DEBUG_TEXT_DECIMAL_SIZE characters.
+    *   \param value Integer to be written.
+    *   \retval Returns the number of characters written, terminator excluded.
+    */
+    uint8_t DebugText_Decimal(char* text, int32_t value);
+
+#endif
+/* [] END OF FILE */
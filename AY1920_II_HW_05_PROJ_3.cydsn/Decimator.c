@@ -0,0 +1,98 @@
+/*
+* This file includes the decimating FIR filter: the filter is evaluated at
+* the output rate only, and its symmetry is used to halve the number of
+* multiplications.
+*/
+
+#include "Decimator.h"
+
+/*
+*  Q15 coefficients, summing to 32768 (unit gain at DC)
+*/
+
+#if DECIMATOR_RATIO == 1
+    // No decimation: the filter is not used
+#elif DECIMATOR_RATIO == 2
+static const int16_t coefficients[DECIMATOR_TAPS] = {
+        69,     57,    -95,   -263,      0,    679,    635,   -943,  -2276,      0,   6344,  12177,
+     12177,   6344,      0,  -2276,   -943,    635,    679,      0,   -263,    -95,     57,     69
+};
+#elif DECIMATOR_RATIO == 4
+static const int16_t coefficients[DECIMATOR_TAPS] = {
+        29,     39,     38,     18,    -24,    -81,   -131,   -136,    -66,     83,    270,    411,
+       407,    189,   -229,   -727,  -1093,  -1084,   -515,    657,   2287,   4057,   5561,   6424,
+      6424,   5561,   4057,   2287,    657,   -515,  -1084,  -1093,   -727,   -229,    189,    407,
+       411,    270,     83,    -66,   -136,   -131,    -81,    -24,     18,     38,     39,     29
+};
+#elif DECIMATOR_RATIO == 8
+static const int16_t coefficients[DECIMATOR_TAPS] = {
+        12,     16,     19,     21,     20,     18,     13,      5,     -6,    -20,    -35,    -50,
+       -63,    -71,    -73,    -65,    -47,    -18,     20,     66,    114,    160,    196,    217,
+       216,    189,    134,     51,    -56,   -178,   -305,   -423,   -516,   -570,   -569,   -501,
+      -359,   -139,    156,    517,    927,   1367,   1813,   2238,   2617,   2925,   3143,   3258,
+      3258,   3143,   2925,   2617,   2238,   1813,   1367,    927,    517,    156,   -139,   -359,
+      -501,   -569,   -570,   -516,   -423,   -305,   -178,    -56,     51,    134,    189,    216,
+       217,    196,    160,    114,     66,     20,    -18,    -47,    -65,    -73,    -71,    -63,
+       -50,    -35,    -20,     -6,      5,     13,     18,     20,     21,     19,     16,     12
+};
+#else
+    #error "No Decimator coefficients for this DECIMATOR_RATIO"
+#endif
+
+#if DECIMATOR_RATIO > 1
+
+void Decimator_Init(Decimator* decimator)
+{
+    uint8_t i;
+
+    for (i = 0; i < 2 * DECIMATOR_TAPS; i++)
+    {
+        decimator->history[i] = 0;
+    }
+    decimator->position = 0;
+    decimator->phase = 0;
+}
+
+uint8_t Decimator_Push(Decimator* decimator, int16_t sample, int16_t* output)
+{
+    // Store the sample in both halves, so that the last DECIMATOR_TAPS
+    // samples are always contiguous
+    decimator->history[decimator->position] = sample;
+    decimator->history[decimator->position + DECIMATOR_TAPS] = sample;
+    if (++decimator->position == DECIMATOR_TAPS)
+    {
+        decimator->position = 0;
+    }
+
+    if (++decimator->phase < DECIMATOR_RATIO)
+    {
+        return 0;
+    }
+    decimator->phase = 0;
+
+    // Oldest sample first; the filter is symmetric, so the two ends share
+    // the same coefficient
+    const int16_t* x = &decimator->history[decimator->position];
+    int32_t accumulator = 1 << 14; // Round to nearest
+    uint8_t i;
+
+    for (i = 0; i < DECIMATOR_TAPS / 2; i++)
+    {
+        accumulator += coefficients[i] * (int32_t)(x[i] + x[DECIMATOR_TAPS - 1 - i]);
+    }
+    accumulator >>= 15;
+
+    if (accumulator > INT16_MAX)
+    {
+        accumulator = INT16_MAX;
+    }
+    else if (accumulator < INT16_MIN)
+    {
+        accumulator = INT16_MIN;
+    }
+    *output = (int16_t)accumulator;
+    return 1;
+}
+#endif
+
+/* [] END OF FILE */
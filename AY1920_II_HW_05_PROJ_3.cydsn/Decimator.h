@@ -0,0 +1,57 @@
+/**
+*   \file Decimator.h
+*   \brief Fixed-point decimating FIR filter.
+*
+*   This file declares a low-pass FIR filter followed by decimation, used
+*   to turn the oversampled accelerometer data into an anti-aliased stream
+*   at ACQ_ODR_HZ / ACQ_DECIMATION. The filter is only evaluated once every
+*   DECIMATOR_RATIO input samples, at the output rate.
+*
+*   The coefficients are Q15, with unit gain at DC, and are selected at
+*   compile time for the decimation ratio: a Hamming-windowed sinc of
+*   12 taps per ratio with the -6 dB point at 0.8 times the output Nyquist
+*   frequency (-0.5 dB at 0.6, below -50 dB from 1.2 on).
+*/
+
+#ifndef __DECIMATOR_H
+    #define __DECIMATOR_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief Decimation ratio (2, 4 or 8; 1 leaves the filter out).
+    */
+    #define DECIMATOR_RATIO ACQ_DECIMATION
+
+    /**
+    *   \brief Number of filter taps.
+    */
+    #define DECIMATOR_TAPS (12 * DECIMATOR_RATIO)
+
+    /**
+    *   \brief State of the filter of one axis.
+    */
+    typedef struct {
+        int16_t history[2 * DECIMATOR_TAPS]; ///< Last inputs, stored twice to avoid wrapping
+        uint8_t position;                    ///< Next slot of the history
+        uint8_t phase;                       ///< Inputs since the last output
+    } Decimator;
+
+    /**
+    *   \brief Clear the filter history.
+    */
+    void Decimator_Init(Decimator* decimator);
+
+    /**
+    *   \brief Feed one input sample to the filter.
+    *
+    *   \param decimator Filter of the axis.
+    *   \param sample Input sample.
+    *   \param output Pointer to a variable where the output sample will be saved.
+    *   \retval Returns 1 when an output sample has been produced, 0 otherwise.
+    */
+    uint8_t Decimator_Push(Decimator* decimator, int16_t sample, int16_t* output);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,193 @@
+/*
+* This file includes the offline log of the samples in flash.
+*/
+
+#include "FlashLog.h"
+#include "CyLib.h"
+
+#include <string.h>
+
+#if ACQ_LOG
+
+_Static_assert(FLASHLOG_HEADER_SIZE + FLASHLOG_SAMPLE_MAX_SIZE <= CY_FLASH_SIZEOF_ROW,
+               "A sample does not fit in a flash row");
+
+/*
+* Rows of the ring in the flash address space.
+*/
+static const uint8_t* FlashLog_Address(uint16_t row)
+{
+    return (const uint8_t*)(CY_FLASH_BASE + FLASHLOG_START + (uint32)row * CY_FLASH_SIZEOF_ROW);
+}
+
+/*
+* Sequence number of a row of the ring, 0 for a blank row.
+*/
+static uint32_t FlashLog_Sequence(uint16_t row)
+{
+    const uint8_t* data = FlashLog_Address(row);
+
+    return data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/*
+* Save a value in the row, little endian.
+*/
+static void FlashLog_Put(uint8_t* field, uint32_t value, uint8_t bytes)
+{
+    uint8_t i;
+
+    for (i = 0; i < bytes; i++)
+    {
+        field[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/*
+* Empty the row being filled.
+*/
+static void FlashLog_Start(FlashLog* log)
+{
+    memset(log->row, 0, sizeof(log->row));
+    log->last[0] = log->last[1] = log->last[2] = 0;
+    log->used = FLASHLOG_HEADER_SIZE;
+    log->samples = 0;
+}
+
+/*
+* Encode the enabled axes of a sample as zigzag differences, 7 bits per
+* byte. Returns the number of bytes saved.
+*/
+static uint8_t FlashLog_Encode(const FlashLog* log, const int16_t sample[3], uint8_t* data)
+{
+    int32_t delta;
+    uint32_t zigzag;
+    uint8_t axis;
+    uint8_t size = 0;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (!(ACQ_AXIS_MASK & (1 << axis)))
+        {
+            continue;
+        }
+        delta = (int32_t)sample[axis] - log->last[axis];
+        zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+        while (zigzag >= 0x80)
+        {
+            data[size++] = (uint8_t)(zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        data[size++] = (uint8_t)zigzag;
+    }
+    return size;
+}
+
+void FlashLog_Init(FlashLog* log)
+{
+    uint32_t sequence;
+    uint32_t newest = 0;
+    uint16_t row;
+
+    log->head = 0;
+    log->rows = 0;
+    for (row = 0; row < FLASHLOG_ROWS; row++)
+    {
+        sequence = FlashLog_Sequence(row);
+        if (sequence == 0)
+        {
+            continue;
+        }
+        log->rows++;
+        if (sequence > newest)
+        {
+            newest = sequence;
+            log->head = (row + 1 == FLASHLOG_ROWS) ? 0 : row + 1;
+        }
+    }
+    log->sequence = newest + 1;
+    FlashLog_Start(log);
+}
+
+ErrorCode FlashLog_Add(FlashLog* log, const int16_t sample[3], uint32 tick)
+{
+    uint8_t data[FLASHLOG_SAMPLE_MAX_SIZE];
+    uint8_t size = FlashLog_Encode(log, sample, data);
+    ErrorCode error = NO_ERROR;
+
+    if (log->used + size > CY_FLASH_SIZEOF_ROW)
+    {
+        // The first sample of the next row is encoded from 0
+        error = FlashLog_Flush(log);
+        size = FlashLog_Encode(log, sample, data);
+    }
+    if (log->samples == 0)
+    {
+        FlashLog_Put(&log->row[4], tick, 4);
+    }
+    memcpy(&log->row[log->used], data, size);
+    log->used += size;
+    log->samples++;
+    log->last[0] = sample[0];
+    log->last[1] = sample[1];
+    log->last[2] = sample[2];
+    return error;
+}
+
+ErrorCode FlashLog_Flush(FlashLog* log)
+{
+    uint32 address = FLASHLOG_START + (uint32)log->head * CY_FLASH_SIZEOF_ROW;
+    cystatus status;
+
+    if (log->samples == 0)
+    {
+        return NO_ERROR;
+    }
+    FlashLog_Put(&log->row[0], log->sequence, 4);
+    FlashLog_Put(&log->row[8], log->samples, 2);
+    log->row[10] = ACQ_AXIS_MASK;
+    log->row[11] = (uint8_t)(log->used - FLASHLOG_HEADER_SIZE);
+
+    // Flash programming needs the die temperature
+    status = CySetTemp();
+    if (status == CYRET_SUCCESS)
+    {
+        status = CyWriteRowData((uint8)(address / CY_FLASH_SIZEOF_ARRAY),
+                                (uint16)((address % CY_FLASH_SIZEOF_ARRAY) / CY_FLASH_SIZEOF_ROW),
+                                log->row);
+    }
+    FlashLog_Start(log);
+    if (status != CYRET_SUCCESS)
+    {
+        return ERROR;
+    }
+    // The cache may still hold the old contents of the row
+    CyFlushCache();
+
+    log->sequence++;
+    if (++log->head == FLASHLOG_ROWS)
+    {
+        log->head = 0;
+    }
+    if (log->rows < FLASHLOG_ROWS)
+    {
+        log->rows++;
+    }
+    return NO_ERROR;
+}
+
+uint16_t FlashLog_Rows(const FlashLog* log)
+{
+    return log->rows;
+}
+
+const uint8_t* FlashLog_Row(const FlashLog* log, uint16_t index)
+{
+    uint16_t row = log->head + FLASHLOG_ROWS - log->rows + index;
+
+    return FlashLog_Address((row >= FLASHLOG_ROWS) ? row - FLASHLOG_ROWS : row);
+}
+
+#endif
+
+/* [] END OF FILE */
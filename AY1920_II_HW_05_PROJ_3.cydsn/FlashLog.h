@@ -0,0 +1,95 @@
+/**
+*   \file FlashLog.h
+*   \brief Offline log of the samples in flash.
+*
+*   This file declares a log that appends the samples of the enabled axes
+*   to a ring of FLASHLOG_ROWS flash rows at the top of the flash. Samples
+*   are collected in RAM one row at a time and the row is programmed when
+*   full; each row stands alone:
+*
+*   sequence number of the row (uint32, 0 for a blank row), Timer tick of
+*   the first sample (uint32), samples (uint16), axis mask, bytes of data,
+*   then for each sample the enabled axes from X to Z, each as the
+*   difference in mg from the previous sample of the row (from 0 for the
+*   first one), zigzag encoded and written 7 bits per byte, low bits first,
+*   with bit 7 set on all the bytes but the last.
+*
+*   A still axis takes one byte per sample instead of two. The rows are
+*   programmed in turn, so the wear is spread over the whole ring, and the
+*   sequence numbers tell the oldest row after a reset.
+*/
+
+#ifndef __FLASH_LOG_H
+    #define __FLASH_LOG_H
+
+    #include "cytypes.h"
+    #include "CyFlash.h"
+    #include "AcquisitionConfig.h"
+    #include "ErrorCodes.h"
+
+    /**
+    *   \brief Rows of the ring and their first byte from the flash base.
+    *
+    *   The linker script does not reserve the rows: map_report -l checks
+    *   that the image ends below FLASHLOG_START.
+    */
+    #define FLASHLOG_ROWS ACQ_LOG_ROWS
+    #define FLASHLOG_START (CY_FLASH_SIZE - (uint32)FLASHLOG_ROWS * CY_FLASH_SIZEOF_ROW)
+
+    /**
+    *   \brief Bytes of the row header and most bytes taken by a sample.
+    */
+    #define FLASHLOG_HEADER_SIZE 12
+    #define FLASHLOG_SAMPLE_MAX_SIZE (3 * 3)
+
+    /**
+    *   \brief Row being filled and position of the ring.
+    */
+    typedef struct {
+        uint8_t row[CY_FLASH_SIZEOF_ROW];   ///< Row being filled
+        int16_t last[3];                    ///< Last sample added to the row, in mg
+        uint16_t used;                      ///< Bytes of the row used, header included
+        uint16_t samples;                   ///< Samples in the row
+        uint16_t head;                      ///< Next row of the ring to be programmed
+        uint16_t rows;                      ///< Rows of the ring holding samples
+        uint32_t sequence;                  ///< Sequence number of the next row
+    } FlashLog;
+
+    /**
+    *   \brief Find the end of the log left in flash and start a new row.
+    */
+    void FlashLog_Init(FlashLog* log);
+
+    /**
+    *   \brief Append a sample of the enabled axes.
+    *
+    *   \param log Log.
+    *   \param sample Sample in mg; the disabled axes are ignored.
+    *   \param tick Timer tick of the sample, kept for the first one of each row.
+    *   \retval Returns ERROR if a full row could not be programmed: its samples are lost.
+    */
+    ErrorCode FlashLog_Add(FlashLog* log, const int16_t sample[3], uint32 tick);
+
+    /**
+    *   \brief Program the row being filled, if it holds any sample.
+    *
+    *   Blocks for the time the row takes to be programmed.
+    */
+    ErrorCode FlashLog_Flush(FlashLog* log);
+
+    /**
+    *   \brief Rows of the ring holding samples.
+    */
+    uint16_t FlashLog_Rows(const FlashLog* log);
+
+    /**
+    *   \brief Row of the log, in flash.
+    *
+    *   \param log Log.
+    *   \param index Index of the row, 0 for the oldest one.
+    *   \retval Returns the CY_FLASH_SIZEOF_ROW bytes of the row.
+    */
+    const uint8_t* FlashLog_Row(const FlashLog* log, uint16_t index);
+
+#endif
+/* [] END OF FILE */
@@ -248,10 +248,12 @@
 
                                             uint8_t register_count,
 
-                                            uint8_t* data)
+                                            const uint8_t* data)
 
     {
 
+        uint8_t i;
+
         // Send start condition
 
         uint8_t error = I2C_Master_MasterSendStart(device_address, I2C_Master_WRITE_XFER_MODE);
@@ -260,23 +262,17 @@
 
         {
 
-            // Write register address
-
-            error = I2C_Master_MasterWriteByte(register_address);
-
-            if (error == I2C_Master_MSTR_NO_ERROR)
+            // Write address of the first register, with the auto-increment bit
 
-            {
-
-                // Write byte of interest
+            error = I2C_Master_MasterWriteByte(register_address|(0x80));
 
-                register_count=register_count-1;
+            // Write the bytes of interest, the first one in the first register
 
-                while(register_address>0){
+            for (i = 0; i < register_count && error == I2C_Master_MSTR_NO_ERROR; i++)
 
-                error = I2C_Master_MasterWriteByte(data[register_count]);
+            {
 
-                }
+                error = I2C_Master_MasterWriteByte(data[i]);
 
             }
 
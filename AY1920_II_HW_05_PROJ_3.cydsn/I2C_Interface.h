@@ -15,6 +15,7 @@
     
     #include "cytypes.h"
     #include "ErrorCodes.h"
+    #include "AcquisitionConfig.h"
     
     /** \brief Start the I2C peripheral.
     *   
@@ -32,12 +33,12 @@
     *   \brief Read one byte over I2C.
     *   
     *   This function performs a complete reading operation over I2C from a single
-    *   register.
+    *   register. The register transfers run from SRAM with ACQ_RAM_HOT_PATH.
     *   \param device_address I2C address of the device to talk to.
     *   \param register_address Address of the register to be read.
     *   \param data Pointer to a variable where the byte will be saved.
     */
-    ErrorCode I2C_Peripheral_ReadRegister(uint8_t device_address, 
+    ACQ_RAMFUNC ErrorCode I2C_Peripheral_ReadRegister(uint8_t device_address, 
                                             uint8_t register_address,
                                             uint8_t* data);
     
@@ -51,7 +52,7 @@
     *   \param register_count Number of registers we want to read.
     *   \param data Pointer to an array where data will be saved.
     */
-    ErrorCode I2C_Peripheral_ReadRegisterMulti(uint8_t device_address,
+    ACQ_RAMFUNC ErrorCode I2C_Peripheral_ReadRegisterMulti(uint8_t device_address,
                                                 uint8_t register_address,
                                                 uint8_t register_count,
                                                 uint8_t* data);
@@ -64,7 +65,7 @@
     *   \param register_address Address of the register to be written.
     *   \param data Data to be written
     */
-    ErrorCode I2C_Peripheral_WriteRegister(uint8_t device_address,
+    ACQ_RAMFUNC ErrorCode I2C_Peripheral_WriteRegister(uint8_t device_address,
                                             uint8_t register_address,
                                             uint8_t data);
     
@@ -76,12 +77,12 @@
     *   \param device_address I2C address of the device to talk to.
     *   \param register_address Address of the first register to be written.
     *   \param register_count Number of registers that need to be written.
-    *   \param data Array of data to be written
+    *   \param data Array of data to be written, starting from the first register
     */
-    ErrorCode I2C_Peripheral_WriteRegisterMulti(uint8_t device_address,
+    ACQ_RAMFUNC ErrorCode I2C_Peripheral_WriteRegisterMulti(uint8_t device_address,
                                             uint8_t register_address,
                                             uint8_t register_count,
-                                            uint8_t* data);
+                                            const uint8_t* data);
     
     /**
     *   \brief Check if device is connected over I2C.
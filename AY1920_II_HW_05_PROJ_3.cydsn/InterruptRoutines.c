@@ -11,12 +11,44 @@
 */
 #include "InterruptRoutines.h"
 
+volatile uint8 Timer_ISR_start; // Flag set at each Timer terminal count
+volatile uint32 Timer_Ticks; // Timer terminal counts since start-up
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+volatile uint32 Timer_TickCycles; // Cycle counter at the last terminal count
+volatile uint16 Timer_TickDelay; // Timer counts from the last terminal count to its interrupt
+#endif
+
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0 || ACQ_ISR_REPORT_TICKS > 0
+/* Whole Timer counts since the last terminal count: the counter holds 0
+for the count of the terminal count, then is reloaded with the period and
+counts down. Unlike the cycle counter, it runs while the CPU is halted. */
+static uint16 Timer_CountsSinceTick(uint16 period)
+{
+    uint16 counter=Timer_ReadCounter();
+    return (counter==0) ? 0 : (uint16)(period+1-counter);
+}
+#endif
+
 CY_ISR(Custom_Timer_ISR){
 
-    
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+    Timer_TickCycles=CycleCounter_Read(); // First, to keep the entry latency only
+    Timer_TickDelay=Timer_CountsSinceTick(Timer_ReadPeriod());
+#endif
+
+#if ACQ_ISR_REPORT_TICKS > 0
+    IsrBudget_Run Run;
+    IsrBudget_Enter(&Run);
+    uint16 Delay=Timer_CountsSinceTick(Timer_ReadPeriod());
+#endif
 
     Timer_ReadStatusRegister(); // Read Timer Status Register in order to reset counter and trigger the ISR
     Timer_ISR_start=1;
+    Timer_Ticks++;
+
+#if ACQ_ISR_REPORT_TICKS > 0
+    IsrBudget_TimerRun(IsrBudget_Exit(&Run), Delay);
+#endif
 
 }
 /* [] END OF FILE */
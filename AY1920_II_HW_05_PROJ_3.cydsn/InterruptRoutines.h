@@ -20,10 +20,24 @@
 
     #include "I2C_Interface.h"
 
-    CY_ISR_PROTO(Custom_Timer_ISR); 
+    #include "AcquisitionConfig.h"
 
+    #include "CycleCounter.h"
 
-    volatile uint8 Timer_ISR_start;
+    #include "IsrBudget.h"
+
+    ACQ_RAMFUNC CY_ISR_PROTO(Custom_Timer_ISR); // In SRAM with ACQ_RAM_HOT_PATH
+
+
+    extern volatile uint8 Timer_ISR_start;
+
+    extern volatile uint32 Timer_Ticks;
+
+    #if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+        extern volatile uint32 Timer_TickCycles;
+
+        extern volatile uint16 Timer_TickDelay;
+    #endif
 
  
 
@@ -0,0 +1,126 @@
+/*
+* This file includes the interrupt priorities and the timing of the
+* interrupts, based on the interrupt controller API of the PSoC 5LP system
+* library and on the entry and exit callbacks of the components.
+*/
+
+#include "IsrBudget.h"
+#include "project.h"
+
+#if ACQ_ISR_REPORT_TICKS > 0
+    #include "CycleCounter.h"
+#endif
+
+void IsrBudget_SetPriorities(void)
+{
+    isr_Timer_SetPriority(ACQ_TIMER_ISR_PRIORITY);
+    CyIntSetPriority(I2C_Master_ISR_NUMBER, ACQ_I2C_ISR_PRIORITY);
+#if defined(UART_Debug_TX_VECT_NUM)
+    CyIntSetPriority(UART_Debug_TX_VECT_NUM, ACQ_UART_ISR_PRIORITY);
+#endif
+#if defined(UART_Debug_RX_VECT_NUM)
+    CyIntSetPriority(UART_Debug_RX_VECT_NUM, ACQ_UART_ISR_PRIORITY);
+#endif
+}
+
+void IsrBudget_GetPriorities(IsrBudget_Priorities* priorities)
+{
+    priorities->timer = isr_Timer_GetPriority();
+    priorities->i2c = CyIntGetPriority(I2C_Master_ISR_NUMBER);
+#if defined(UART_Debug_TX_VECT_NUM)
+    priorities->uart = CyIntGetPriority(UART_Debug_TX_VECT_NUM);
+#elif defined(UART_Debug_RX_VECT_NUM)
+    priorities->uart = CyIntGetPriority(UART_Debug_RX_VECT_NUM);
+#else
+    priorities->uart = ISR_BUDGET_NO_INTERRUPT;
+#endif
+}
+
+#if ACQ_ISR_REPORT_TICKS > 0
+
+static volatile uint32 Charged; // Own cycles of all the runs so far
+static volatile IsrBudget_Stats Longest; // Longest runs since the last read
+
+void IsrBudget_Enter(IsrBudget_Run* run)
+{
+    // Not preempted between the two reads, or the run would be charged wrong
+    uint8 interrupts = CyEnterCriticalSection();
+    run->entry = CycleCounter_Read();
+    run->charged = Charged;
+    CyExitCriticalSection(interrupts);
+}
+
+uint32 IsrBudget_Exit(const IsrBudget_Run* run)
+{
+    uint8 interrupts = CyEnterCriticalSection();
+    uint32 own = (CycleCounter_Read() - run->entry) - (Charged - run->charged);
+    Charged += own;
+    CyExitCriticalSection(interrupts);
+    return own;
+}
+
+void IsrBudget_TimerRun(uint32 cycles, uint16 delay)
+{
+    if (cycles > Longest.timer_cycles) Longest.timer_cycles = cycles;
+    if (delay > Longest.tick_delay) Longest.tick_delay = delay;
+}
+
+void IsrBudget_Read(IsrBudget_Stats* stats)
+{
+    uint8 interrupts = CyEnterCriticalSection();
+    stats->timer_cycles = Longest.timer_cycles;
+    stats->i2c_cycles = Longest.i2c_cycles;
+    stats->uart_cycles = Longest.uart_cycles;
+    stats->tick_delay = Longest.tick_delay;
+    Longest.timer_cycles = 0;
+    Longest.i2c_cycles = 0;
+    Longest.uart_cycles = 0;
+    Longest.tick_delay = 0;
+    CyExitCriticalSection(interrupts);
+}
+
+/* Record a run of an interrupt of the components. */
+static void IsrBudget_ComponentRun(const IsrBudget_Run* run, volatile uint32* longest)
+{
+    uint32 cycles = IsrBudget_Exit(run);
+    if (cycles > *longest) *longest = cycles;
+}
+
+static IsrBudget_Run I2cRun;
+
+void I2C_Master_ISR_EntryCallback(void)
+{
+    IsrBudget_Enter(&I2cRun);
+}
+
+void I2C_Master_ISR_ExitCallback(void)
+{
+    IsrBudget_ComponentRun(&I2cRun, &Longest.i2c_cycles);
+}
+
+static IsrBudget_Run UartTxRun;
+static IsrBudget_Run UartRxRun;
+
+void UART_Debug_TXISR_EntryCallback(void)
+{
+    IsrBudget_Enter(&UartTxRun);
+}
+
+void UART_Debug_TXISR_ExitCallback(void)
+{
+    IsrBudget_ComponentRun(&UartTxRun, &Longest.uart_cycles);
+}
+
+void UART_Debug_RXISR_EntryCallback(void)
+{
+    IsrBudget_Enter(&UartRxRun);
+}
+
+void UART_Debug_RXISR_ExitCallback(void)
+{
+    IsrBudget_ComponentRun(&UartRxRun, &Longest.uart_cycles);
+}
+
+#endif
+
+/* [] END OF FILE */
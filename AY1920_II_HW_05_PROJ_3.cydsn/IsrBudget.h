@@ -0,0 +1,95 @@
+/**
+*   \file IsrBudget.h
+*   \brief Priorities and timing of the interrupts.
+*
+*   This is an interface to set the priorities of isr_Timer, I2C_Master and
+*   UART_Debug from the configuration and, with ACQ_ISR_REPORT_TICKS, to
+*   time them: the longest run of each interrupt in cycles and the longest
+*   delay of the Timer interrupt from its terminal count. An interrupt
+*   preempted by another one is charged only its own cycles: each run adds
+*   its own cycles to a running total, and a run subtracts from its length
+*   what the total grew by meanwhile. The interrupts of the components are
+*   timed through the callbacks declared in cyapicallbacks.h.
+*/
+
+#ifndef __ISR_BUDGET_H
+    #define __ISR_BUDGET_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief Priority read back for an interrupt the design does not have.
+    */
+    #define ISR_BUDGET_NO_INTERRUPT 0xFF
+
+    /**
+    *   \brief Priorities of the Timer, I2C_Master and UART_Debug interrupts.
+    */
+    typedef struct {
+        uint8 timer;
+        uint8 i2c;
+        uint8 uart;                 ///< ISR_BUDGET_NO_INTERRUPT without a UART interrupt
+    } IsrBudget_Priorities;
+
+    /**
+    *   \brief Set the priorities of the configuration.
+    *
+    *   To be called in main after isr_Timer_StartEx() and I2C_Master_Start(),
+    *   which set the defaults of the components.
+    */
+    void IsrBudget_SetPriorities(void);
+
+    /**
+    *   \brief Read the priorities back from the interrupt controller.
+    */
+    void IsrBudget_GetPriorities(IsrBudget_Priorities* priorities);
+
+    #if ACQ_ISR_REPORT_TICKS > 0
+        /**
+        *   \brief Longest runs since the last read.
+        */
+        typedef struct {
+            uint32 timer_cycles;    ///< Timer interrupt, in cycles
+            uint32 i2c_cycles;      ///< I2C_Master interrupt, in cycles
+            uint32 uart_cycles;     ///< UART_Debug interrupts, in cycles
+            uint16 tick_delay;      ///< Timer terminal count to its interrupt, in Timer counts
+        } IsrBudget_Stats;
+
+        /**
+        *   \brief A run of an interrupt being timed.
+        */
+        typedef struct {
+            uint32 entry;           ///< Cycle counter at the entry
+            uint32 charged;         ///< Running total at the entry
+        } IsrBudget_Run;
+
+        /**
+        *   \brief Start timing a run, first thing in the interrupt.
+        */
+        void IsrBudget_Enter(IsrBudget_Run* run);
+
+        /**
+        *   \brief Stop timing a run, last thing in the interrupt.
+        *
+        *   \retval Returns the cycles of the run, without those of the
+        *   interrupts preempting it.
+        */
+        uint32 IsrBudget_Exit(const IsrBudget_Run* run);
+
+        /**
+        *   \brief Record a run of the Timer interrupt.
+        *
+        *   \param cycles Cycles returned by IsrBudget_Exit().
+        *   \param delay Timer counts elapsed since the terminal count at the entry.
+        */
+        void IsrBudget_TimerRun(uint32 cycles, uint16 delay);
+
+        /**
+        *   \brief Copy the longest runs and clear them for the next report.
+        */
+        void IsrBudget_Read(IsrBudget_Stats* stats);
+    #endif
+
+#endif
+/* [] END OF FILE */
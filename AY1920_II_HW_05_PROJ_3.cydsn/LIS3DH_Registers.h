@@ -0,0 +1,187 @@
+/**
+*   \file LIS3DH_Registers.h
+*   \brief Registers of the LIS3DH accelerometer.
+*
+*   This file collects the I2C address, the register addresses and the
+*   register values of the LIS3DH used by the acquisition, so that the
+*   modules that set or read the device share them with main.c.
+*/
+
+#ifndef __LIS3DH_REGISTERS_H
+    #define __LIS3DH_REGISTERS_H
+
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief 7-bit I2C address of the slave device.
+    */
+    #define LIS3DH_DEVICE_ADDRESS 0x18
+
+    /**
+    *   \brief Address of the WHO AM I register
+    */
+    #define LIS3DH_WHO_AM_I_REG_ADDR 0x0F
+    #define LIS3DH_WHO_AM_I_VALUE 0x33
+
+    /**
+    *   \brief Boot time of the LIS3DH after power-up ("about 5 milliseconds"),
+    *   first and longest wait between two polls of WHO_AM_I meanwhile, in us
+    */
+    #define LIS3DH_BOOT_MAX_US 5000
+    #define LIS3DH_BOOT_POLL_US 100
+    #define LIS3DH_BOOT_POLL_MAX_US 1000
+
+    /**
+    *   \brief Address of the Status register
+    */
+    #define LIS3DH_STATUS_REG 0x27
+    #define LIS3DH_STATUS_REG_NEW_VALUES ACQ_AXIS_MASK // New data on the enabled axes
+
+    /**
+    *   \brief Address of the Control register 1
+    */
+    #define LIS3DH_CTRL_REG1 0x20
+
+    /**
+    *   \brief Hex value to set normal mode 50Hz to the accelerator
+    */
+    #define LIS3DH_50Hz_NORMAL_MODE_CTRL_REG1 0x47
+
+    /**
+    *   \brief Hex value to set normal mode or high resolution mode at the acquisition ODR
+    */
+    #define LIS3DH_ACQ_CTRL_REG1 ACQ_CTRL_REG1
+    /**
+    *   \brief  Address of the Temperature Sensor Configuration register
+    */
+    #define LIS3DH_TEMP_CFG_REG 0x1F
+
+    #define LIS3DH_TEMP_CFG_REG_ACTIVE 0xC0
+    #define LIS3DH_TEMP_CFG_REG_NOT_ACTIVE 0x00 //Disable Temperature sensor reading
+
+    /**
+    *   \brief Address of the Control register 4
+    */
+    #define LIS3DH_CTRL_REG4 0x23
+
+
+    #define LIS3DH_CTRL_REG4_2G_NORMAL 0x00 // ± 2g FSR Normal Mode
+    #define LIS3DH_CTRL_REG4_4G_HIGH 0x18 // ± 4g FSR High Resolution Mode
+    #define LIS3DH_CTRL_REG4_HR 0x08 // High Resolution Mode, FSR in bits 5:4
+
+    /**
+    *   \brief Hex value to set the acquisition FSR in High Resolution Mode
+    */
+    #define LIS3DH_ACQ_CTRL_REG4 ACQ_CTRL_REG4
+
+    /**
+    *   \brief Address of the Control register 5
+    */
+    #define LIS3DH_CTRL_REG5 0x24
+    #define LIS3DH_CTRL_REG5_FIFO_EN 0x40 // Enable the FIFO
+    #define LIS3DH_CTRL_REG5_LIR_INT1 0x08 // Latch INT1_SRC until it is read
+
+    /**
+    *   \brief Address of the Control registers 2, 3 and 6
+    */
+    #define LIS3DH_CTRL_REG2 0x21
+    #define LIS3DH_CTRL_REG2_HP_CLICK 0x04 // High-pass filter on the click engine
+    #define LIS3DH_ACQ_CTRL_REG2 ACQ_CTRL_REG2
+
+    /**
+    *   \brief Address of the Reference register: reading it resets the high-pass filter
+    */
+    #define LIS3DH_REFERENCE 0x26
+
+    #define LIS3DH_CTRL_REG3 0x22
+    #define LIS3DH_CTRL_REG3_I1_IA1 0x40 // Interrupt generator 1 on the INT1 pin
+
+    #define LIS3DH_CTRL_REG6 0x25
+    #define LIS3DH_CTRL_REG6_I2_CLICK 0x80 // Click engine on the INT2 pin
+
+    /**
+    *   \brief Address of the Interrupt generator 1 registers
+    */
+    #define LIS3DH_INT1_CFG 0x30
+    #define LIS3DH_INT1_CFG_FREEFALL 0x95 // AND of the low events of X, Y and Z
+
+    #define LIS3DH_INT1_SRC 0x31
+    #define LIS3DH_INT1_THS 0x32
+    #define LIS3DH_INT1_DURATION 0x33
+
+    /**
+    *   \brief Address of the Click registers
+    */
+    #define LIS3DH_CLICK_CFG 0x38
+    #define LIS3DH_CLICK_CFG_SINGLE_XYZ 0x15 // Single click on X, Y and Z
+    #define LIS3DH_CLICK_CFG_DOUBLE_XYZ 0x2A // Double click on X, Y and Z
+
+    #define LIS3DH_CLICK_SRC 0x39
+    #define LIS3DH_CLICK_SRC_DCLICK 0x20 // Double click detected
+
+    #define LIS3DH_CLICK_THS 0x3A
+    #define LIS3DH_CLICK_THS_LIR 0x80 // Latch CLICK_SRC until it is read
+
+    #define LIS3DH_TIME_LIMIT 0x3B
+    #define LIS3DH_TIME_LATENCY 0x3C
+    #define LIS3DH_TIME_WINDOW 0x3D
+
+    #define LIS3DH_SRC_IA 0x40 // Interrupt active, in INT1_SRC and CLICK_SRC
+
+    /**
+    *   \brief Address of the FIFO Control and Source registers
+    */
+    #define LIS3DH_FIFO_CTRL_REG 0x2E
+    #define LIS3DH_FIFO_CTRL_REG_STREAM 0x80 // Stream mode: the oldest samples are overwritten when full
+
+    #define LIS3DH_FIFO_SRC_REG 0x2F
+    #define LIS3DH_FIFO_SRC_REG_OVRN 0x40 // FIFO full
+    #define LIS3DH_FIFO_SRC_REG_FSS 0x1F // Number of unread samples
+
+    /**
+    *   \brief Address of the Activity threshold and duration registers
+    */
+    #define LIS3DH_ACT_THS 0x3E
+    #define LIS3DH_ACT_DUR 0x3F
+
+    /**
+    *   \brief Address of the ADC output LSB register
+    */
+    #define LIS3DH_OUT_ADC_3L 0x0C
+
+    /**
+    *   \brief Address of the ADC output MSB register
+    */
+    #define LIS3DH_OUT_ADC_3H 0x0D
+
+    /**
+    *   \brief Address of the Accelerometer output LSB register
+    */
+    #define LIS3DH_OUT_X_L 0x28
+    #define LIS3DH_OUT_Y_L 0x2A
+    #define LIS3DH_OUT_Z_L 0x2C
+    /**
+    *   \brief Address of the Accelerometer output MSB register
+    */
+    #define LIS3DH_OUT_X_H 0x29
+    #define LIS3DH_OUT_Y_H 0x2B
+    #define LIS3DH_OUT_Z_H 0x2D
+
+    /*
+    *  Sensitivity Level
+    */
+
+    #define LIS3DH_SENS_2G 4 //Sensitivity for ± 2g FSR Normal Mode (mg/digit)
+    #define LIS3DH_SENS_4G 2 //Sensitivity for ± 4g FSR High Resolution Mode (mg/digit)
+    #define LIS3DH_SENS_2G_HIGH 1 //Sensitivity for ± 2g FSR High Resolution Mode (mg/digit)
+    #define LIS3DH_SENS_8G_HIGH 4 //Sensitivity for ± 8g FSR High Resolution Mode (mg/digit)
+    #define LIS3DH_SENS_16G_HIGH 12 //Sensitivity for ± 16g FSR High Resolution Mode (mg/digit)
+
+    /**
+    *   \brief Sensitivity of the given FS bits in High Resolution Mode (mg/digit)
+    */
+    #define LIS3DH_SENS_HIGH(fs) ((fs) == 0 ? LIS3DH_SENS_2G_HIGH : (fs) == 1 ? LIS3DH_SENS_4G : \
+                                  (fs) == 2 ? LIS3DH_SENS_8G_HIGH : LIS3DH_SENS_16G_HIGH)
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,79 @@
+/*
+* This file includes the polling of the click and free-fall engines.
+*/
+
+#include "MotionEvents.h"
+#include "I2C_Interface.h"
+#include "InterruptRoutines.h"
+#include "LIS3DH_Registers.h"
+#include "project.h"
+
+#if ACQ_EVENTS
+
+/*
+* Header of the event frames and events.
+*/
+#define EVENT_HEADER 0xA5
+#define EVENT_SINGLE_CLICK 1
+#define EVENT_DOUBLE_CLICK 2
+#define EVENT_FREE_FALL 3
+
+/*
+* Send the frame of an event: the event, the source register it was read
+* from and the Timer tick of the poll, 32-bit little endian.
+*/
+static void MotionEvents_Send(uint8_t event, uint8_t source)
+{
+    uint8_t frame[ACQ_EVENT_FRAME_SIZE];
+    uint32_t ticks = Timer_Ticks;
+
+    frame[0] = EVENT_HEADER;
+    frame[1] = event;
+    frame[2] = source;
+    frame[3] = (uint8_t)(ticks & 0xFF);
+    frame[4] = (uint8_t)((ticks >> 8) & 0xFF);
+    frame[5] = (uint8_t)((ticks >> 16) & 0xFF);
+    frame[6] = (uint8_t)(ticks >> 24);
+    frame[ACQ_EVENT_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_EVENT_FRAME_SIZE);
+}
+
+void MotionEvents_Init(MotionEvents* events)
+{
+    events->ticks = 0;
+    events->falling = 0;
+}
+
+void MotionEvents_Tick(MotionEvents* events)
+{
+    uint8_t source;
+
+    if (++events->ticks < ACQ_EVENT_POLL_TICKS)
+    {
+        return;
+    }
+    events->ticks = 0;
+#if ACQ_CLICK_MG > 0
+    if (I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_CLICK_SRC, &source) == NO_ERROR &&
+        (source & LIS3DH_SRC_IA))
+    {
+        MotionEvents_Send((source & LIS3DH_CLICK_SRC_DCLICK) ? EVENT_DOUBLE_CLICK : EVENT_SINGLE_CLICK,
+                          source);
+    }
+#endif
+#if ACQ_FREEFALL_MG > 0
+    if (I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_INT1_SRC, &source) == NO_ERROR)
+    {
+        // The latch is set again at each sample while the fall lasts: report its start only
+        if ((source & LIS3DH_SRC_IA) && !events->falling)
+        {
+            MotionEvents_Send(EVENT_FREE_FALL, source);
+        }
+        events->falling = (source & LIS3DH_SRC_IA) ? 1 : 0;
+    }
+#endif
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,38 @@
+/**
+*   \file MotionEvents.h
+*   \brief Click and free-fall events of the LIS3DH.
+*
+*   This file declares the polling of the click and free-fall engines of
+*   the LIS3DH, which are set at boot to latch their source registers. The
+*   sources are read every ACQ_EVENT_POLL_TICKS Timer ticks, which clears
+*   the latches, and each event is sent as a frame: header 0xA5, event (1
+*   single click, 2 double click, 3 free fall), source register, Timer
+*   tick of the poll (uint32), footer 0xC0.
+*/
+
+#ifndef __MOTION_EVENTS_H
+    #define __MOTION_EVENTS_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief State of the polling.
+    */
+    typedef struct {
+        uint8_t ticks;              ///< Timer ticks since the last poll
+        uint8_t falling;            ///< Set while a free fall lasts
+    } MotionEvents;
+
+    /**
+    *   \brief Start polling from the next tick.
+    */
+    void MotionEvents_Init(MotionEvents* events);
+
+    /**
+    *   \brief Count a Timer tick, polling the sources and sending the events when due.
+    */
+    void MotionEvents_Tick(MotionEvents* events);
+
+#endif
+/* [] END OF FILE */
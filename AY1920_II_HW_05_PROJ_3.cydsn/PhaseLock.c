@@ -0,0 +1,169 @@
+/*
+* This file includes the tick measurement and the phase-locked loop.
+*/
+
+#include "PhaseLock.h"
+
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+
+/*
+* Bus clock cycles per Timer count.
+*/
+#define PHASE_LOCK_CYCLES_PER_COUNT (ACQ_BUS_CLK_HZ / ACQ_TIMER_CLOCK_HZ)
+
+void PhaseLock_Init(PhaseLock* lock, uint16_t counts)
+{
+    lock->counts = counts;
+    lock->frequency = 0;
+    lock->remainder = 0;
+    lock->locked = 0;
+    lock->settling = 0;
+    lock->busy = 0;
+    lock->ready_ticks = 0;
+    lock->started = 0;
+    PhaseLock_ClearStats(lock);
+}
+
+void PhaseLock_Tick(PhaseLock* lock, uint32_t tick, uint32_t tick_cycles,
+                    uint16_t tick_delay, uint32_t now_cycles)
+{
+    uint32_t latency = now_cycles - tick_cycles;
+    int32_t deviation;
+
+    lock->stats.ticks++;
+    if (latency > lock->stats.latency_max)
+    {
+        lock->stats.latency_max = latency;
+    }
+    lock->busy = (lock->started && tick - lock->last_tick != 1);
+    if (lock->started && !lock->busy)
+    {
+        // The interval is the period plus the change of the interrupt delay
+        deviation = ((int32_t)tick_delay - lock->last_delay) * PHASE_LOCK_CYCLES_PER_COUNT;
+        if (deviation < lock->stats.interval_min)
+        {
+            lock->stats.interval_min = deviation;
+        }
+        if (deviation > lock->stats.interval_max)
+        {
+            lock->stats.interval_max = deviation;
+        }
+    }
+    else if (lock->started)
+    {
+        // Ticks the loop was too busy to see: no interval to measure
+        lock->stats.merged += (uint16_t)(tick - lock->last_tick - 1);
+    }
+    lock->started = 1;
+    lock->last_tick = tick;
+    lock->last_delay = tick_delay;
+}
+
+void PhaseLock_Count(PhaseLock* lock, PhaseLock_Outcome outcome)
+{
+    if (outcome == PHASE_LOCK_EARLY || outcome == PHASE_LOCK_EMPTY)
+    {
+        lock->stats.early++;
+    }
+    else if (outcome == PHASE_LOCK_OVERRUN)
+    {
+        lock->stats.overruns++;
+    }
+}
+
+uint16_t PhaseLock_Update(PhaseLock* lock, PhaseLock_Outcome outcome)
+{
+    int32_t limit = PHASE_LOCK_MAX_FREQUENCY(lock->counts);
+    int32_t step;
+    int32_t period;
+
+    PhaseLock_Count(lock, outcome);
+    if (lock->locked && outcome == PHASE_LOCK_EMPTY)
+    {
+        // A whole sample behind: the ticks run faster than the samples
+        lock->frequency += PHASE_LOCK_GAIN_SLIP;
+    }
+    else if (lock->locked && outcome == PHASE_LOCK_OVERRUN && !lock->busy)
+    {
+        // A whole sample ahead: the ticks run slower than the samples
+        lock->frequency -= PHASE_LOCK_GAIN_SLIP;
+    }
+
+    if (lock->settling)
+    {
+        // The correction of the early tick is loaded only now
+        lock->settling = 0;
+        step = 0;
+    }
+    else if (outcome == PHASE_LOCK_EARLY || outcome == PHASE_LOCK_EMPTY)
+    {
+        if (lock->locked)
+        {
+            lock->frequency += PHASE_LOCK_GAIN_EARLY;
+            step = PHASE_LOCK_STEP_EARLY;
+        }
+        else
+        {
+            // Just past the data-ready instant: undo the two steps in flight
+            lock->locked = 1;
+            step = 2 * PHASE_LOCK_STEP_ACQUIRE;
+        }
+        lock->ready_ticks = 0;
+        lock->settling = 1;
+    }
+    else
+    {
+        // Too long without an early tick: the ticks are far from the
+        // data-ready instants
+        if (lock->ready_ticks >= PHASE_LOCK_HOLD_TICKS)
+        {
+            lock->locked = 0;
+        }
+        else
+        {
+            lock->ready_ticks++;
+        }
+        if (lock->locked)
+        {
+            lock->frequency -= PHASE_LOCK_GAIN_READY;
+            step = -PHASE_LOCK_STEP_READY;
+        }
+        else
+        {
+            step = -PHASE_LOCK_STEP_ACQUIRE;
+        }
+    }
+    if (lock->frequency > limit)
+    {
+        lock->frequency = limit;
+    }
+    else if (lock->frequency < -limit)
+    {
+        lock->frequency = -limit;
+    }
+
+    period = (int32_t)lock->counts * 256 + lock->frequency + step + lock->remainder;
+    lock->remainder = period & 0xFF;
+    return (uint16_t)((period >> 8) - 1);
+}
+
+int16_t PhaseLock_DriftPpm(const PhaseLock* lock)
+{
+    // A longer period follows a slower LIS3DH
+    return (int16_t)(-(lock->frequency * 15625L) / (lock->counts * 4L));
+}
+
+void PhaseLock_ClearStats(PhaseLock* lock)
+{
+    lock->stats.ticks = 0;
+    lock->stats.merged = 0;
+    lock->stats.early = 0;
+    lock->stats.overruns = 0;
+    lock->stats.interval_min = INT32_MAX;
+    lock->stats.interval_max = INT32_MIN;
+    lock->stats.latency_max = 0;
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,153 @@
+/**
+*   \file PhaseLock.h
+*   \brief Timing of the Timer ticks against the samples of the LIS3DH.
+*
+*   This file declares the measurement of the Timer ticks, interval and
+*   delay of their service, and the loop that locks the ticks on the
+*   data-ready instants of the LIS3DH. The LIS3DH gives no data-ready
+*   instant to the firmware, only whether a new sample was there when the
+*   Status Register was read: the loop moves the ticks earlier by a small
+*   step at each tick that finds the sample, and later by a larger one at
+*   each tick that does not, so that they settle just after the data-ready
+*   instants and only one tick out of PHASE_LOCK_STEP_EARLY /
+*   PHASE_LOCK_STEP_READY finds no sample. An integral term follows the
+*   drift between the clock of the LIS3DH and the Timer clock, with a
+*   larger step when the phase slips by a whole sample: a tick finding no
+*   sample even by the last poll, or two samples while the loop was not
+*   busy.
+*
+*   Periods are handled in 1/256 of a Timer count and turned into whole
+*   counts carrying the remainder over to the next period.
+*/
+
+#ifndef __PHASE_LOCK_H
+    #define __PHASE_LOCK_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief Steps of the phase at a tick finding the sample (earlier)
+    *   and at a tick finding none (later), in 1/256 counts.
+    */
+    #define PHASE_LOCK_STEP_READY 16
+    #define PHASE_LOCK_STEP_EARLY 256
+
+    /**
+    *   \brief Step earlier while the lock is being acquired, in 1/256 counts.
+    */
+    #define PHASE_LOCK_STEP_ACQUIRE 2048
+
+    /**
+    *   \brief Steps of the integral term at a tick finding the sample and
+    *   at a tick finding none, in 1/256 counts.
+    */
+    #define PHASE_LOCK_GAIN_READY 1
+    #define PHASE_LOCK_GAIN_EARLY 16
+
+    /**
+    *   \brief Step of the integral term at a tick a whole sample away from
+    *   the last one, in 1/256 counts.
+    */
+    #define PHASE_LOCK_GAIN_SLIP 64
+
+    /**
+    *   \brief Ticks in a row finding the sample after which the lock is lost.
+    */
+    #define PHASE_LOCK_HOLD_TICKS 255
+
+    /**
+    *   \brief Largest integral term, in 1/256 counts (1/32 of the period).
+    */
+    #define PHASE_LOCK_MAX_FREQUENCY(counts) ((int32_t)(counts) * 8)
+
+    /**
+    *   \brief What the Status Register showed at a tick.
+    */
+    typedef enum {
+        PHASE_LOCK_READY,           ///< A new sample
+        PHASE_LOCK_EARLY,           ///< No new sample yet, one by the last poll
+        PHASE_LOCK_EMPTY,           ///< No new sample even by the last poll
+        PHASE_LOCK_OVERRUN          ///< A new sample that overwrote an unread one
+    } PhaseLock_Outcome;
+
+    /**
+    *   \brief Counters since the last report.
+    */
+    typedef struct {
+        uint16_t ticks;             ///< Ticks served
+        uint16_t merged;            ///< Ticks merged while the loop was busy
+        uint16_t early;             ///< Ticks that found no new sample
+        uint16_t overruns;          ///< Samples overwritten before being read
+        int32_t interval_min;       ///< Smallest deviation of a tick interval, in cycles (whole Timer counts)
+        int32_t interval_max;       ///< Largest deviation of a tick interval, in cycles (whole Timer counts)
+        uint32_t latency_max;       ///< Longest delay from the interrupt to the service, in cycles
+    } PhaseLock_Stats;
+
+    /**
+    *   \brief State of the measurement and of the loop.
+    */
+    typedef struct {
+        uint16_t counts;            ///< Nominal Timer counts per sample
+        int32_t frequency;          ///< Integral term of the period, in 1/256 counts
+        int32_t remainder;          ///< Fraction of a count carried over, in 1/256 counts
+        uint8_t locked;             ///< Set once a tick has found no sample
+        uint8_t settling;           ///< Set until the correction of an early tick is loaded
+        uint8_t busy;               ///< Set when the loop merged ticks before the last one
+        uint8_t ready_ticks;        ///< Ticks in a row that found the sample
+        uint8_t started;            ///< Set once a tick has been measured
+        uint32_t last_tick;         ///< Number of the last tick measured
+        uint16_t last_delay;        ///< Timer counts from its terminal count to its interrupt
+        PhaseLock_Stats stats;      ///< Counters since the last report
+    } PhaseLock;
+
+    /**
+    *   \brief Start with the given number of Timer counts per sample.
+    */
+    void PhaseLock_Init(PhaseLock* lock, uint16_t counts);
+
+    /**
+    *   \brief Measure a tick at the start of its service.
+    *
+    *   The interval from the previous tick is taken from the Timer counter,
+    *   which keeps running while the CPU is halted between the ticks, to
+    *   one Timer count; the cycle counter only times the service delay,
+    *   when the CPU is awake.
+    *
+    *   \param lock Measurement.
+    *   \param tick Number of the tick, as counted by the interrupt.
+    *   \param tick_cycles Cycle counter at the interrupt.
+    *   \param tick_delay Timer counts from the terminal count to the interrupt.
+    *   \param now_cycles Cycle counter at the service.
+    */
+    void PhaseLock_Tick(PhaseLock* lock, uint32_t tick, uint32_t tick_cycles,
+                        uint16_t tick_delay, uint32_t now_cycles);
+
+    /**
+    *   \brief Count what the Status Register showed at the first read of a tick.
+    */
+    void PhaseLock_Count(PhaseLock* lock, PhaseLock_Outcome outcome);
+
+    /**
+    *   \brief Count the outcome of a tick and correct the Timer period.
+    *
+    *   \retval Returns the Timer period, in counts minus one, to be written
+    *   for the next period. The Timer loads it at its next terminal count,
+    *   so that each correction shows one tick later: the tick following
+    *   an early one keeps the period.
+    */
+    uint16_t PhaseLock_Update(PhaseLock* lock, PhaseLock_Outcome outcome);
+
+    /**
+    *   \brief Drift of the LIS3DH clock from the Timer clock, in ppm
+    *   (positive when the LIS3DH runs fast).
+    */
+    int16_t PhaseLock_DriftPpm(const PhaseLock* lock);
+
+    /**
+    *   \brief Clear the counters for the next report.
+    */
+    void PhaseLock_ClearStats(PhaseLock* lock);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,162 @@
+/*
+* This file includes the full-scale switches of the LIS3DH.
+*/
+
+#include "RangeSwitch.h"
+#include "I2C_Interface.h"
+#include "LIS3DH_Registers.h"
+#include "project.h"
+
+#if ACQ_AUTO_RANGE
+
+/*
+* Header of the range markers.
+*/
+#define RANGE_MARKER_HEADER 0xA6
+
+static const uint8_t FullScaleG[AUTORANGE_RANGES] = {2, 4, 8, 16};
+static const uint8_t Sensitivity[AUTORANGE_RANGES] = {LIS3DH_SENS_HIGH(0), LIS3DH_SENS_HIGH(1),
+                                                      LIS3DH_SENS_HIGH(2), LIS3DH_SENS_HIGH(3)};
+#if ACQ_ADAPTIVE_ODR
+static const uint8_t ActThs[AUTORANGE_RANGES] = {ACQ_ACT_THS_AT(2), ACQ_ACT_THS_AT(4),
+                                                 ACQ_ACT_THS_AT(8), ACQ_ACT_THS_AT(16)};
+#endif
+#if ACQ_CLICK_MG > 0
+static const uint8_t ClickThs[AUTORANGE_RANGES] = {ACQ_CLICK_THS_AT(2), ACQ_CLICK_THS_AT(4),
+                                                   ACQ_CLICK_THS_AT(8), ACQ_CLICK_THS_AT(16)};
+#endif
+#if ACQ_FREEFALL_MG > 0
+static const uint8_t FreeFallThs[AUTORANGE_RANGES] = {ACQ_FREEFALL_THS_AT(2), ACQ_FREEFALL_THS_AT(4),
+                                                      ACQ_FREEFALL_THS_AT(8), ACQ_FREEFALL_THS_AT(16)};
+#endif
+
+/*
+* Set the FSR of the given range and the thresholds of the engines that
+* depend on it, then mark the switch in the stream with the full scale and
+* the sensitivity, 32-bit little endian.
+*/
+static ErrorCode RangeSwitch_Set(uint8_t range)
+{
+    uint8_t frame[ACQ_FRAME_SIZE] = {0};
+    ErrorCode error;
+#if ACQ_HPF
+    uint8_t reference;
+#endif
+
+    error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                         LIS3DH_CTRL_REG4,
+                                         LIS3DH_CTRL_REG4_HR | (range << 4));
+#if ACQ_HPF
+    if (error == NO_ERROR)
+    {
+        // Restart the high-pass filter from the acceleration at the new FSR
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_REFERENCE, &reference);
+    }
+#endif
+#if ACQ_ADAPTIVE_ODR
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_ACT_THS, ActThs[range]);
+    }
+#endif
+#if ACQ_CLICK_MG > 0
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_CLICK_THS,
+                                             LIS3DH_CLICK_THS_LIR | ClickThs[range]);
+    }
+#endif
+#if ACQ_FREEFALL_MG > 0
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_INT1_THS, FreeFallThs[range]);
+    }
+#endif
+
+    if (error == NO_ERROR)
+    {
+        frame[0] = RANGE_MARKER_HEADER;
+        frame[1] = FullScaleG[range];
+        frame[5] = Sensitivity[range];
+        frame[ACQ_FRAME_SIZE - 1] = 0xC0;
+        UART_Debug_PutArray(frame, ACQ_FRAME_SIZE);
+    }
+    return error;
+}
+
+void RangeSwitch_Init(RangeSwitch* range)
+{
+    uint8_t axis;
+
+    AutoRange_Init(&range->autorange, ACQ_CTRL_REG4_FS);
+    range->device = ACQ_CTRL_REG4_FS;
+    range->sensitivity = Sensitivity[ACQ_CTRL_REG4_FS];
+    range->hold = 0;
+    for (axis = 0; axis < 3; axis++)
+    {
+        range->last[axis] = 0;
+    }
+    RangeSwitch_Set(range->device); // Mark the starting FSR in the stream
+}
+
+void RangeSwitch_Add(RangeSwitch* range, int16_t sample[3])
+{
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (range->hold)
+        {
+            sample[axis] = range->last[axis]; // Sample taken while the FSR changed
+        }
+        range->last[axis] = sample[axis];
+    }
+    if (range->hold)
+    {
+        range->hold--;
+    }
+    else if (range->autorange.range == range->device)
+    {
+        AutoRange_Add(&range->autorange, sample);
+    }
+}
+
+void RangeSwitch_Update(RangeSwitch* range)
+{
+    ErrorCode error;
+#if ACQ_DECIMATION > 1
+    uint8_t fifo_src;
+#endif
+
+    if (range->autorange.range == range->device)
+    {
+        return;
+    }
+    error = RangeSwitch_Set(range->autorange.range);
+#if ACQ_DECIMATION > 1
+    // The samples still in the FIFO and the one being converted are held
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_FIFO_SRC_REG, &fifo_src);
+    }
+#endif
+    if (error == NO_ERROR)
+    {
+        range->device = range->autorange.range;
+        range->sensitivity = Sensitivity[range->device];
+#if ACQ_DECIMATION > 1
+        range->hold = 1 + ((fifo_src & LIS3DH_FIFO_SRC_REG_OVRN) ? 32 : (fifo_src & LIS3DH_FIFO_SRC_REG_FSS));
+#else
+        // The next sample may have been converted before the switch
+        range->hold = 1;
+#endif
+    }
+    else
+    {
+        AutoRange_Init(&range->autorange, range->device);
+    }
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,57 @@
+/**
+*   \file RangeSwitch.h
+*   \brief Full-scale switches of the LIS3DH during the acquisition.
+*
+*   This file declares the handling of the auto-ranging full scale around
+*   AutoRange, which only picks the range from the samples: the LIS3DH is
+*   moved to the range picked together with the thresholds of the engines
+*   that depend on it, every switch is marked in the stream and the
+*   samples taken while the range changes are replaced by the last one.
+*   A range marker is: header 0xA6, full scale in g as int32 in place of
+*   the X axis, sensitivity in mg/digit in place of Y, Z zero, footer 0xC0.
+*/
+
+#ifndef __RANGE_SWITCH_H
+    #define __RANGE_SWITCH_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+    #include "AutoRange.h"
+
+    /**
+    *   \brief Range selection and range of the device.
+    */
+    typedef struct {
+        AutoRange autorange;        ///< Range picked on the samples
+        uint8_t device;             ///< FS bits the LIS3DH is set to
+        uint8_t sensitivity;        ///< Sensitivity of the device range, in mg/digit
+        uint8_t hold;               ///< Samples still to be replaced by the last one
+        int16_t last[3];            ///< Last sample of each axis, in mg
+    } RangeSwitch;
+
+    /**
+    *   \brief Start from ACQ_FULL_SCALE_G and mark it in the stream.
+    */
+    void RangeSwitch_Init(RangeSwitch* range);
+
+    /**
+    *   \brief Add a sample of the three axes, in mg.
+    *
+    *   \param range Full-scale switches.
+    *   \param sample Sample read at the device range, replaced in place
+    *   by the last one if it was taken while the range changed.
+    */
+    void RangeSwitch_Add(RangeSwitch* range, int16_t sample[3]);
+
+    /**
+    *   \brief Move the LIS3DH to the range picked, if it changed.
+    *
+    *   To be called once the samples of a tick have been added: with
+    *   decimation the samples already in the FIFO are held as well. On an
+    *   I2C error the device keeps its range and the selection starts again
+    *   from it.
+    */
+    void RangeSwitch_Update(RangeSwitch* range);
+
+#endif
+/* [] END OF FILE */
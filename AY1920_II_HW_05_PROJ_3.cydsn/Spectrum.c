@@ -0,0 +1,274 @@
+/*
+* This file includes the fixed-point FFT and the reductions of its output:
+* band RMS values and spectral peaks.
+*/
+
+#include "Spectrum.h"
+
+/*
+*  Q15 sine over a period of SPECTRUM_MAX_POINTS, up to 3/4 of it: the
+*  cosine is read a quarter of a period ahead
+*/
+
+#define SPECTRUM_QUARTER (SPECTRUM_MAX_POINTS / 4)
+
+static const int16_t sine[SPECTRUM_MAX_POINTS * 3 / 4 + 1] = {
+         0,   402,   804,  1206,  1608,  2009,  2410,  2811,  3212,  3612,  4011,  4410,
+      4808,  5205,  5602,  5998,  6393,  6786,  7179,  7571,  7962,  8351,  8739,  9126,
+      9512,  9896, 10278, 10659, 11039, 11417, 11793, 12167, 12539, 12910, 13279, 13645,
+     14010, 14372, 14732, 15090, 15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869,
+     18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475, 20787, 21096, 21403, 21705,
+     22005, 22301, 22594, 22884, 23170, 23452, 23731, 24007, 24279, 24547, 24811, 25072,
+     25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019, 27245, 27466, 27683, 27896,
+     28105, 28310, 28510, 28706, 28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,
+     30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237, 31356, 31470, 31580, 31685,
+     31785, 31880, 31971, 32057, 32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567,
+     32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765, 32767, 32765, 32757, 32745,
+     32728, 32705, 32678, 32646, 32609, 32567, 32521, 32469, 32412, 32351, 32285, 32213,
+     32137, 32057, 31971, 31880, 31785, 31685, 31580, 31470, 31356, 31237, 31113, 30985,
+     30852, 30714, 30571, 30424, 30273, 30117, 29956, 29791, 29621, 29447, 29268, 29085,
+     28898, 28706, 28510, 28310, 28105, 27896, 27683, 27466, 27245, 27019, 26790, 26556,
+     26319, 26077, 25832, 25582, 25329, 25072, 24811, 24547, 24279, 24007, 23731, 23452,
+     23170, 22884, 22594, 22301, 22005, 21705, 21403, 21096, 20787, 20475, 20159, 19841,
+     19519, 19195, 18868, 18537, 18204, 17869, 17530, 17189, 16846, 16499, 16151, 15800,
+     15446, 15090, 14732, 14372, 14010, 13645, 13279, 12910, 12539, 12167, 11793, 11417,
+     11039, 10659, 10278,  9896,  9512,  9126,  8739,  8351,  7962,  7571,  7179,  6786,
+      6393,  5998,  5602,  5205,  4808,  4410,  4011,  3612,  3212,  2811,  2410,  2009,
+      1608,  1206,   804,   402,     0,  -402,  -804, -1206, -1608, -2009, -2410, -2811,
+     -3212, -3612, -4011, -4410, -4808, -5205, -5602, -5998, -6393, -6786, -7179, -7571,
+     -7962, -8351, -8739, -9126, -9512, -9896,-10278,-10659,-11039,-11417,-11793,-12167,
+    -12539,-12910,-13279,-13645,-14010,-14372,-14732,-15090,-15446,-15800,-16151,-16499,
+    -16846,-17189,-17530,-17869,-18204,-18537,-18868,-19195,-19519,-19841,-20159,-20475,
+    -20787,-21096,-21403,-21705,-22005,-22301,-22594,-22884,-23170,-23452,-23731,-24007,
+    -24279,-24547,-24811,-25072,-25329,-25582,-25832,-26077,-26319,-26556,-26790,-27019,
+    -27245,-27466,-27683,-27896,-28105,-28310,-28510,-28706,-28898,-29085,-29268,-29447,
+    -29621,-29791,-29956,-30117,-30273,-30424,-30571,-30714,-30852,-30985,-31113,-31237,
+    -31356,-31470,-31580,-31685,-31785,-31880,-31971,-32057,-32137,-32213,-32285,-32351,
+    -32412,-32469,-32521,-32567,-32609,-32646,-32678,-32705,-32728,-32745,-32757,-32765,
+    -32767
+};
+
+/*
+* Integer square root, rounded down and capped to 16 bits.
+*/
+static uint16_t Spectrum_Sqrt(uint64_t value)
+{
+    uint32_t remainder = value > UINT32_MAX ? UINT32_MAX : (uint32_t)value;
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > remainder)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (remainder >= root + bit)
+        {
+            remainder -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root > UINT16_MAX ? UINT16_MAX : (uint16_t)root;
+}
+
+/*
+* Undo the scaling of the samples on a squared value.
+*/
+static uint64_t Spectrum_Unscale(uint64_t power, int8_t scale)
+{
+    return scale >= 0 ? power >> (2 * scale) : power << (-2 * scale);
+}
+
+static uint32_t Spectrum_Power(const Spectrum_Complex* bin)
+{
+    return (uint32_t)((int32_t)bin->re * bin->re + (int32_t)bin->im * bin->im);
+}
+
+int8_t Spectrum_Transform(const int16_t* samples, uint16_t points, Spectrum_Complex* bins)
+{
+    uint16_t stride = SPECTRUM_MAX_POINTS / points;
+    int32_t sum = 0;
+    int32_t mean, x, peak = 0;
+    int8_t scale = 0;
+    uint16_t i, j, k, bit, half;
+
+    for (i = 0; i < points; i++)
+    {
+        sum += samples[i];
+    }
+    mean = (sum >= 0 ? sum + points / 2 : sum - points / 2) / (int32_t)points;
+
+    // Block floating point: bring the largest sample between 2^13 and 2^14,
+    // so that the magnitude of the data stays below 2^14 through the stages
+    for (i = 0; i < points; i++)
+    {
+        x = samples[i] - mean;
+        if (x < 0)
+        {
+            x = -x;
+        }
+        if (x > peak)
+        {
+            peak = x;
+        }
+    }
+    while (peak >= 1 << 14)
+    {
+        peak >>= 1;
+        scale--;
+    }
+    while (peak != 0 && peak < 1 << 13)
+    {
+        peak <<= 1;
+        scale++;
+    }
+
+    // Window the samples and store them in bit-reversed order
+    for (i = 0, j = 0; i < points; i++)
+    {
+        x = samples[i] - mean;
+        x = scale >= 0 ? x << scale : x >> -scale;
+
+        // Hann window: (1 - cos(2 pi i / points)) / 2, in Q15
+        k = (i <= points / 2 ? i : points - i) * stride;
+        x = (x * ((32768 - sine[k + SPECTRUM_QUARTER]) >> 1) + (1 << 14)) >> 15;
+
+        bins[j].re = (int16_t)x;
+        bins[j].im = 0;
+
+        for (bit = points >> 1; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j |= bit;
+    }
+
+    // Decimation in time: butterflies of 2 * half points, halved at each stage
+    for (half = 1; half < points; half <<= 1)
+    {
+        uint16_t step = SPECTRUM_MAX_POINTS / (2 * half);
+
+        for (k = 0; k < half; k++)
+        {
+            int32_t c = sine[k * step + SPECTRUM_QUARTER];
+            int32_t s = sine[k * step];
+
+            for (i = k; i < points; i += 2 * half)
+            {
+                Spectrum_Complex* a = &bins[i];
+                Spectrum_Complex* b = &bins[i + half];
+                // b * exp(-j 2 pi k / (2 * half))
+                int32_t tr = (b->re * c + b->im * s + (1 << 14)) >> 15;
+                int32_t ti = (b->im * c - b->re * s + (1 << 14)) >> 15;
+
+                b->re = (int16_t)((a->re - tr) >> 1);
+                b->im = (int16_t)((a->im - ti) >> 1);
+                a->re = (int16_t)((a->re + tr) >> 1);
+                a->im = (int16_t)((a->im + ti) >> 1);
+            }
+        }
+    }
+    return scale;
+}
+
+/*
+* The bins hold the transform divided by points. By Parseval, the mean
+* square of the block is twice the sum of the squared bins up to half the
+* sample rate, divided by the mean square of the Hann window (3/8).
+*/
+
+void Spectrum_Bands(const Spectrum_Complex* bins, uint16_t points, int8_t scale,
+                    uint16_t bands[SPECTRUM_BANDS])
+{
+    uint16_t width = points / (2 * SPECTRUM_BANDS);
+    uint16_t band, k;
+
+    for (band = 0; band < SPECTRUM_BANDS; band++)
+    {
+        uint64_t power = 0;
+
+        for (k = band * width; k < (band + 1) * width; k++)
+        {
+            if (k != 0)
+            {
+                power += Spectrum_Power(&bins[k]);
+            }
+        }
+        bands[band] = Spectrum_Sqrt(Spectrum_Unscale(power * 16 / 3, scale));
+    }
+}
+
+void Spectrum_Peaks(const Spectrum_Complex* bins, uint16_t points, int8_t scale,
+                    uint16_t rate_hz, uint16_t peaks[2 * SPECTRUM_PEAKS])
+{
+    uint32_t power[SPECTRUM_PEAKS] = {0};
+    uint16_t bin[SPECTRUM_PEAKS] = {0};
+    uint16_t k, p, q;
+
+    // Keep the strongest local maxima, sorted
+    for (k = 1; k < points / 2; k++)
+    {
+        uint32_t current = Spectrum_Power(&bins[k]);
+
+        if (current <= Spectrum_Power(&bins[k - 1]) || current < Spectrum_Power(&bins[k + 1]))
+        {
+            continue;
+        }
+        for (p = 0; p < SPECTRUM_PEAKS && power[p] >= current; p++)
+        {
+        }
+        if (p == SPECTRUM_PEAKS)
+        {
+            continue;
+        }
+        for (q = SPECTRUM_PEAKS - 1; q > p; q--)
+        {
+            power[q] = power[q - 1];
+            bin[q] = bin[q - 1];
+        }
+        power[p] = current;
+        bin[p] = k;
+    }
+
+    for (p = 0; p < SPECTRUM_PEAKS; p++)
+    {
+        if (power[p] == 0)
+        {
+            peaks[2 * p] = 0;
+            peaks[2 * p + 1] = 0;
+            continue;
+        }
+        k = bin[p];
+        uint32_t before = Spectrum_Power(&bins[k - 1]);
+        uint32_t after = Spectrum_Power(&bins[k + 1]);
+
+        // Parabola through the magnitudes of the three bins: the vertex is
+        // (after - before) / (2 (2 peak - before - after)) bins away
+        int32_t alpha = Spectrum_Sqrt(before);
+        int32_t beta = Spectrum_Sqrt(power[p]);
+        int32_t gamma = Spectrum_Sqrt(after);
+        int64_t den = 2 * (2 * beta - alpha - gamma);
+        int64_t num = gamma - alpha;
+
+        if (den <= 0)
+        {
+            den = 1;
+            num = 0;
+        }
+        int64_t frequency = ((int64_t)k * den + num) * rate_hz * 100;
+        peaks[2 * p] = (uint16_t)((frequency + (int64_t)points * den / 2) / ((int64_t)points * den));
+
+        // Amplitude from the power in the main lobe of the window, which
+        // does not depend on where the peak falls between the bins
+        uint64_t lobe = (uint64_t)before + power[p] + after;
+        peaks[2 * p + 1] = Spectrum_Sqrt(Spectrum_Unscale(lobe * 32 / 3, scale));
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,80 @@
+/**
+*   \file Spectrum.h
+*   \brief Fixed-point spectral analysis.
+*
+*   This file declares an in-place radix-2 FFT on 16-bit complex data and
+*   the reductions of its output sent in place of the time-domain data:
+*   the RMS value in equal-width frequency bands, or the strongest peaks.
+*
+*   Before the transform the block mean is removed, the samples are scaled
+*   by a power of two to use 14 bits (block floating point) and a Hann
+*   window is applied. Each stage halves its outputs, so the data never
+*   overflows; the scaling is undone when the bins are reduced.
+*/
+
+#ifndef __SPECTRUM_H
+    #define __SPECTRUM_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Largest number of points of the transform.
+    */
+    #define SPECTRUM_MAX_POINTS 512
+
+    /**
+    *   \brief Values produced by the reductions: SPECTRUM_BANDS bands, or
+    *   SPECTRUM_PEAKS pairs of frequency and amplitude.
+    */
+    #define SPECTRUM_VALUES 8
+    #define SPECTRUM_BANDS SPECTRUM_VALUES
+    #define SPECTRUM_PEAKS (SPECTRUM_VALUES / 2)
+
+    /**
+    *   \brief Complex sample.
+    */
+    typedef struct {
+        int16_t re;                 ///< Real part
+        int16_t im;                 ///< Imaginary part
+    } Spectrum_Complex;
+
+    /**
+    *   \brief Transform a block of real samples.
+    *
+    *   \param samples Block of samples.
+    *   \param points Number of samples: a power of two from 16 to SPECTRUM_MAX_POINTS.
+    *   \param bins Array of points elements where the transform will be saved.
+    *   \retval Returns the power of two the samples were scaled by.
+    */
+    int8_t Spectrum_Transform(const int16_t* samples, uint16_t points, Spectrum_Complex* bins);
+
+    /**
+    *   \brief RMS value of the block in SPECTRUM_BANDS bands of equal
+    *   width from 0 to half the sample rate, in the unit of the samples.
+    *   The DC bin is left out.
+    *
+    *   \param bins Transform of the block.
+    *   \param points Number of points of the transform.
+    *   \param scale Value returned by Spectrum_Transform.
+    *   \param bands Array where the value of each band will be saved.
+    */
+    void Spectrum_Bands(const Spectrum_Complex* bins, uint16_t points, int8_t scale,
+                        uint16_t bands[SPECTRUM_BANDS]);
+
+    /**
+    *   \brief The SPECTRUM_PEAKS strongest local maxima of the spectrum,
+    *   strongest first: frequency in hundredths of Hz, interpolated
+    *   between the bins, and peak amplitude in the unit of the samples.
+    *   Missing peaks are left to zero.
+    *
+    *   \param bins Transform of the block.
+    *   \param points Number of points of the transform.
+    *   \param scale Value returned by Spectrum_Transform.
+    *   \param rate_hz Sample rate of the block.
+    *   \param peaks Array where frequency and amplitude of each peak will be saved.
+    */
+    void Spectrum_Peaks(const Spectrum_Complex* bins, uint16_t points, int8_t scale,
+                        uint16_t rate_hz, uint16_t peaks[2 * SPECTRUM_PEAKS]);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,48 @@
+/*
+* This file includes the stack high-water probe, based on the stack
+* section of the PSoC Creator linker script.
+*/
+
+#include "StackProbe.h"
+
+/**
+*   \brief Words left unpainted below the frame of StackProbe_Paint.
+*/
+#define STACK_PROBE_MARGIN 16
+
+/**
+*   \brief Limit and top of the stack, defined by the linker script.
+*/
+extern int __cy_stack_limit;
+extern int __cy_stack;
+
+void StackProbe_Paint(void)
+{
+    volatile uint32 here;
+    uint32* word = (uint32*)&__cy_stack_limit;
+    uint32 end = (uint32)&here - STACK_PROBE_MARGIN * sizeof(uint32);
+
+    while ((uint32)word < end)
+    {
+        *word++ = STACK_PROBE_PATTERN;
+    }
+}
+
+uint32 StackProbe_Size(void)
+{
+    return (uint32)((const uint8*)&__cy_stack - (const uint8*)&__cy_stack_limit);
+}
+
+uint32 StackProbe_HighWater(void)
+{
+    const volatile uint32* word = (const volatile uint32*)&__cy_stack_limit;
+    const volatile uint32* top = (const volatile uint32*)&__cy_stack;
+
+    while (word < top && *word == STACK_PROBE_PATTERN)
+    {
+        word++;
+    }
+    return (uint32)((const volatile uint8*)top - (const volatile uint8*)word);
+}
+
+/* [] END OF FILE */
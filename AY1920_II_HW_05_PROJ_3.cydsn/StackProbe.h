@@ -0,0 +1,47 @@
+/**
+*   \file StackProbe.h
+*   \brief Stack high-water probe.
+*
+*   This is an interface to measure the stack actually used by the firmware:
+*   the free part of the stack is painted with a known pattern at boot and
+*   the deepest word overwritten since then gives the high-water mark. It
+*   covers the interrupts too, since they run on the same stack. The static
+*   worst case of the call graph is computed by the stack_report tool of
+*   HostSim from the listings of the build.
+*/
+
+#ifndef __STACK_PROBE_H
+    #define __STACK_PROBE_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Word painted on the free stack.
+    */
+    #define STACK_PROBE_PATTERN 0xA5A5A5A5u
+
+    /**
+    *   \brief Paint the stack from its limit up to just below the caller.
+    *
+    *   To be called first thing in main, before any interrupt is enabled:
+    *   what was stacked before the call stays out of the measurement.
+    */
+    void StackProbe_Paint(void);
+
+    /**
+    *   \brief Bytes reserved for the stack by the linker script.
+    */
+    uint32 StackProbe_Size(void);
+
+    /**
+    *   \brief Largest number of bytes of stack used since the paint.
+    *
+    *   The stack is scanned from its limit upwards, so that the cost grows
+    *   with the free stack: about one cycle per byte. A result equal to
+    *   StackProbe_Size() means that the stack reached its limit and may
+    *   have overflowed into the static variables below it.
+    */
+    uint32 StackProbe_HighWater(void);
+
+#endif
+/* [] END OF FILE */
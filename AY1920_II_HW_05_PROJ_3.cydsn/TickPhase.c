@@ -0,0 +1,125 @@
+/*
+* This file includes the phase lock and the phase reports of the
+* acquisition loop.
+*/
+
+#include "TickPhase.h"
+#include "CycleCounter.h"
+#include "I2C_Interface.h"
+#include "InterruptRoutines.h"
+#include "LIS3DH_Registers.h"
+#include "project.h"
+
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+
+/*
+* Header of the phase reports.
+*/
+#define PHASE_HEADER 0xAE
+
+#if ACQ_PHASE_REPORT_TICKS > 0
+/*
+* Send a phase report: counters of the ticks, drift of the LIS3DH clock,
+* range of the tick intervals and longest service delay. The range is
+* empty (smallest above largest) if no interval was measured.
+*/
+static void TickPhase_SendReport(const PhaseLock* lock)
+{
+    uint8_t frame[ACQ_PHASE_FRAME_SIZE];
+    const PhaseLock_Stats* stats = &lock->stats;
+    int16_t drift = ACQ_PHASE_LOCK ? PhaseLock_DriftPpm(lock) : 0;
+    uint8_t i;
+
+    frame[0] = PHASE_HEADER;
+    frame[1] = (uint8_t)(stats->ticks & 0xFF);
+    frame[2] = (uint8_t)(stats->ticks >> 8);
+    frame[3] = (uint8_t)(stats->merged & 0xFF);
+    frame[4] = (uint8_t)(stats->merged >> 8);
+    frame[5] = (uint8_t)(stats->early & 0xFF);
+    frame[6] = (uint8_t)(stats->early >> 8);
+    frame[7] = (uint8_t)(stats->overruns & 0xFF);
+    frame[8] = (uint8_t)(stats->overruns >> 8);
+    frame[9] = (uint8_t)(drift & 0xFF);
+    frame[10] = (uint8_t)((uint16_t)drift >> 8);
+    for (i = 0; i < 4; i++)
+    {
+        frame[11 + i] = (uint8_t)((uint32_t)stats->interval_min >> (8 * i));
+        frame[15 + i] = (uint8_t)((uint32_t)stats->interval_max >> (8 * i));
+        frame[19 + i] = (uint8_t)(stats->latency_max >> (8 * i));
+    }
+    frame[ACQ_PHASE_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_PHASE_FRAME_SIZE);
+}
+#endif
+
+void TickPhase_Init(TickPhase* phase)
+{
+#if ACQ_PHASE_LOCK
+    PhaseLock_Init(&phase->lock, ACQ_PHASE_LOCK_COUNTS);
+    Timer_WritePeriod(ACQ_PHASE_LOCK_COUNTS - 1); // One tick per sample from the next one
+#else
+    PhaseLock_Init(&phase->lock, ACQ_TIMER_PERIOD + 1);
+#endif
+    phase->report_ticks = 0;
+}
+
+void TickPhase_Start(TickPhase* phase)
+{
+    CyGlobalIntDisable; // Tick number, time and period of the same tick
+    PhaseLock_Tick(&phase->lock, Timer_Ticks, Timer_TickCycles, Timer_TickDelay, CycleCounter_Read());
+    CyGlobalIntEnable;
+}
+
+#if ACQ_DECIMATION == 1
+ErrorCode TickPhase_ReadStatus(TickPhase* phase, uint8_t tick, uint8_t* status)
+{
+    ErrorCode error;
+    PhaseLock_Outcome outcome;
+#if ACQ_PHASE_LOCK
+    uint8_t retries;
+#endif
+
+    error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_STATUS_REG, status);
+    if (!tick || error != NO_ERROR)
+    {
+        return error;
+    }
+    outcome = ((*status & LIS3DH_STATUS_REG_NEW_VALUES) != LIS3DH_STATUS_REG_NEW_VALUES) ? PHASE_LOCK_EARLY :
+              (*status & (LIS3DH_STATUS_REG_NEW_VALUES << 4)) ? PHASE_LOCK_OVERRUN : PHASE_LOCK_READY;
+#if ACQ_PHASE_LOCK
+    // The sample is due within a fraction of a count: each poll takes longer
+    for (retries = 0; retries < TICK_PHASE_RETRIES && error == NO_ERROR &&
+         (*status & LIS3DH_STATUS_REG_NEW_VALUES) != LIS3DH_STATUS_REG_NEW_VALUES; retries++)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_STATUS_REG, status);
+    }
+    if (outcome == PHASE_LOCK_EARLY &&
+        (error != NO_ERROR || (*status & LIS3DH_STATUS_REG_NEW_VALUES) != LIS3DH_STATUS_REG_NEW_VALUES))
+    {
+        outcome = PHASE_LOCK_EMPTY;
+    }
+    Timer_WritePeriod(PhaseLock_Update(&phase->lock, outcome));
+#else
+    PhaseLock_Count(&phase->lock, outcome);
+#endif
+    return error;
+}
+#endif
+
+void TickPhase_End(TickPhase* phase)
+{
+#if ACQ_PHASE_REPORT_TICKS > 0
+    if (++phase->report_ticks >= ACQ_PHASE_REPORT_TICKS)
+    {
+        phase->report_ticks = 0;
+        TickPhase_SendReport(&phase->lock);
+        PhaseLock_ClearStats(&phase->lock);
+    }
+#else
+    (void)phase;
+#endif
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/**
+*   \file TickPhase.h
+*   \brief Phase lock and phase reports of the acquisition loop.
+*
+*   This file declares the handling of the Timer ticks around PhaseLock,
+*   which only measures the ticks and computes the periods: each tick is
+*   measured at the start of its service from the Timer interrupt, without
+*   decimation the Status Register read at the tick tells the loop where
+*   the tick fell against the sample and, with ACQ_PHASE_LOCK, the next
+*   Timer period is written. With ACQ_PHASE_REPORT_TICKS a phase report is
+*   sent every ACQ_PHASE_REPORT_TICKS ticks (see AcquisitionConfig.h).
+*/
+
+#ifndef __TICK_PHASE_H
+    #define __TICK_PHASE_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+    #include "ErrorCodes.h"
+    #include "PhaseLock.h"
+
+    /**
+    *   \brief Status Register polls after a tick that came before the sample.
+    */
+    #define TICK_PHASE_RETRIES 2
+
+    /**
+    *   \brief Measurement, loop and reports.
+    */
+    typedef struct {
+        PhaseLock lock;             ///< Tick timing and phase of the ticks against the samples
+        uint16_t report_ticks;      ///< Timer ticks since the last phase report
+    } TickPhase;
+
+    /**
+    *   \brief Start measuring and, with ACQ_PHASE_LOCK, tick once per
+    *   sample from the next Timer period.
+    */
+    void TickPhase_Init(TickPhase* phase);
+
+    /**
+    *   \brief Measure a tick, first thing in its service.
+    */
+    void TickPhase_Start(TickPhase* phase);
+
+    #if ACQ_DECIMATION == 1
+        /**
+        *   \brief Read the Status Register, measuring the phase at a tick.
+        *
+        *   With ACQ_PHASE_LOCK a tick that finds no sample polls again up
+        *   to TICK_PHASE_RETRIES times, as the sample is due within a
+        *   fraction of a Timer count, and the period is corrected.
+        *
+        *   \param phase Measurement.
+        *   \param tick Set when the read serves a Timer tick.
+        *   \param status Where the Status Register is saved.
+        *   \retval Returns the outcome of the last read.
+        */
+        ErrorCode TickPhase_ReadStatus(TickPhase* phase, uint8_t tick, uint8_t* status);
+    #endif
+
+    /**
+    *   \brief Count a tick at the end of its service, sending the phase report when due.
+    */
+    void TickPhase_End(TickPhase* phase);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,133 @@
+/*
+* This file includes the event-triggered capture engine.
+*/
+
+#include "Trigger.h"
+
+#if ACQ_TRIGGER_MG > 0
+
+/*
+* Check whether a sample crosses the threshold: the magnitude of the
+* acceleration, or any of the axes, gravity included.
+*/
+static uint8_t Trigger_Crossed(const int16_t sample[3])
+{
+#if ACQ_TRIGGER_MAGNITUDE
+    uint32_t square = 0;
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        square += (uint32_t)((int32_t)sample[axis] * sample[axis]);
+    }
+    return square > (uint32_t)ACQ_TRIGGER_MG * ACQ_TRIGGER_MG;
+#else
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (sample[axis] > ACQ_TRIGGER_MG || sample[axis] < -ACQ_TRIGGER_MG)
+        {
+            return 1;
+        }
+    }
+    return 0;
+#endif
+}
+
+void Trigger_Init(Trigger* trigger)
+{
+    trigger->position = 0;
+    trigger->count = 0;
+    trigger->sent = 0;
+    trigger->state = TRIGGER_ARMING;
+}
+
+void Trigger_Add(Trigger* trigger, const int16_t sample[3])
+{
+    uint8_t axis;
+
+    if (trigger->state == TRIGGER_SENDING)
+    {
+        return;
+    }
+    for (axis = 0; axis < 3; axis++)
+    {
+        trigger->ring[trigger->position][axis] = sample[axis];
+    }
+    if (++trigger->position == TRIGGER_SAMPLES)
+    {
+        trigger->position = 0;
+    }
+    trigger->count++;
+
+    switch (trigger->state)
+    {
+        case TRIGGER_ARMING:
+            if (trigger->count >= TRIGGER_PRE_SAMPLES)
+            {
+                trigger->state = TRIGGER_ARMED;
+            }
+            break;
+        case TRIGGER_ARMED:
+            if (Trigger_Crossed(sample))
+            {
+                // The sample that crossed the threshold is the first post-trigger one
+                trigger->count = 1;
+                trigger->state = TRIGGER_CAPTURING;
+            }
+            break;
+        default:
+            break;
+    }
+    if (trigger->state == TRIGGER_CAPTURING && trigger->count >= TRIGGER_POST_SAMPLES)
+    {
+        // The ring now starts with the oldest pre-trigger sample
+        trigger->sent = 0;
+        trigger->state = TRIGGER_SENDING;
+    }
+}
+
+uint8_t Trigger_Read(Trigger* trigger, uint8_t packet[TRIGGER_PACKET_SIZE])
+{
+    int16_t index = (int16_t)trigger->sent - TRIGGER_PRE_SAMPLES;
+    uint16_t slot;
+    uint8_t s, axis;
+    uint8_t* data = &packet[3];
+
+    if (trigger->state != TRIGGER_SENDING)
+    {
+        return 0;
+    }
+    packet[0] = 0xA4;
+    packet[1] = (uint8_t)(index & 0xFF);
+    packet[2] = (uint8_t)((index >> 8) & 0xFF);
+
+    // Oldest sample first
+    for (s = 0; s < TRIGGER_PACKET_SAMPLES; s++)
+    {
+        slot = trigger->position + trigger->sent++;
+        if (slot >= TRIGGER_SAMPLES)
+        {
+            slot -= TRIGGER_SAMPLES;
+        }
+        for (axis = 0; axis < 3; axis++)
+        {
+            *data++ = (uint8_t)(trigger->ring[slot][axis] & 0xFF);
+            *data++ = (uint8_t)((trigger->ring[slot][axis] >> 8) & 0xFF);
+        }
+    }
+    packet[TRIGGER_PACKET_SIZE - 1] = 0xC0;
+
+    if (trigger->sent == TRIGGER_SAMPLES)
+    {
+        // Arm again once the pre-trigger samples have been renewed
+        trigger->count = 0;
+        trigger->state = TRIGGER_ARMING;
+    }
+    return 1;
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,81 @@
+/**
+*   \file Trigger.h
+*   \brief Event-triggered capture.
+*
+*   This file declares a capture engine that keeps the last samples of the
+*   three axes in a circular buffer and watches them against a threshold.
+*   When the threshold is crossed, it goes on collecting the post-trigger
+*   samples and then hands out the whole capture as a burst of packets of
+*   TRIGGER_PACKET_SAMPLES samples each:
+*
+*   header 0xA4, index of the first sample of the packet (int16), X, Y and
+*   Z of each sample as int16, footer 0xC0.
+*
+*   The index counts from the sample that crossed the threshold, so the
+*   pre-trigger samples have negative indexes. Each packet is a frame of
+*   its own and can be sent between the other frames of the stream. While
+*   the burst is being sent no sample is stored; the engine is armed again
+*   once the pre-trigger part of the buffer has been filled with new ones.
+*/
+
+#ifndef __TRIGGER_H
+    #define __TRIGGER_H
+
+    #include "cytypes.h"
+    #include "AcquisitionConfig.h"
+
+    /**
+    *   \brief Samples kept before and after the trigger.
+    */
+    #define TRIGGER_PRE_SAMPLES ACQ_TRIGGER_PRE_SAMPLES
+    #define TRIGGER_POST_SAMPLES ACQ_TRIGGER_POST_SAMPLES
+    #define TRIGGER_SAMPLES (TRIGGER_PRE_SAMPLES + TRIGGER_POST_SAMPLES)
+
+    /**
+    *   \brief Samples and bytes of a packet of the burst.
+    */
+    #define TRIGGER_PACKET_SAMPLES 4
+    #define TRIGGER_PACKET_SIZE (4 + 6 * TRIGGER_PACKET_SAMPLES)
+
+    /**
+    *   \brief State of the capture engine.
+    */
+    typedef enum {
+        TRIGGER_ARMING,             ///< Filling the pre-trigger samples
+        TRIGGER_ARMED,              ///< Watching the threshold
+        TRIGGER_CAPTURING,          ///< Collecting the post-trigger samples
+        TRIGGER_SENDING             ///< Handing out the packets of the burst
+    } Trigger_State;
+
+    /**
+    *   \brief Circular buffer and state of the capture engine.
+    */
+    typedef struct {
+        int16_t ring[TRIGGER_SAMPLES][3];   ///< Last samples of X, Y and Z
+        uint16_t position;                  ///< Next slot of the ring, oldest sample
+        uint16_t count;                     ///< Samples stored in the current state
+        uint16_t sent;                      ///< Samples of the burst handed out
+        Trigger_State state;                ///< Current state
+    } Trigger;
+
+    /**
+    *   \brief Empty the buffer and start arming.
+    */
+    void Trigger_Init(Trigger* trigger);
+
+    /**
+    *   \brief Add a sample of the three axes.
+    */
+    void Trigger_Add(Trigger* trigger, const int16_t sample[3]);
+
+    /**
+    *   \brief Build the next packet of the burst of a completed capture.
+    *
+    *   \param trigger Capture engine.
+    *   \param packet Array where the packet will be saved.
+    *   \retval Returns 1 when a packet has been built, 0 when there is no burst to send.
+    */
+    uint8_t Trigger_Read(Trigger* trigger, uint8_t packet[TRIGGER_PACKET_SIZE]);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/*
+* This file includes the windowed statistics engine.
+*/
+
+#include "WindowStats.h"
+
+/*
+* Integer square root, rounded down.
+*/
+static uint32_t WindowStats_Sqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static void WindowStats_Restart(WindowStats* stats)
+{
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        stats->axis[axis].sum = 0;
+        stats->axis[axis].sum_squares = 0;
+        stats->axis[axis].min = INT16_MAX;
+        stats->axis[axis].max = INT16_MIN;
+    }
+    stats->count = 0;
+}
+
+void WindowStats_Init(WindowStats* stats, uint16_t length)
+{
+    stats->length = length;
+    WindowStats_Restart(stats);
+}
+
+uint8_t WindowStats_Add(WindowStats* stats, const int16_t sample[3])
+{
+    uint8_t axis;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        WindowStats_Axis* a = &stats->axis[axis];
+        int16_t x = sample[axis];
+
+        a->sum += x;
+        a->sum_squares += (uint32_t)((int32_t)x * x);
+        if (x < a->min)
+        {
+            a->min = x;
+        }
+        if (x > a->max)
+        {
+            a->max = x;
+        }
+    }
+    return ++stats->count >= stats->length;
+}
+
+void WindowStats_Summarize(WindowStats* stats, WindowStats_Summary summary[3])
+{
+    uint8_t axis;
+    uint16_t count = stats->count ? stats->count : 1;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        const WindowStats_Axis* a = &stats->axis[axis];
+        WindowStats_Summary* s = &summary[axis];
+        int32_t sum = a->sum;
+
+        // Round the mean to the nearest integer, away from zero on ties
+        s->mean = (int16_t)((sum >= 0 ? sum + count / 2 : sum - count / 2) / count);
+        s->rms = (uint16_t)WindowStats_Sqrt((uint32_t)((a->sum_squares + count / 2) / count));
+        s->min = stats->count ? a->min : 0;
+        s->max = stats->count ? a->max : 0;
+        s->peak_to_peak = (uint16_t)(s->max - s->min);
+
+        // Crest factor: the largest absolute sample over the RMS
+        int32_t peak = s->max > -s->min ? s->max : -s->min;
+        uint32_t crest = s->rms ? ((uint32_t)peak << 8) / s->rms : 0;
+        s->crest_q8 = crest > UINT16_MAX ? UINT16_MAX : (uint16_t)crest;
+    }
+    WindowStats_Restart(stats);
+}
+
+/* [] END OF FILE */
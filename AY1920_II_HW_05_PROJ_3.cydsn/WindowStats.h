@@ -0,0 +1,68 @@
+/**
+*   \file WindowStats.h
+*   \brief Windowed statistics of the acceleration.
+*
+*   This file declares a statistics engine that summarizes the samples of
+*   the three axes over fixed-length windows: mean, RMS, minimum, maximum,
+*   peak-to-peak and crest factor. Only sums and extremes are updated for
+*   each sample; the summary is computed once per window, in fixed point.
+*/
+
+#ifndef __WINDOW_STATS_H
+    #define __WINDOW_STATS_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Running sums and extremes of one axis.
+    */
+    typedef struct {
+        int32_t sum;                ///< Sum of the samples
+        uint64_t sum_squares;       ///< Sum of the squared samples
+        int16_t min;                ///< Smallest sample
+        int16_t max;                ///< Largest sample
+    } WindowStats_Axis;
+
+    /**
+    *   \brief State of the statistics of the three axes.
+    */
+    typedef struct {
+        WindowStats_Axis axis[3];   ///< X, Y and Z
+        uint16_t count;             ///< Samples in the current window
+        uint16_t length;            ///< Samples per window
+    } WindowStats;
+
+    /**
+    *   \brief Summary of one axis over a window, in the unit of the samples.
+    */
+    typedef struct {
+        int16_t mean;               ///< Mean value
+        uint16_t rms;               ///< Root mean square
+        int16_t min;                ///< Smallest sample
+        int16_t max;                ///< Largest sample
+        uint16_t peak_to_peak;      ///< Difference between max and min
+        uint16_t crest_q8;          ///< Largest absolute sample over RMS, Q8
+    } WindowStats_Summary;
+
+    /**
+    *   \brief Start the first window.
+    *   \param stats Statistics to be initialized.
+    *   \param length Number of samples per window.
+    */
+    void WindowStats_Init(WindowStats* stats, uint16_t length);
+
+    /**
+    *   \brief Add a sample of the three axes to the current window.
+    *   \retval Returns 1 when the window is complete, 0 otherwise.
+    */
+    uint8_t WindowStats_Add(WindowStats* stats, const int16_t sample[3]);
+
+    /**
+    *   \brief Summarize the current window and start the next one.
+    *   \param stats Statistics of the window.
+    *   \param summary Array where the summary of the X, Y and Z axes will be saved.
+    */
+    void WindowStats_Summarize(WindowStats* stats, WindowStats_Summary summary[3]);
+
+#endif
+/* [] END OF FILE */
@@ -16,6 +16,25 @@
     /*Define your macro callbacks here */
     /*For more information, refer to the Writing Code topic in the PSoC Creator Help.*/
 
+    #include "AcquisitionConfig.h"
+
+    #if ACQ_ISR_REPORT_TICKS > 0
+        /* Timing of the component interrupts, in IsrBudget.c */
+        #define I2C_Master_ISR_ENTRY_CALLBACK
+        void I2C_Master_ISR_EntryCallback(void);
+        #define I2C_Master_ISR_EXIT_CALLBACK
+        void I2C_Master_ISR_ExitCallback(void);
+
+        #define UART_Debug_TXISR_ENTRY_CALLBACK
+        void UART_Debug_TXISR_EntryCallback(void);
+        #define UART_Debug_TXISR_EXIT_CALLBACK
+        void UART_Debug_TXISR_ExitCallback(void);
+        #define UART_Debug_RXISR_ENTRY_CALLBACK
+        void UART_Debug_RXISR_EntryCallback(void);
+        #define UART_Debug_RXISR_EXIT_CALLBACK
+        void UART_Debug_RXISR_ExitCallback(void);
+    #endif
+
     
 #endif /* CYAPICALLBACKS_H */   
 /* [] */
@@ -10,96 +10,730 @@
 */
 
 // Include required header files
+#include "AcquisitionConfig.h"
+#include "Calibration.h"
+#include "ClockProfile.h"
+#include "CycleCounter.h"
+#include "StackProbe.h"
+#include "DebugText.h"
+#include "Decimator.h"
+#include "FlashLog.h"
 #include "I2C_Interface.h"
+#include "IsrBudget.h"
 #include "InterruptRoutines.h"
+#include "LIS3DH_Registers.h"
+#include "MotionEvents.h"
 #include "project.h"
-#include "stdio.h"
+#include "RangeSwitch.h"
+#include "Spectrum.h"
+#include "TickPhase.h"
+#include "Trigger.h"
+#include "WindowStats.h"
 
-/**
-*   \brief 7-bit I2C address of the slave device.
+/*
+*  Conversion factor to m/s^2
 */
-#define LIS3DH_DEVICE_ADDRESS 0x18
 
-/**
-*   \brief Address of the WHO AM I register
+#define G_TO_ACC 9.80665 //   1g = 9.80665 m/s^2
+
+/*
+*  Header of the frame marking a change of the data rate: the new rate in Hz
+*  follows as int32 in place of the X axis, Y and Z are zero.
 */
-#define LIS3DH_WHO_AM_I_REG_ADDR 0x0F
 
-/**
-*   \brief Address of the Status register
+#define RATE_MARKER_HEADER 0xA1
+
+/*
+*  Header of the frame with the statistics of a window
 */
-#define LIS3DH_STATUS_REG 0x27
-#define LIS3DH_STATUS_REG_NEW_VALUES 0x07
 
-/**
-*   \brief Address of the Control register 1
+#define STATS_HEADER 0xA2
+
+/*
+*  Header of the frame with the spectrum of one axis
 */
-#define LIS3DH_CTRL_REG1 0x20
 
-/**
-*   \brief Hex value to set normal mode 50Hz to the accelerator
+#define SPECTRUM_HEADER 0xA3
+
+/*
+*  Header of the data frames when not all the axes are enabled or the
+*  fields are narrow: the mode byte follows, then the enabled axes. Offset
+*  of the first axis in the data frames.
 */
-#define LIS3DH_50Hz_NORMAL_MODE_CTRL_REG1 0x47
 
-/**
-*   \brief Hex value to set normal mode or high resolution mode  100Hz to the accelerator
+#define MASKED_FRAME_HEADER 0xA7
+#define FRAME_DATA_OFFSET (ACQ_FRAME_MODE == 0x07 ? 1 : 2)
+
+/*
+*  Header of the calibration frames and states they report
 */
-#define LIS3DH_100Hz_CTRL_REG1 0x57
-/**
-*   \brief  Address of the Temperature Sensor Configuration register
+
+#define CALIBRATION_HEADER 0xA8
+#define CALIBRATION_STATE_DEFAULT 0 // Unit gains and no offsets
+#define CALIBRATION_STATE_LOADED 1 // Coefficients loaded from the EEPROM
+#define CALIBRATION_STATE_MEASURED 2 // Position measured, others missing
+#define CALIBRATION_STATE_STORED 3 // New coefficients stored in the EEPROM
+#define CALIBRATION_STATE_NOT_STORED 4 // New coefficients in use but not stored
+
+/*
+*  Header of the frames of the flash log dump, and divider of the
+*  UART_Debug clock at the dump baud rate (8 clocks per bit)
 */
-#define LIS3DH_TEMP_CFG_REG 0x1F
 
-#define LIS3DH_TEMP_CFG_REG_ACTIVE 0xC0
-#define LIS3DH_TEMP_CFG_REG_NOT_ACTIVE 0x00 //Disable Temperature sensor reading
+#define LOG_HEADER 0xA9
+#define LOG_DUMP_DIVIDER ((ACQ_BUS_CLK_HZ + 4L * ACQ_LOG_DUMP_BAUD) / (8L * ACQ_LOG_DUMP_BAUD))
 
-/**
-*   \brief Address of the Control register 4
+/*
+*  Header of the boot record, its flags and the time it carries when no
+*  sample is expected
 */
-#define LIS3DH_CTRL_REG4 0x23
 
+#define BOOT_HEADER 0xAA
+#define BOOT_WHO_AM_I_OK 0x01 // WHO_AM_I as expected
+#define BOOT_REGISTERS_OK 0x02 // Registers read back as written
+#define BOOT_FAST 0x80 // Fast boot
+#define BOOT_NO_SAMPLE 0xFFFFFFFFu
+
+/*
+*  Header of the status records, code of a device found on the I2C bus
+*  and status of an I2C error
+*/
 
-#define LIS3DH_CTRL_REG4_2G_NORMAL 0x00 // ± 2g FSR Normal Mode
-#define LIS3DH_CTRL_REG4_4G_HIGH 0x18 // ± 4g FSR High Resolution Mode
+#define STATUS_HEADER 0xAB
+#define STATUS_DEVICE 0x80
+#define STATUS_I2C_ERROR 0x01
 
-/**
-*   \brief Address of the ADC output LSB register
+/*
+*  Header of the profile frames
 */
-#define LIS3DH_OUT_ADC_3L 0x0C
 
-/**
-*   \brief Address of the ADC output MSB register
+#define PROFILE_HEADER 0xAC
+
+/*
+*  Header of the stack reports
 */
-#define LIS3DH_OUT_ADC_3H 0x0D
 
-/**
-*   \brief Address of the Accelerometer output LSB register
+#define STACK_HEADER 0xAD
+
+/*
+*  Header of the interrupt reports
 */
-#define LIS3DH_OUT_X_L 0x28
-#define LIS3DH_OUT_Y_L 0x2A
-#define LIS3DH_OUT_Z_L 0x2C
-/**
-*   \brief Address of the Accelerometer output MSB register
+
+#define ISR_HEADER 0xAF
+
+/*
+*  Check whether an axis is enabled
 */
-#define LIS3DH_OUT_X_H 0x29
-#define LIS3DH_OUT_Y_H 0x2B
-#define LIS3DH_OUT_Z_H 0x2D
+
+#define AXIS_ENABLED(axis) (ACQ_AXIS_MASK & (1 << (axis)))
 
 /*
-*  Sensitivity Level
+* Save an axis in mm/s^2 in the data frame, 32-bit little endian or, with
+* narrow frames, 16-bit saturated. Returns the number of bytes saved.
 */
+static ACQ_RAMFUNC uint8_t PackAxis(uint8_t* field, int16_t mg)
+{
+    int32 value = (int32)(mg*G_TO_ACC); // Convert the Accelerometer Data from mg to mm/s^2
+    
+#if ACQ_NARROW_FRAMES
+    if (value > INT16_MAX)
+    {
+        value = INT16_MAX;
+    }
+    else if (value < -INT16_MAX)
+    {
+        value = -INT16_MAX;
+    }
+    field[0] = (uint8_t)(value & 0xFF);
+    field[1] = (uint8_t)((value >> 8)&0xFF);
+    return 2;
+#else
+    /*Save data in 4 int8 array to cover the int32 sensibility*/
+    field[0] = (uint8_t)(value & 0xFF);
+    field[1] = (uint8_t)((value >> 8)&0xFF);
+    field[2] = (uint8_t)((value >> 16)&0xFF);
+    field[3] = (uint8_t)(value >> 24);
+    return 4;
+#endif
+}
 
-#define LIS3DH_SENS_2G 4 //Sensitivity for ± 2g FSR Normal Mode (mg/digit)
-#define LIS3DH_SENS_4G 2 //Sensitivity for ± 4g FSR High Resolution Mode (mg/digit)
+_Static_assert(ACQ_TIMER_PERIOD == Timer_INIT_PERIOD,
+               "ACQ_TIMER_PERIOD does not match the Timer period set in the TopDesign");
 
+#if ACQ_STATS_WINDOW_MS > 0
 /*
-*  Conversion factor to m/s^2
+* Add a sample in mg to the window statistics and, when the window is
+* complete, send the summary frame: mean, RMS, min, max and crest factor
+* (Q8) of each axis as 16-bit little endian values. The peak-to-peak
+* value is left out, as it is max - min.
 */
+static void SendStatistics(WindowStats* stats, const int16_t sample[3])
+{
+    WindowStats_Summary summary[3];
+    uint8_t frame[ACQ_STATS_FRAME_SIZE];
+    uint16_t values[5];
+    uint8_t axis, i;
+    
+    if (!WindowStats_Add(stats, sample))
+    {
+        return;
+    }
+    WindowStats_Summarize(stats, summary);
+    
+    frame[0] = STATS_HEADER;
+    for (axis = 0; axis < 3; axis++)
+    {
+        values[0] = (uint16_t)summary[axis].mean;
+        values[1] = summary[axis].rms;
+        values[2] = (uint16_t)summary[axis].min;
+        values[3] = (uint16_t)summary[axis].max;
+        values[4] = summary[axis].crest_q8;
+        for (i = 0; i < 5; i++)
+        {
+            frame[1 + 10 * axis + 2 * i] = (uint8_t)(values[i] & 0xFF);
+            frame[2 + 10 * axis + 2 * i] = (uint8_t)(values[i] >> 8);
+        }
+    }
+    frame[ACQ_STATS_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_STATS_FRAME_SIZE);
+}
+#endif
 
-#define G_TO_ACC 9.80665 //   1g = 9.80665 m/s^2
+#if ACQ_FFT_POINTS > 0
+/*
+*  Blocks of samples of each axis and their transform, kept out of the stack
+*/
+
+static int16_t FftBlock[3][ACQ_FFT_POINTS];
+static Spectrum_Complex FftBins[ACQ_FFT_POINTS];
+static uint16_t FftCount;
+
+/*
+* Add a sample in mg to the block and, when the block is complete,
+* transform each axis and send its frame: band RMS values, or frequency
+* and amplitude of the peaks, as 16-bit little endian values.
+*/
+static void SendSpectrum(const int16_t sample[3])
+{
+    uint8_t frame[ACQ_FFT_FRAME_SIZE];
+    uint16_t values[SPECTRUM_VALUES];
+    int8_t scale;
+    uint8_t axis, i;
+    
+    for (axis = 0; axis < 3; axis++)
+    {
+        FftBlock[axis][FftCount] = sample[axis];
+    }
+    if (++FftCount < ACQ_FFT_POINTS)
+    {
+        return;
+    }
+    FftCount = 0;
+    
+    frame[0] = SPECTRUM_HEADER;
+    frame[ACQ_FFT_FRAME_SIZE - 1] = 0xC0;
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (!AXIS_ENABLED(axis))
+        {
+            continue;
+        }
+        scale = Spectrum_Transform(FftBlock[axis], ACQ_FFT_POINTS, FftBins);
+#if ACQ_FFT_PEAKS
+        Spectrum_Peaks(FftBins, ACQ_FFT_POINTS, scale, ACQ_OUTPUT_HZ, values);
+#else
+        Spectrum_Bands(FftBins, ACQ_FFT_POINTS, scale, values);
+#endif
+        frame[1] = axis;
+        for (i = 0; i < SPECTRUM_VALUES; i++)
+        {
+            frame[2 + 2 * i] = (uint8_t)(values[i] & 0xFF);
+            frame[3 + 2 * i] = (uint8_t)(values[i] >> 8);
+        }
+        UART_Debug_PutArray(frame, ACQ_FFT_FRAME_SIZE);
+    }
+}
+#endif
+
+#if ACQ_CALIBRATION
+/*
+* Send the frame of the calibration: state, positions measured, offsets
+* and gains of the three axes, 16-bit little endian.
+*/
+static void SendCalibration(const Calibration* calibration, uint8_t state)
+{
+    uint8_t frame[ACQ_CALIBRATION_FRAME_SIZE];
+    uint8_t axis;
+    
+    frame[0] = CALIBRATION_HEADER;
+    frame[1] = state;
+    frame[2] = calibration->measured;
+    for (axis = 0; axis < 3; axis++)
+    {
+        frame[3 + 2 * axis] = (uint8_t)(calibration->coefficients.offset[axis] & 0xFF);
+        frame[4 + 2 * axis] = (uint8_t)((calibration->coefficients.offset[axis] >> 8) & 0xFF);
+        frame[9 + 2 * axis] = (uint8_t)(calibration->coefficients.gain[axis] & 0xFF);
+        frame[10 + 2 * axis] = (uint8_t)(calibration->coefficients.gain[axis] >> 8);
+    }
+    frame[ACQ_CALIBRATION_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_CALIBRATION_FRAME_SIZE);
+}
+
+/*
+* Add an uncorrected sample to the measure in progress, if any: new
+* coefficients are stored at once and reported with the outcome.
+*/
+static void MeasureCalibration(Calibration* calibration, const int16_t sample[3])
+{
+    switch (Calibration_Add(calibration, sample))
+    {
+        case CALIBRATION_MEASURED:
+            SendCalibration(calibration, CALIBRATION_STATE_MEASURED);
+            break;
+        case CALIBRATION_UPDATED:
+            SendCalibration(calibration, (Calibration_Save(calibration) == NO_ERROR) ?
+                            CALIBRATION_STATE_STORED : CALIBRATION_STATE_NOT_STORED);
+            break;
+        default:
+            break;
+    }
+}
+#endif
+
+#if ACQ_TRIGGER_MG > 0
+/*
+*  Ring of the event-triggered capture, kept out of the stack
+*/
+
+static Trigger Capture;
+
+_Static_assert(TRIGGER_PACKET_SIZE == ACQ_TRIGGER_PACKET_SIZE,
+               "ACQ_TRIGGER_PACKET_SIZE does not match the packets of the Trigger");
+#endif
+
+#if ACQ_LOG
+/*
+*  Flash log, kept out of the stack with the row being filled
+*/
+
+static FlashLog Log;
+
+_Static_assert(ACQ_LOG_FRAME_SIZE == 4 + CY_FLASH_SIZEOF_ROW,
+               "ACQ_LOG_FRAME_SIZE does not match the rows of the FlashLog");
+_Static_assert(LOG_DUMP_DIVIDER >= 1 && LOG_DUMP_DIVIDER <= 0x10000 &&
+               50L * (ACQ_BUS_CLK_HZ / (8L * LOG_DUMP_DIVIDER) - ACQ_LOG_DUMP_BAUD) <= ACQ_LOG_DUMP_BAUD &&
+               50L * (ACQ_LOG_DUMP_BAUD - ACQ_BUS_CLK_HZ / (8L * LOG_DUMP_DIVIDER)) <= ACQ_LOG_DUMP_BAUD,
+               "ACQ_LOG_DUMP_BAUD cannot be obtained within 2% from the bus clock");
+
+/*
+* Wait for the UART to send the bytes already queued, the one in the
+* shift register included.
+*/
+static void WaitUartIdle(void)
+{
+    while (UART_Debug_GetTxBufferSize() != 0)
+    {
+    }
+    CyDelayUs(ACQ_UART_BITS_PER_BYTE * 1000000L / ACQ_UART_BAUD + 1);
+}
+
+/*
+* Send all the rows of the flash log, oldest first, at the dump baud
+* rate: header, rows still to come (uint16), the row, footer. The row
+* being filled is programmed first; an empty log is sent as a blank row.
+*/
+static void DumpLog(FlashLog* log)
+{
+    static const uint8_t blank[CY_FLASH_SIZEOF_ROW] = {0};
+    uint8_t head[3];
+    const uint8_t* data;
+    uint16 divider = UART_Debug_IntClock_GetDividerRegister();
+    uint16_t rows, row = 0;
+    
+    FlashLog_Flush(log);
+    rows = FlashLog_Rows(log);
+    
+    // Give the host the time to follow the switch
+    WaitUartIdle();
+    UART_Debug_IntClock_SetDividerRegister(LOG_DUMP_DIVIDER - 1, 1);
+    CyDelay(ACQ_LOG_DUMP_PAUSE_MS);
+    do
+    {
+        data = (rows > 0) ? FlashLog_Row(log, row) : blank;
+        head[0] = LOG_HEADER;
+        head[1] = (uint8_t)((rows > row) ? (rows - row - 1) & 0xFF : 0);
+        head[2] = (uint8_t)((rows > row) ? (rows - row - 1) >> 8 : 0);
+        UART_Debug_PutArray(head, 3);
+        UART_Debug_PutArray(data, CY_FLASH_SIZEOF_ROW / 2);
+        UART_Debug_PutArray(&data[CY_FLASH_SIZEOF_ROW / 2], CY_FLASH_SIZEOF_ROW / 2);
+        UART_Debug_PutChar(0xC0);
+    } while (++row < rows);
+    WaitUartIdle();
+    UART_Debug_IntClock_SetDividerRegister(divider, 1);
+    CyDelay(ACQ_LOG_DUMP_PAUSE_MS);
+}
+#endif
+
+#if !ACQ_FAST_BOOT
+/*
+* Send a status record: register address, value and status. Nothing is
+* sent when the diagnostics are text.
+*/
+static void ReportStatus(uint8_t address, uint8_t value, uint8_t status)
+{
+#if !ACQ_TEXT_DIAGNOSTICS
+    uint8_t frame[ACQ_STATUS_FRAME_SIZE];
+    
+    frame[0] = STATUS_HEADER;
+    frame[1] = address;
+    frame[2] = value;
+    frame[3] = status;
+    frame[ACQ_STATUS_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_STATUS_FRAME_SIZE);
+#else
+    (void)address;
+    (void)value;
+    (void)status;
+#endif
+}
+
+/*
+* Send a piece of a line of text, only when the diagnostics are text.
+*/
+static void ReportText(const char* text)
+{
+#if ACQ_TEXT_DIAGNOSTICS
+    UART_Debug_PutString(text);
+#else
+    (void)text;
+#endif
+}
+
+/*
+* Report a register: the label followed by the value in hexadecimal, or a
+* status record.
+*/
+static void ReportRegister(const char* label, uint8_t address, uint8_t value)
+{
+#if ACQ_TEXT_DIAGNOSTICS
+    char text[DEBUG_TEXT_HEX_SIZE];
+    
+    (void)address;
+    DebugText_Hex(text, value);
+    UART_Debug_PutString(label);
+    UART_Debug_PutString(text);
+#else
+    (void)label;
+    ReportStatus(address, value, 0);
+#endif
+}
+
+/*
+* Report an I2C error on a register: the message, or a status record.
+*/
+static void ReportError(const char* message, uint8_t address)
+{
+    ReportText(message);
+    ReportStatus(address, 0, STATUS_I2C_ERROR);
+}
+
+#if ACQ_HPF || ACQ_DECIMATION > 1 || ACQ_BENCHMARK
+/*
+* Send an integer in decimal, only when the diagnostics are text.
+*/
+static void ReportDecimal(int32_t value)
+{
+#if ACQ_TEXT_DIAGNOSTICS
+    char text[DEBUG_TEXT_DECIMAL_SIZE];
+    
+    DebugText_Decimal(text, value);
+    UART_Debug_PutString(text);
+#else
+    (void)value;
+#endif
+}
+#endif
+#endif
+
+#if ACQ_BENCHMARK && !ACQ_FAST_BOOT
+/*
+* Time 64 runs of the sample encoder and of a read of the output
+* registers, and report the mean and the spread (slowest minus fastest)
+* of each: the spread shows the wait states and cache misses of the
+* placement, flash or SRAM.
+*/
+static void BenchmarkHotPath(void)
+{
+    uint8_t field[4];
+    uint8_t data[6];
+    uint32 start, cycles, total, fastest, slowest;
+    uint8_t part, run;
+    
+    for (part = 0; part < 2; part++)
+    {
+        total = 0;
+        fastest = 0xFFFFFFFFu;
+        slowest = 0;
+        for (run = 0; run < 64; run++)
+        {
+            start = CycleCounter_Read();
+            if (part == 0)
+            {
+                PackAxis(field, (int16_t)(run * 64 - 2048));
+            }
+            else
+            {
+                I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS, LIS3DH_OUT_X_L, 6, data);
+            }
+            cycles = CycleCounter_Read() - start;
+            total += cycles;
+            fastest = (cycles < fastest) ? cycles : fastest;
+            slowest = (cycles > slowest) ? cycles : slowest;
+        }
+        ReportText((part == 0) ? "ENCODER: " : "6-BYTE READ: ");
+        ReportDecimal((int32_t)(total / 64));
+        ReportText(" cycles mean, ");
+        ReportDecimal((int32_t)(slowest - fastest));
+        ReportText(ACQ_RAM_HOT_PATH ? " spread (SRAM)\r\n" : " spread (flash)\r\n");
+    }
+}
+#endif
+
+/*
+* Send the boot record: WHO_AM_I, flags and time from the start of main()
+* to the first sample in us.
+*/
+static void SendBootRecord(uint8_t who_am_i, uint8_t flags, uint32 us)
+{
+    uint8_t frame[ACQ_BOOT_FRAME_SIZE];
+    
+    frame[0] = BOOT_HEADER;
+    frame[1] = who_am_i;
+    frame[2] = flags;
+    frame[3] = (uint8_t)(us & 0xFF);
+    frame[4] = (uint8_t)((us >> 8) & 0xFF);
+    frame[5] = (uint8_t)((us >> 16) & 0xFF);
+    frame[6] = (uint8_t)(us >> 24);
+    frame[ACQ_BOOT_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_BOOT_FRAME_SIZE);
+}
+
+/*
+* Poll WHO_AM_I until the LIS3DH acknowledges it at the end of its boot,
+* doubling the wait between two polls, for LIS3DH_BOOT_MAX_US at most.
+* Returns the outcome of the last read.
+*/
+static ErrorCode WaitBoot(uint8_t* who_am_i)
+{
+    uint16_t wait_us = LIS3DH_BOOT_POLL_US;
+    uint16_t waited_us = 0;
+    ErrorCode error;
+    
+    for (;;)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                            LIS3DH_WHO_AM_I_REG_ADDR,
+                                            who_am_i);
+        if (error == NO_ERROR || waited_us >= LIS3DH_BOOT_MAX_US)
+        {
+            return error;
+        }
+        CyDelayUs(wait_us);
+        waited_us += wait_us;
+        wait_us = (2 * wait_us > LIS3DH_BOOT_POLL_MAX_US) ? LIS3DH_BOOT_POLL_MAX_US : 2 * wait_us;
+    }
+}
+
+#if ACQ_PROFILE
+/*
+* Send a profile frame: ticks served, mean and worst cycles per tick,
+* samples read and cycles elapsed since the previous frame, bus clock.
+*/
+static void SendProfile(uint16_t ticks, uint32 mean, uint32 worst, uint16_t samples, uint32 window)
+{
+    uint8_t frame[ACQ_PROFILE_FRAME_SIZE];
+    uint8_t i;
+    
+    frame[0] = PROFILE_HEADER;
+    frame[1] = (uint8_t)(ticks & 0xFF);
+    frame[2] = (uint8_t)(ticks >> 8);
+    frame[11] = (uint8_t)(samples & 0xFF);
+    frame[12] = (uint8_t)(samples >> 8);
+    for (i = 0; i < 4; i++)
+    {
+        frame[3 + i] = (uint8_t)(mean >> (8 * i));
+        frame[7 + i] = (uint8_t)(worst >> (8 * i));
+        frame[13 + i] = (uint8_t)(window >> (8 * i));
+    }
+    frame[17] = (uint8_t)ACQ_BUS_CLK_MHZ;
+    frame[ACQ_PROFILE_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_PROFILE_FRAME_SIZE);
+}
+#endif
+
+#if ACQ_STACK_REPORT_TICKS > 0
+/*
+* Send a stack report: bytes reserved for the stack and high-water mark.
+*/
+static void SendStackReport(void)
+{
+    uint8_t frame[ACQ_STACK_FRAME_SIZE];
+    uint32 size = StackProbe_Size();
+    uint32 used = StackProbe_HighWater();
+    
+    frame[0] = STACK_HEADER;
+    frame[1] = (uint8_t)(size & 0xFF);
+    frame[2] = (uint8_t)(size >> 8);
+    frame[3] = (uint8_t)(used & 0xFF);
+    frame[4] = (uint8_t)(used >> 8);
+    frame[ACQ_STACK_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_STACK_FRAME_SIZE);
+}
+#endif
+
+#if ACQ_ISR_REPORT_TICKS > 0
+/*
+* Send an interrupt report: longest run of each interrupt, saturated to
+* 16 bits, longest delay of the Timer interrupt and priorities in use.
+*/
+static void SendIsrReport(void)
+{
+    uint8_t frame[ACQ_ISR_FRAME_SIZE];
+    IsrBudget_Stats stats;
+    IsrBudget_Priorities priorities;
+    uint32_t values[4];
+    uint8_t i;
+    
+    IsrBudget_Read(&stats);
+    IsrBudget_GetPriorities(&priorities);
+    values[0] = stats.timer_cycles;
+    values[1] = stats.i2c_cycles;
+    values[2] = stats.uart_cycles;
+    values[3] = (uint32_t)stats.tick_delay * 1000000 / ACQ_TIMER_CLOCK_HZ;
+    
+    frame[0] = ISR_HEADER;
+    for (i = 0; i < 4; i++)
+    {
+        uint16_t value = (values[i] > 0xFFFF) ? 0xFFFF : (uint16_t)values[i];
+        frame[1 + 2 * i] = (uint8_t)(value & 0xFF);
+        frame[2 + 2 * i] = (uint8_t)(value >> 8);
+    }
+    frame[9] = priorities.timer;
+    frame[10] = priorities.i2c;
+    frame[11] = priorities.uart;
+    frame[ACQ_ISR_FRAME_SIZE - 1] = 0xC0;
+    UART_Debug_PutArray(frame, ACQ_ISR_FRAME_SIZE);
+}
+#endif
+
+#if ACQ_FAST_BOOT
+/*
+*  Registers from TEMP_CFG_REG to CTRL_REG6, written in one burst
+*/
+
+static const uint8_t BootRegisters[] = {
+    LIS3DH_TEMP_CFG_REG_NOT_ACTIVE,
+    LIS3DH_ACQ_CTRL_REG1,
+    LIS3DH_ACQ_CTRL_REG2,
+    (ACQ_FREEFALL_MG > 0) ? LIS3DH_CTRL_REG3_I1_IA1 : 0,
+    LIS3DH_ACQ_CTRL_REG4,
+    ((ACQ_DECIMATION > 1) ? LIS3DH_CTRL_REG5_FIFO_EN : 0) | ((ACQ_FREEFALL_MG > 0) ? LIS3DH_CTRL_REG5_LIR_INT1 : 0),
+    (ACQ_CLICK_MG > 0) ? LIS3DH_CTRL_REG6_I2_CLICK : 0,
+};
+
+/*
+*  Registers of the enabled features, written one at a time after the
+*  burst: the FIFO mode last but one, so that the high-pass filter starts
+*  before the FIFO collects any sample
+*/
+
+static const uint8_t BootSettings[][2] = {
+    {LIS3DH_FIFO_CTRL_REG, (ACQ_DECIMATION > 1) ? LIS3DH_FIFO_CTRL_REG_STREAM : 0},
+#if ACQ_ADAPTIVE_ODR
+    {LIS3DH_ACT_THS, ACQ_ACT_THS},
+    {LIS3DH_ACT_DUR, ACQ_ACT_DUR},
+#endif
+#if ACQ_CLICK_MG > 0
+    {LIS3DH_CLICK_CFG, ACQ_CLICK_DOUBLE ? LIS3DH_CLICK_CFG_DOUBLE_XYZ : LIS3DH_CLICK_CFG_SINGLE_XYZ},
+    {LIS3DH_CLICK_THS, LIS3DH_CLICK_THS_LIR | ACQ_CLICK_THS},
+    {LIS3DH_TIME_LIMIT, ACQ_CLICK_TIME_LIMIT},
+    {LIS3DH_TIME_LATENCY, ACQ_CLICK_TIME_LATENCY},
+    {LIS3DH_TIME_WINDOW, ACQ_CLICK_TIME_WINDOW},
+#endif
+#if ACQ_FREEFALL_MG > 0
+    {LIS3DH_INT1_THS, ACQ_FREEFALL_THS},
+    {LIS3DH_INT1_DURATION, ACQ_FREEFALL_DURATION},
+    {LIS3DH_INT1_CFG, LIS3DH_INT1_CFG_FREEFALL},
+#endif
+};
+
+/*
+* If WHO_AM_I, as read by WaitBoot, is the expected one, set the LIS3DH
+* up and read the burst back. Returns the flags of the boot record.
+*/
+static uint8_t FastBoot(uint8_t who_am_i)
+{
+    uint8_t readback[sizeof(BootRegisters)];
+    uint8_t flags = BOOT_FAST;
+    uint8_t i;
+    ErrorCode error;
+    
+    if (who_am_i != LIS3DH_WHO_AM_I_VALUE)
+    {
+        return flags;
+    }
+    flags |= BOOT_WHO_AM_I_OK;
+    
+    error = I2C_Peripheral_WriteRegisterMulti(LIS3DH_DEVICE_ADDRESS,
+                                              LIS3DH_TEMP_CFG_REG,
+                                              sizeof(BootRegisters),
+                                              BootRegisters);
+#if ACQ_HPF
+    // Start the high-pass filter from the current acceleration
+    uint8_t reference;
+    
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                            LIS3DH_REFERENCE,
+                                            &reference);
+    }
+#endif
+    for (i = 0; i < sizeof(BootSettings) / sizeof(BootSettings[0]) && error == NO_ERROR; i++)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                             BootSettings[i][0],
+                                             BootSettings[i][1]);
+    }
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS,
+                                                 LIS3DH_TEMP_CFG_REG,
+                                                 sizeof(readback),
+                                                 readback);
+    }
+    if (error == NO_ERROR)
+    {
+        // The first byte read is saved last
+        for (i = 0; i < sizeof(BootRegisters) && readback[sizeof(readback) - 1 - i] == BootRegisters[i]; i++)
+        {
+        }
+        if (i == sizeof(BootRegisters))
+        {
+            flags |= BOOT_REGISTERS_OK;
+        }
+    }
+    return flags;
+}
+#endif
 
 int main(void)
 {
+#if ACQ_STACK_REPORT_TICKS > 0
+    StackProbe_Paint(); // Before the interrupts start using the stack
+#endif
+    ClockProfile_Apply(); // Before the components start
+    CycleCounter_Start(); // Time the boot from here
     CyGlobalIntEnable; /* Enable global interrupts. */
 
     /* Initialization of I2C and UART communication*/
@@ -108,20 +742,33 @@ int main(void)
     /* Initialization of Timer and Timer ISR*/
     Timer_Start();
     isr_Timer_StartEx(Custom_Timer_ISR);
+    IsrBudget_SetPriorities(); // Over the defaults set by the components
     
-    CyDelay(5); //"The boot procedure is complete about 5 milliseconds after device power-up."
+    uint8_t who_am_i_reg = 0; // WHO_AM_I, for the boot record
+    uint8_t BootFlags; // Outcome of the boot, for the boot record
+    uint8_t BootPending = 1; // Flag set until the boot record is sent
+    
+    //"The boot procedure is complete about 5 milliseconds after device power-up."
+    ErrorCode error = WaitBoot(&who_am_i_reg);
+    
+#if ACQ_FAST_BOOT
+    BootFlags = FastBoot(who_am_i_reg);
+    if (!(BootFlags & BOOT_WHO_AM_I_OK))
+    {
+        SendBootRecord(who_am_i_reg, BootFlags, BOOT_NO_SAMPLE);
+        BootPending = 0;
+    }
+#else
+    BootFlags = 0;
     
-    // String to print out messages on the UART
-    char message[50];
-
     // Check which devices are present on the I2C bus
     for (int i = 0 ; i < 128; i++)
     {
         if (I2C_Peripheral_IsDeviceConnected(i))
         {
             // print out the address is hex format
-            sprintf(message, "Device 0x%02X is connected\r\n", i);
-            UART_Debug_PutString(message); 
+            ReportRegister("Device ", STATUS_DEVICE, i);
+            ReportText(" is connected\r\n");
         }
         
     }
@@ -130,19 +777,16 @@ int main(void)
     /*            I2C Reading                 */
     /******************************************/
     
-    /* Read WHO AM I REGISTER register */
-    uint8_t who_am_i_reg;
-    ErrorCode error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
-                                                  LIS3DH_WHO_AM_I_REG_ADDR, 
-                                                  &who_am_i_reg);
+    /* WHO AM I REGISTER register, as read at the end of the boot */
     if (error == NO_ERROR)
     {
-        sprintf(message, "WHO AM I REG: 0x%02X [Expected: 0x33]\r\n", who_am_i_reg);
-        UART_Debug_PutString(message); 
+        BootFlags |= (who_am_i_reg == LIS3DH_WHO_AM_I_VALUE) ? BOOT_WHO_AM_I_OK : 0;
+        ReportRegister("WHO AM I REG: ", LIS3DH_WHO_AM_I_REG_ADDR, who_am_i_reg);
+        ReportText(" [Expected: 0x33]\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm\r\n");   
+        ReportError("Error occurred during I2C comm\r\n", LIS3DH_WHO_AM_I_REG_ADDR);
     }
     
     /*      I2C Reading Status Register       */
@@ -154,12 +798,12 @@ int main(void)
     
     if (error == NO_ERROR)
     {
-        sprintf(message, "STATUS REGISTER: 0x%02X\r\n", status_register);
-        UART_Debug_PutString(message); 
+        ReportRegister("STATUS REGISTER: ", LIS3DH_STATUS_REG, status_register);
+        ReportText("\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read status register\r\n");   
+        ReportError("Error occurred during I2C comm to read status register\r\n", LIS3DH_STATUS_REG);
     }
     
     /******************************************/
@@ -172,12 +816,12 @@ int main(void)
     
     if (error == NO_ERROR)
     {
-        sprintf(message, "CONTROL REGISTER 1: 0x%02X\r\n", ctrl_reg1);
-        UART_Debug_PutString(message); 
+        ReportRegister("CONTROL REGISTER 1: ", LIS3DH_CTRL_REG1, ctrl_reg1);
+        ReportText("\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read control register 1\r\n");   
+        ReportError("Error occurred during I2C comm to read control register 1\r\n", LIS3DH_CTRL_REG1);
     }
     
     /******************************************/
@@ -185,11 +829,11 @@ int main(void)
     /******************************************/
     
         
-    UART_Debug_PutString("\r\nWriting new values..\r\n");
+    ReportText("\r\nWriting new values..\r\n");
     
-    if (ctrl_reg1 != LIS3DH_100Hz_CTRL_REG1)
+    if (ctrl_reg1 != LIS3DH_ACQ_CTRL_REG1)
     {
-        ctrl_reg1 = LIS3DH_100Hz_CTRL_REG1;
+        ctrl_reg1 = LIS3DH_ACQ_CTRL_REG1;
     
         error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
                                              LIS3DH_CTRL_REG1,
@@ -197,12 +841,12 @@ int main(void)
     
         if (error == NO_ERROR)
         {
-            sprintf(message, "CONTROL REGISTER 1 successfully written as: 0x%02X\r\n", ctrl_reg1);
-            UART_Debug_PutString(message); 
+            ReportRegister("CONTROL REGISTER 1 successfully written as: ", LIS3DH_CTRL_REG1, ctrl_reg1);
+            ReportText("\r\n");
         }
         else
         {
-            UART_Debug_PutString("Error occurred during I2C comm to set control register 1\r\n");   
+            ReportError("Error occurred during I2C comm to set control register 1\r\n", LIS3DH_CTRL_REG1);
         }
     }
     
@@ -216,12 +860,13 @@ int main(void)
     
     if (error == NO_ERROR)
     {
-        sprintf(message, "CONTROL REGISTER 1 after overwrite operation: 0x%02X\r\n", ctrl_reg1);
-        UART_Debug_PutString(message); 
+        BootFlags |= (ctrl_reg1 == LIS3DH_ACQ_CTRL_REG1) ? BOOT_REGISTERS_OK : 0;
+        ReportRegister("CONTROL REGISTER 1 after overwrite operation: ", LIS3DH_CTRL_REG1, ctrl_reg1);
+        ReportText("\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read control register 1\r\n");   
+        ReportError("Error occurred during I2C comm to read control register 1\r\n", LIS3DH_CTRL_REG1);
     }
     
      /******************************************/
@@ -236,12 +881,12 @@ int main(void)
     
     if (error == NO_ERROR)
     {
-        sprintf(message, "TEMPERATURE CONFIG REGISTER: 0x%02X\r\n", tmp_cfg_reg);
-        UART_Debug_PutString(message); 
+        ReportRegister("TEMPERATURE CONFIG REGISTER: ", LIS3DH_TEMP_CFG_REG, tmp_cfg_reg);
+        ReportText("\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read temperature config register\r\n");   
+        ReportError("Error occurred during I2C comm to read temperature config register\r\n", LIS3DH_TEMP_CFG_REG);
     }
     
     
@@ -256,14 +901,18 @@ int main(void)
                                         &tmp_cfg_reg);
     
     
+    if (error != NO_ERROR || tmp_cfg_reg != LIS3DH_TEMP_CFG_REG_NOT_ACTIVE)
+    {
+        BootFlags &= ~BOOT_REGISTERS_OK;
+    }
     if (error == NO_ERROR)
     {
-        sprintf(message, "TEMPERATURE CONFIG REGISTER after being updated: 0x%02X\r\n", tmp_cfg_reg);
-        UART_Debug_PutString(message); 
+        ReportRegister("TEMPERATURE CONFIG REGISTER after being updated: ", LIS3DH_TEMP_CFG_REG, tmp_cfg_reg);
+        ReportText("\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read temperature config register\r\n");   
+        ReportError("Error occurred during I2C comm to read temperature config register\r\n", LIS3DH_TEMP_CFG_REG);
     }
     
     uint8_t ctrl_reg4;
@@ -274,18 +923,18 @@ int main(void)
     
     if (error == NO_ERROR)
     {
-        sprintf(message, "CONTROL REGISTER 4: 0x%02X\r\n", ctrl_reg4);
-        UART_Debug_PutString(message); 
+        ReportRegister("CONTROL REGISTER 4: ", LIS3DH_CTRL_REG4, ctrl_reg4);
+        ReportText("\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read control register4\r\n");   
+        ReportError("Error occurred during I2C comm to read control register4\r\n", LIS3DH_CTRL_REG4);
     }
     
     
-    /* Set Control Register 4 in order to enable a FSR of ± 4g in High Resolution Mode */
+    /* Set Control Register 4 in order to enable the acquisition FSR in High Resolution Mode */
     
-    ctrl_reg4 = LIS3DH_CTRL_REG4_4G_HIGH; 
+    ctrl_reg4 = LIS3DH_ACQ_CTRL_REG4; 
     
     error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
                                          LIS3DH_CTRL_REG4,
@@ -296,16 +945,164 @@ int main(void)
                                         &ctrl_reg4);
     
     
+    if (error != NO_ERROR || ctrl_reg4 != LIS3DH_ACQ_CTRL_REG4)
+    {
+        BootFlags &= ~BOOT_REGISTERS_OK;
+    }
+    if (error == NO_ERROR)
+    {
+        ReportRegister("CONTROL REGISTER 4 after being updated: ", LIS3DH_CTRL_REG4, ctrl_reg4);
+        ReportText("\r\n");
+    }
+    else
+    {
+        ReportError("Error occurred during I2C comm to read control register4\r\n", LIS3DH_CTRL_REG4);
+    }
+    
+#if ACQ_ADAPTIVE_ODR
+    /* Set Activity threshold and duration in order to enable the sleep-to-wake engine */
+    
+    error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                         LIS3DH_ACT_THS,
+                                         ACQ_ACT_THS);
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                             LIS3DH_ACT_DUR,
+                                             ACQ_ACT_DUR);
+    }
+    
+    if (error == NO_ERROR)
+    {
+        ReportRegister("ACTIVITY THRESHOLD/DURATION set as: ", LIS3DH_ACT_THS, ACQ_ACT_THS);
+        ReportRegister("/", LIS3DH_ACT_DUR, ACQ_ACT_DUR);
+        ReportText("\r\n");
+    }
+    else
+    {
+        ReportError("Error occurred during I2C comm to set activity registers\r\n", LIS3DH_ACT_THS);
+    }
+#endif
+    
+#if ACQ_HPF
+    /* Enable the high-pass filter on the output data, then read the
+    Reference register to start it from the current acceleration,
+    before the FIFO collects any sample */
+    
+    uint8_t reference;
+    
+    error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                         LIS3DH_CTRL_REG2,
+                                         LIS3DH_ACQ_CTRL_REG2);
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                            LIS3DH_REFERENCE,
+                                            &reference);
+    }
+    
+    if (error == NO_ERROR)
+    {
+        ReportRegister("HIGH-PASS FILTER set as CTRL_REG2: ", LIS3DH_CTRL_REG2, LIS3DH_ACQ_CTRL_REG2);
+        ReportText(", cut-off at ODR/");
+        ReportDecimal(50 << ACQ_HPF_CUTOFF);
+        ReportText("\r\n");
+    }
+    else
+    {
+        ReportError("Error occurred during I2C comm to set the high-pass filter\r\n", LIS3DH_CTRL_REG2);
+    }
+#endif
+    
+#if ACQ_DECIMATION > 1
+    /* Enable the FIFO in Stream mode, so that the oversampled data can be read in bursts */
+    
+    error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                         LIS3DH_CTRL_REG5,
+                                         LIS3DH_CTRL_REG5_FIFO_EN);
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                             LIS3DH_FIFO_CTRL_REG,
+                                             LIS3DH_FIFO_CTRL_REG_STREAM);
+    }
+    
     if (error == NO_ERROR)
     {
-        sprintf(message, "CONTROL REGISTER 4 after being updated: 0x%02X\r\n", ctrl_reg4);
-        UART_Debug_PutString(message); 
+        ReportStatus(LIS3DH_FIFO_CTRL_REG, LIS3DH_FIFO_CTRL_REG_STREAM, 0);
+        ReportText("FIFO in Stream mode, decimation by ");
+        ReportDecimal(ACQ_DECIMATION);
+        ReportText(" to ");
+        ReportDecimal(ACQ_OUTPUT_HZ);
+        ReportText(" Hz\r\n");
     }
     else
     {
-        UART_Debug_PutString("Error occurred during I2C comm to read control register4\r\n");   
+        ReportError("Error occurred during I2C comm to set FIFO registers\r\n", LIS3DH_FIFO_CTRL_REG);
+    }
+#endif
+    
+#if ACQ_EVENTS
+    /* Set the click and free-fall engines: clicks on the INT2 pin, free
+    fall on INT1, both latched until their source register is read */
+    
+    static const uint8_t EventSettings[][2] = {
+#if ACQ_CLICK_MG > 0
+        {LIS3DH_CTRL_REG2, LIS3DH_ACQ_CTRL_REG2},
+        {LIS3DH_CLICK_CFG, ACQ_CLICK_DOUBLE ? LIS3DH_CLICK_CFG_DOUBLE_XYZ : LIS3DH_CLICK_CFG_SINGLE_XYZ},
+        {LIS3DH_CLICK_THS, LIS3DH_CLICK_THS_LIR | ACQ_CLICK_THS},
+        {LIS3DH_TIME_LIMIT, ACQ_CLICK_TIME_LIMIT},
+        {LIS3DH_TIME_LATENCY, ACQ_CLICK_TIME_LATENCY},
+        {LIS3DH_TIME_WINDOW, ACQ_CLICK_TIME_WINDOW},
+        {LIS3DH_CTRL_REG6, LIS3DH_CTRL_REG6_I2_CLICK},
+#endif
+#if ACQ_FREEFALL_MG > 0
+        {LIS3DH_INT1_THS, ACQ_FREEFALL_THS},
+        {LIS3DH_INT1_DURATION, ACQ_FREEFALL_DURATION},
+        {LIS3DH_INT1_CFG, LIS3DH_INT1_CFG_FREEFALL},
+        {LIS3DH_CTRL_REG3, LIS3DH_CTRL_REG3_I1_IA1},
+#endif
+    };
+    uint8_t setting;
+    
+    error = NO_ERROR;
+    for (setting = 0; setting < sizeof(EventSettings) / sizeof(EventSettings[0]) && error == NO_ERROR; setting++)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                             EventSettings[setting][0],
+                                             EventSettings[setting][1]);
+    }
+#if ACQ_FREEFALL_MG > 0
+    // Keep the FIFO setting of Control Register 5
+    uint8_t ctrl_reg5;
+    
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                            LIS3DH_CTRL_REG5,
+                                            &ctrl_reg5);
+    }
+    if (error == NO_ERROR)
+    {
+        error = I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS,
+                                             LIS3DH_CTRL_REG5,
+                                             ctrl_reg5 | LIS3DH_CTRL_REG5_LIR_INT1);
     }
+#endif
     
+    if (error == NO_ERROR)
+    {
+        ReportRegister("CLICK/FREE-FALL THRESHOLDS set as: ", LIS3DH_CLICK_THS,
+                       ACQ_CLICK_MG > 0 ? ACQ_CLICK_THS : 0);
+        ReportRegister("/", LIS3DH_INT1_THS, ACQ_FREEFALL_MG > 0 ? ACQ_FREEFALL_THS : 0);
+        ReportText("\r\n");
+    }
+    else
+    {
+        ReportError("Error occurred during I2C comm to set click and free-fall registers\r\n", LIS3DH_CLICK_CFG);
+    }
+#endif
+#endif
     
     
     /*   READ DATA FROM ACCELEROMETER AND SEND TO BRIDGE CONTROL PANEL*/
@@ -313,22 +1110,165 @@ int main(void)
     /*Variables Initialization*/
     
     int16_t OutTemp; // Variable that contains the data read from X/Y/Z Registers
-    float32 OutTempHR_float; // Float variable that cointains data converted in m/s^2
-    int32 OutTempHR_int; // Int 32 variable of OutTempHR_int
     
  
-    uint8_t header = 0xA0;
+    uint8_t header = (ACQ_FRAME_MODE == 0x07) ? 0xA0 : MASKED_FRAME_HEADER;
     uint8_t footer = 0xC0;
-    uint8_t OutArrayHR[14]; // Send an array that contains 2 byte per axis plus header and tail
-    uint8_t AccelerometerData[2]; // Array that contains temporal data of each axis
+    uint8_t OutArrayHR[ACQ_DATA_FRAME_SIZE]; // Send an array that contains 4 (or 2) byte per enabled axis plus header and tail
+    uint8_t Field; // Position of the next axis in OutArrayHR
     uint8_t Check_data; // Data read by the Status Register
+    int16_t SampleMg[3] = {0}; // Last sample of each axis, in mg
+    uint8_t Sensitivity = LIS3DH_SENS_HIGH(ACQ_CTRL_REG4_FS); // Sensitivity of the current FSR (mg/digit)
+#if ACQ_COMMANDS
+    uint8_t Command; // Character received by UART_Debug
+#endif
+#if ACQ_CALIBRATION
+    Calibration Calib; // Coefficients of the axes and measures
+    int16_t RawMg[3] = {0}; // Last sample of each axis before the correction, in mg
+#endif
+#if ACQ_AUTO_RANGE
+    RangeSwitch Range; // Full scale selection and switches
+#endif
+#if ACQ_EVENTS
+    MotionEvents Motion; // Polling of the click and free-fall engines
+    
+    MotionEvents_Init(&Motion);
+#endif
+#if ACQ_TRIGGER_MG > 0
+    uint8_t Packet[TRIGGER_PACKET_SIZE]; // Packet of the burst of a capture
+    uint8_t PacketTicks = 0; // Timer ticks since the last packet
+    
+    Trigger_Init(&Capture);
+#endif
+#if ACQ_STATS_WINDOW_MS > 0
+    WindowStats Stats; // Statistics of the current window
+    
+    WindowStats_Init(&Stats, ACQ_STATS_WINDOW_SAMPLES);
+#endif
+#if ACQ_DECIMATION == 1
+    uint8_t AccelerometerData[2 * ACQ_AXIS_SPAN]; // Array that contains the output registers of the enabled axes
+    uint8_t *Data; // Bytes of one axis in AccelerometerData
+    uint8_t axis;
     CYBIT CTRL_Reg_start=0; // Flag used to control availability of data looking at Status Register
+#endif
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+    TickPhase Phase; // Phase lock and phase reports
+    
+    TickPhase_Init(&Phase);
+#endif
+#if ACQ_ADAPTIVE_ODR
+    uint8_t RateMarker[ACQ_FRAME_SIZE] = {0}; // Frame sent when the data rate changes
+    uint32_t LastSampleTick; // Timer tick of the last sample read
+    int32 StreamRate = ACQ_ODR_HZ; // Data rate the stream is running at
+    int32 SampleRate; // Data rate estimated from the gap between samples
+    
+    RateMarker[0] = RATE_MARKER_HEADER;
+    RateMarker[ACQ_FRAME_SIZE - 1] = footer;
+#endif
+#if ACQ_DECIMATION > 1
+    uint8_t FifoData[6 * ACQ_FIFO_BURST]; // Array that contains a burst of samples read from the FIFO
+    uint8_t FifoCount; // Samples waiting in the FIFO
+    uint8_t BurstCount; // Samples read in the current burst
+    uint8_t *Sample; // Bytes of one sample in FifoData
+    Decimator Decimators[3]; // Decimating filter of each axis
+    int16_t Filtered[3] = {0}; // Output of the filters, in mg
+    uint8_t Ready = 0; // Flag set when the filters produce an output sample
+    uint8_t s, axis;
+    
+    for (axis = 0; axis < 3; axis++)
+    {
+        Decimator_Init(&Decimators[axis]);
+    }
+    
+#if ACQ_BENCHMARK && !ACQ_FAST_BOOT
+    /* Measure the Decimator on a known input and compare with the cycles
+    available for each sample at the LIS3DH rate */
+    uint32 cycles;
+    
+    cycles = CycleCounter_Read();
+    for (s = 0; s < 64; s++)
+    {
+        for (axis = 0; axis < 3; axis++)
+        {
+            Decimator_Push(&Decimators[axis], (int16_t)(s * 64 - 2048), &Filtered[axis]);
+        }
+    }
+    cycles = CycleCounter_Read() - cycles;
+    ReportText("DECIMATOR: ");
+    ReportDecimal((int32_t)(cycles / 64));
+    ReportText(" cycles per sample (3 axes), budget ");
+    ReportDecimal(ACQ_BUS_CLK_HZ / ACQ_ODR_HZ);
+    ReportText("\r\n");
+    
+    for (axis = 0; axis < 3; axis++)
+    {
+        Decimator_Init(&Decimators[axis]);
+        Filtered[axis] = 0; // Disabled axes are never filtered again
+    }
+#endif
+#endif
+    
+#if ACQ_BENCHMARK && ACQ_FFT_POINTS > 0 && !ACQ_FAST_BOOT
+    /* Measure the transform and the reduction of one axis on a known input */
+    uint32 fft_cycles;
+    uint16_t fft_values[SPECTRUM_VALUES];
+    uint16_t n;
+    
+    for (n = 0; n < ACQ_FFT_POINTS; n++)
+    {
+        FftBlock[0][n] = (int16_t)((n * 37) % 2000 - 1000);
+    }
+    fft_cycles = CycleCounter_Read();
+    Spectrum_Bands(FftBins, ACQ_FFT_POINTS,
+                   Spectrum_Transform(FftBlock[0], ACQ_FFT_POINTS, FftBins), fft_values);
+    fft_cycles = CycleCounter_Read() - fft_cycles;
+    ReportText("SPECTRUM: ");
+    ReportDecimal((int32_t)fft_cycles);
+    ReportText(" cycles per axis (");
+    ReportDecimal(ACQ_FFT_POINTS);
+    ReportText(" points)\r\n");
+#endif
+#if ACQ_BENCHMARK && !ACQ_FAST_BOOT
+    BenchmarkHotPath();
+#endif
  
     
     
     OutArrayHR[0] = header;
-    OutArrayHR[13] = footer; 
+    OutArrayHR[1] = ACQ_FRAME_MODE; // Mode byte, overwritten by X when all the axes are enabled
+    OutArrayHR[ACQ_DATA_FRAME_SIZE - 1] = footer; 
+#if ACQ_AUTO_RANGE
+    RangeSwitch_Init(&Range); // Mark the starting FSR in the stream
+#endif
+#if ACQ_CALIBRATION
+    Calibration_Init(&Calib);
+    SendCalibration(&Calib, (Calibration_Load(&Calib) == NO_ERROR) ?
+                    CALIBRATION_STATE_LOADED : CALIBRATION_STATE_DEFAULT);
+#endif
+#if ACQ_LOG
+    FlashLog_Init(&Log);
+#endif
+#if ACQ_PROFILE
+    uint32 TickStart; // Cycle counter at the start of the iteration
+    uint32 TickCycles; // Cycles taken by the last tick
+    uint64_t ProfileSum = 0; // Cycles of the ticks of the current profile
+    uint32 ProfileWorst = 0; // Cycles of the slowest tick of the current profile
+    uint16_t ProfileTicks = 0; // Ticks of the current profile
+    uint16_t ProfileSamples = 0; // Samples read during the current profile
+    uint32 ProfileStart = Timer_Ticks; // Timer tick at the start of the current profile
+    uint8_t Profiling; // Flag set when the iteration serves a tick
+#endif
+#if ACQ_STACK_REPORT_TICKS > 0
+    uint16_t StackTicks = 0; // Timer ticks since the last stack report
+    SendStackReport(); // Stack used by the boot
+#endif
+#if ACQ_ISR_REPORT_TICKS > 0
+    uint16_t IsrTicks = 0; // Timer ticks since the last interrupt report
+#endif
     Timer_ISR_start=0;  // Flag set by the Timer ISR
+#if ACQ_ADAPTIVE_ODR
+    LastSampleTick = Timer_Ticks;
+#endif
 
     /* In order to send data with 3 decimal values, data will be sent to UART communication 
     in mm/s^2 and then adjusted with the Bridge Control Panel settings in order to plot m/s^2.
@@ -336,10 +1276,162 @@ int main(void)
     for(;;)
     {
         
+#if ACQ_LOW_POWER
+        /* Halt the CPU with WFI until the Timer ISR delivers a tick: the
+        clocks keep running and the Timer interrupt ends the wait. Interrupts
+        are disabled around the check so that a tick cannot slip in between
+        the check and the halt: WFI still returns on an interrupt pending
+        while they are masked, which is serviced as soon as they are enabled
+        again. */
+        CyGlobalIntDisable;
+        while (!Timer_ISR_start)
+        {
+            CY_PM_WFI;
+            CyGlobalIntEnable;
+            CyGlobalIntDisable;
+        }
+        CyGlobalIntEnable;
+#elif ACQ_DECIMATION > 1
+        /* The FIFO holds the samples until the tick: spin on it in steps of
+        CyDelayUs, which also let the tick come in HostSim */
+        while (!Timer_ISR_start)
+        {
+            CyDelayUs(1);
+        }
+#endif
+#if ACQ_PROFILE
+        Profiling = Timer_ISR_start;
+        TickStart = CycleCounter_Read();
+#endif
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+        if (Timer_ISR_start)
+        {
+            TickPhase_Start(&Phase);
+        }
+#endif
+        
+#if ACQ_DECIMATION > 1
+        if (Timer_ISR_start)
+        {
+            // Check how many samples the FIFO collected since the last tick
+            error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
+                                                LIS3DH_FIFO_SRC_REG,
+                                                &Check_data);
+            FifoCount = 0;
+            if (error == NO_ERROR)
+            {
+                FifoCount = (Check_data & LIS3DH_FIFO_SRC_REG_OVRN) ? 32 : (Check_data & LIS3DH_FIFO_SRC_REG_FSS);
+            }
+            
+            while (FifoCount > 0)
+            {
+                // Read the samples in bursts: the register address rolls back from OUT_Z_H to OUT_X_L
+                BurstCount = (FifoCount > ACQ_FIFO_BURST) ? ACQ_FIFO_BURST : FifoCount;
+                error = I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS,
+                                                         LIS3DH_OUT_X_L,
+                                                         6 * BurstCount,
+                                                         FifoData);
+                if (error != NO_ERROR)
+                {
+                    break;
+                }
+                FifoCount -= BurstCount;
+#if ACQ_PROFILE
+                ProfileSamples += BurstCount;
+#endif
+                if (BootPending)
+                {
+                    SendBootRecord(who_am_i_reg, BootFlags, CycleCounter_Read() / ACQ_BUS_CLK_MHZ);
+                    BootPending = 0;
+                }
+                
+                for (s = 0; s < BurstCount; s++)
+                {
+                    // The first byte read is saved last: Sample[5] is X_L, Sample[0] is Z_H
+                    Sample = &FifoData[6 * (BurstCount - 1 - s)];
+                    for (axis = 0; axis < 3; axis++)
+                    {
+                        // The FIFO keeps all three axes: the disabled ones are skipped
+                        if (!AXIS_ENABLED(axis))
+                        {
+                            continue;
+                        }
+                        OutTemp = (int16)((Sample[5 - 2 * axis] | (Sample[4 - 2 * axis]<<8)))>>4;
+                        OutTemp = OutTemp*Sensitivity;
+#if ACQ_CALIBRATION
+                        RawMg[axis] = OutTemp;
+                        OutTemp = Calibration_Apply(&Calib, axis, OutTemp);
+#endif
+                        SampleMg[axis] = OutTemp;
+                    }
+#if ACQ_AUTO_RANGE
+                    RangeSwitch_Add(&Range, SampleMg);
+#endif
+                    for (axis = 0; axis < 3; axis++)
+                    {
+                        if (AXIS_ENABLED(axis))
+                        {
+                            Ready = Decimator_Push(&Decimators[axis], SampleMg[axis], &Filtered[axis]);
+                        }
+                    }
+#if ACQ_CALIBRATION
+                    MeasureCalibration(&Calib, RawMg);
+#endif
+                    
+                    if (Ready && ACQ_RAW_FRAMES)
+                    {
+                        Field = FRAME_DATA_OFFSET;
+                        for (axis = 0; axis < 3; axis++)
+                        {
+                            if (!AXIS_ENABLED(axis))
+                            {
+                                continue;
+                            }
+                            Field += PackAxis(&OutArrayHR[Field], Filtered[axis]);
+                        }
+                        UART_Debug_PutArray(OutArrayHR, ACQ_DATA_FRAME_SIZE);
+                    }
+#if ACQ_STATS_WINDOW_MS > 0
+                    if (Ready)
+                    {
+                        SendStatistics(&Stats, Filtered);
+                    }
+#endif
+#if ACQ_FFT_POINTS > 0
+                    if (Ready)
+                    {
+                        SendSpectrum(Filtered);
+                    }
+#endif
+#if ACQ_TRIGGER_MG > 0
+                    if (Ready)
+                    {
+                        Trigger_Add(&Capture, Filtered);
+                    }
+#endif
+#if ACQ_LOG
+                    if (Ready)
+                    {
+                        FlashLog_Add(&Log, Filtered, Timer_Ticks);
+                    }
+#endif
+                }
+            }
+#if ACQ_AUTO_RANGE
+            // Move to the range picked on the samples just read
+            RangeSwitch_Update(&Range);
+            Sensitivity = Range.sensitivity;
+#endif
+        }
+#else
         // Check if new data is available by check the status register
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+        error = TickPhase_ReadStatus(&Phase, Timer_ISR_start, &Check_data);
+#else
         error = I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS,
                                             LIS3DH_STATUS_REG,
                                             &Check_data);
+#endif
         if(error == NO_ERROR)
         {
             //Check bit a bit with data read from the Status Register
@@ -352,70 +1444,185 @@ int main(void)
         
         /*Start reading data if both flag from Status Register and Timer ISR are 1*/
         if (CTRL_Reg_start & Timer_ISR_start){
-        // Read X axis
-        error = I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS,
-                                            LIS3DH_OUT_X_L,
-                                            2,
-                                            AccelerometerData);
-        if(error == NO_ERROR)
+#if ACQ_ADAPTIVE_ODR
+        /* The device switches rate on its own: tell the rate from the gap
+        between data-ready samples and mark every change in the stream */
+        SampleRate = (Timer_Ticks - LastSampleTick > ACQ_SLEEP_GAP_TICKS) ? ACQ_SLEEP_ODR_HZ : ACQ_ODR_HZ;
+        LastSampleTick = Timer_Ticks;
+        if (SampleRate != StreamRate)
         {
-            OutTemp   = (int16)((AccelerometerData[1] | (AccelerometerData[0]<<8)))>>4; // Shift 4 bit to right since High Resolution provide 12 bit resolution left adjusted
-            OutTemp = OutTemp*LIS3DH_SENS_4G; // Add conversion factor related to FSR of 4g
-            OutTempHR_float = OutTemp*G_TO_ACC; // Convert the Accelerometer Data from mg to mm/s^2
-            OutTempHR_int = (int32) OutTempHR_float;
-            /*Save data in 4 int8 array to cover the int32 sensibility*/
-            OutArrayHR[1] = (uint8_t)(OutTempHR_int & 0xFF);
-            OutArrayHR[2] = (uint8_t)((OutTempHR_int >> 8)&0xFF);
-            OutArrayHR[3] = (uint8_t)((OutTempHR_int >> 16)&0xFF);
-            OutArrayHR[4] = (uint8_t)(OutTempHR_int >> 24);
-
-            
-            
-            
+            StreamRate = SampleRate;
+            RateMarker[1] = (uint8_t)(StreamRate & 0xFF);
+            RateMarker[2] = (uint8_t)((StreamRate >> 8)&0xFF);
+            RateMarker[3] = (uint8_t)((StreamRate >> 16)&0xFF);
+            RateMarker[4] = (uint8_t)(StreamRate >> 24);
+            UART_Debug_PutArray(RateMarker, ACQ_FRAME_SIZE);
         }
-        // Read Y axis
-        // Repeat the same steps of the X axis
+#endif
+        // Read the enabled axes in one burst, from OUT_L of the first one to OUT_H of the last one
         error = I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS,
-                                            LIS3DH_OUT_Y_L,
-                                            2,
+                                            LIS3DH_OUT_X_L + 2 * ACQ_AXIS_FIRST,
+                                            2 * ACQ_AXIS_SPAN,
                                             AccelerometerData);
-        if(error == NO_ERROR)
+        if (error == NO_ERROR && BootPending)
         {
-            OutTemp = (int16)((AccelerometerData[1] | (AccelerometerData[0]<<8)))>>4;
-            OutTemp = OutTemp*LIS3DH_SENS_4G;
-            OutTempHR_float = (OutTemp)*G_TO_ACC;
-            OutTempHR_int = (int32) OutTempHR_float;
-            OutArrayHR[5] = (uint8_t)(OutTempHR_int & 0xFF);
-            OutArrayHR[6] = (uint8_t)((OutTempHR_int >> 8)&0xFF);
-            OutArrayHR[7] = (uint8_t)((OutTempHR_int >> 16)&0xFF);
-            OutArrayHR[8] = (uint8_t)(OutTempHR_int >> 24);
-
-            
+            SendBootRecord(who_am_i_reg, BootFlags, CycleCounter_Read() / ACQ_BUS_CLK_MHZ);
+            BootPending = 0;
         }
-        // Read Z axis
-        // Repeat the same steps of the Z axis
-        error = I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS,
-                                            LIS3DH_OUT_Z_L,
-                                            2,
-                                            AccelerometerData);
         if(error == NO_ERROR)
         {
-            OutTemp = (int16)((AccelerometerData[1] | (AccelerometerData[0]<<8)))>>4;
-            OutTemp = OutTemp*LIS3DH_SENS_4G;
-            OutTempHR_float = OutTemp*G_TO_ACC;
-            OutTempHR_int = (int32) OutTempHR_float;
-            OutArrayHR[9] = (uint8_t)(OutTempHR_int & 0xFF);
-            OutArrayHR[10] = (uint8_t)((OutTempHR_int >> 8)&0xFF);
-            OutArrayHR[11] = (uint8_t)((OutTempHR_int >> 16)&0xFF);
-            OutArrayHR[12] = (uint8_t)(OutTempHR_int >> 24);
-
+#if ACQ_PROFILE
+            ProfileSamples++;
+#endif
+            Field = FRAME_DATA_OFFSET;
+            for (axis = ACQ_AXIS_FIRST; axis <= ACQ_AXIS_LAST; axis++)
+            {
+                // Disabled axis between two enabled ones
+                if (!AXIS_ENABLED(axis))
+                {
+                    continue;
+                }
+                // The first byte read is saved last: Data[1] is OUT_L, Data[0] is OUT_H
+                Data = &AccelerometerData[2 * (ACQ_AXIS_LAST - axis)];
+                OutTemp = (int16)((Data[1] | (Data[0]<<8)))>>4; // Shift 4 bit to right since High Resolution provide 12 bit resolution left adjusted
+                OutTemp = OutTemp*Sensitivity; // Add conversion factor related to the FSR
+#if ACQ_CALIBRATION
+                RawMg[axis] = OutTemp;
+                OutTemp = Calibration_Apply(&Calib, axis, OutTemp); // Offset and gain of the board, in integer arithmetic
+#endif
+                SampleMg[axis] = OutTemp;
+            }
+#if ACQ_AUTO_RANGE
+            RangeSwitch_Add(&Range, SampleMg);
+#endif
+            for (axis = ACQ_AXIS_FIRST; axis <= ACQ_AXIS_LAST; axis++)
+            {
+                if (AXIS_ENABLED(axis))
+                {
+                    Field += PackAxis(&OutArrayHR[Field], SampleMg[axis]);
+                }
+            }
         }
         
         // Send all the measurements throught UART communication
-        UART_Debug_PutArray(OutArrayHR, 14);
+        if (ACQ_RAW_FRAMES)
+        {
+            UART_Debug_PutArray(OutArrayHR, ACQ_DATA_FRAME_SIZE);
+        }
+#if ACQ_STATS_WINDOW_MS > 0
+        SendStatistics(&Stats, SampleMg);
+#endif
+#if ACQ_FFT_POINTS > 0
+        SendSpectrum(SampleMg);
+#endif
+#if ACQ_TRIGGER_MG > 0
+        Trigger_Add(&Capture, SampleMg);
+#endif
+#if ACQ_LOG
+        FlashLog_Add(&Log, SampleMg, Timer_Ticks);
+#endif
+#if ACQ_CALIBRATION
+        MeasureCalibration(&Calib, RawMg);
+#endif
+#if ACQ_AUTO_RANGE
+        // Move to the range picked on this sample
+        RangeSwitch_Update(&Range);
+        Sensitivity = Range.sensitivity;
+#endif
 
         }
         CTRL_Reg_start=0; // Reset flag checking LIS3DH Status Register
+#endif
+#if ACQ_EVENTS
+        if (Timer_ISR_start)
+        {
+            MotionEvents_Tick(&Motion);
+        }
+#endif
+#if ACQ_COMMANDS
+        /* Start the calibration measures, reset the coefficients and dump
+        the flash log on the commands received by UART_Debug, one
+        character each */
+        if (Timer_ISR_start && (Command = UART_Debug_GetChar()) != 0)
+        {
+#if ACQ_CALIBRATION
+            if (Command == 'o')
+            {
+                Calibration_Start(&Calib, CALIBRATION_REST);
+            }
+            else if (Command >= '1' && Command < '1' + CALIBRATION_POSITIONS)
+            {
+                Calibration_Start(&Calib, Command - '1');
+            }
+            else if (Command == 'd')
+            {
+                Calibration_Init(&Calib);
+                SendCalibration(&Calib, (Calibration_Save(&Calib) == NO_ERROR) ?
+                                CALIBRATION_STATE_STORED : CALIBRATION_STATE_NOT_STORED);
+            }
+#endif
+#if ACQ_LOG
+            if (Command == 'l')
+            {
+                DumpLog(&Log);
+            }
+#endif
+        }
+#endif
+#if ACQ_TRIGGER_MG > 0
+        /* Send the burst of a completed capture one packet every few ticks,
+        so that the samples keep being read while it goes out */
+        if (Timer_ISR_start && ++PacketTicks >= ACQ_TRIGGER_PACKET_TICKS)
+        {
+            PacketTicks = 0;
+            if (Trigger_Read(&Capture, Packet))
+            {
+                UART_Debug_PutArray(Packet, TRIGGER_PACKET_SIZE);
+            }
+        }
+#endif
+#if ACQ_PROFILE
+        if (Profiling)
+        {
+            TickCycles = CycleCounter_Read() - TickStart;
+            ProfileSum += TickCycles;
+            if (TickCycles > ProfileWorst)
+            {
+                ProfileWorst = TickCycles;
+            }
+            if (++ProfileTicks == ACQ_PROFILE_TICKS)
+            {
+                // The window is counted in ticks: the cycle counter stops during the halts
+                SendProfile(ProfileTicks, (uint32)(ProfileSum / ProfileTicks), ProfileWorst,
+                            ProfileSamples, (Timer_Ticks - ProfileStart) * (uint32)(ACQ_BUS_CLK_HZ / ACQ_TICK_HZ));
+                ProfileStart = Timer_Ticks;
+                ProfileSum = 0;
+                ProfileWorst = 0;
+                ProfileTicks = 0;
+                ProfileSamples = 0;
+            }
+        }
+#endif
+#if ACQ_PHASE_LOCK || ACQ_PHASE_REPORT_TICKS > 0
+        if (Timer_ISR_start)
+        {
+            TickPhase_End(&Phase);
+        }
+#endif
+#if ACQ_STACK_REPORT_TICKS > 0
+        if (Timer_ISR_start && ++StackTicks >= ACQ_STACK_REPORT_TICKS)
+        {
+            StackTicks = 0;
+            SendStackReport();
+        }
+#endif
+#if ACQ_ISR_REPORT_TICKS > 0
+        if (Timer_ISR_start && ++IsrTicks >= ACQ_ISR_REPORT_TICKS)
+        {
+            IsrTicks = 0;
+            SendIsrReport();
+        }
+#endif
         Timer_ISR_start=0; // Reset flag related to Timer ISR
         
     }
@@ -0,0 +1,483 @@
+/*
+* This file includes the capacity planner: it runs the acquisition and
+* transmit pipeline of the firmware in virtual time, against the modeled
+* I2C bus and UART, for every combination of output data rate, bus speed,
+* baud rate and frame format, and reports what each one sustains.
+*
+* The pipeline is the one of PROJ_3: a timer tick at twice the ODR polls
+* STATUS_REG, a new sample is read over I2C (one 2-byte transfer per axis,
+* or a single 6-byte burst with -b), encoded into a frame and queued for
+* the UART. Frames that find the queue full are dropped.
+*
+* Usage: capacity_planner [-t seconds] [-q queue_frames] [-b] [-c]
+*                         [-r odr_list] [-i i2c_list] [-u baud_list]
+*                         [-f format_list]
+*
+* Lists are comma separated, formats are "int16" (8-byte frames, mg) and
+* "int32" (14-byte frames, mm/s^2). -c prints CSV instead of a table.
+*/
+
+#include "HostSim.h"
+#include "CyLib.h"
+#include "I2C_Interface.h"
+#include "LIS3DH_Model.h"
+#include "UART_Debug.h"
+#include "Timer.h"
+#include "isr_Timer.h"
+#include "VirtualTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LIS3DH_DEVICE_ADDRESS       0x18
+#define LIS3DH_STATUS_REG           0x27
+#define LIS3DH_STATUS_REG_NEW_VALUES 0x07
+#define LIS3DH_CTRL_REG1            0x20
+#define LIS3DH_CTRL_REG4            0x23
+#define LIS3DH_CTRL_REG4_4G_HIGH    0x18
+#define LIS3DH_OUT_X_L              0x28
+
+/**
+*   \brief Largest number of values in a sweep dimension.
+*/
+#define PLANNER_MAX_VALUES 16
+
+/**
+*   \brief Largest software transmit queue, in frames.
+*/
+#define PLANNER_MAX_QUEUE 64
+
+/**
+*   \brief Largest frame, in bytes.
+*/
+#define PLANNER_MAX_FRAME 14
+
+/**
+*   \brief Drop rate under which a configuration is considered sustainable.
+*/
+#define PLANNER_MAX_DROP_RATE 0.001
+
+/**
+*   \brief A frame waiting to be transmitted.
+*/
+typedef struct {
+    uint8_t data[PLANNER_MAX_FRAME];
+    uint64_t sample_ns;             ///< Generation time of the sample
+} Planner_Frame;
+
+/**
+*   \brief Result of the simulation of one configuration.
+*/
+typedef struct {
+    double sustained_hz;            ///< Frames completely transmitted per second
+    double mean_queue;              ///< Mean queue depth seen by new frames
+    uint32_t max_queue;             ///< Largest queue depth
+    double latency_ms[3];           ///< 50th, 95th and 99th percentile latency
+    double drop_rate;               ///< Samples lost over samples generated
+    double i2c_utilization;         ///< Fraction of time the bus was busy
+} Planner_Result;
+
+static uint32_t odr_hz;
+static uint32_t frame_size;
+static uint8_t burst_read;
+static uint32_t queue_frames = 8;
+
+static Planner_Frame queue[PLANNER_MAX_QUEUE];
+static uint32_t queue_head;
+static uint32_t queue_count;
+static uint32_t queue_byte;
+static uint64_t queue_depth_sum;
+static uint32_t queue_depth_samples;
+static uint32_t queue_max;
+static uint32_t queue_drops;
+
+static uint64_t* latencies;
+static uint32_t latency_count;
+static uint32_t latency_capacity;
+static uint32_t bytes_on_wire;
+static uint64_t byte_ns;
+static volatile uint8_t tick;
+
+/**
+*   \brief Sample times of the frames handed over to the UART, by frame index.
+*
+*   The UART FIFO holds fewer bytes than a frame, so no more than two frames
+*   are ever on their way at the same time.
+*/
+#define PLANNER_IN_FLIGHT 4
+static uint64_t in_flight_ns[PLANNER_IN_FLIGHT];
+static uint32_t frames_started;
+
+static void Planner_TimerIsr(void)
+{
+    Timer_ReadStatusRegister();
+    tick = 1;
+}
+
+/*
+* Called for every byte leaving the UART: the end of a frame closes its
+* latency measurement.
+*/
+static void Planner_UartSink(uint8_t data, uint64_t done_ns)
+{
+    (void)data;
+    bytes_on_wire++;
+    if (bytes_on_wire % frame_size == 0)
+    {
+        uint32_t index = (bytes_on_wire / frame_size - 1) % PLANNER_IN_FLIGHT;
+        if (latency_count < latency_capacity)
+        {
+            latencies[latency_count++] = done_ns - in_flight_ns[index];
+        }
+    }
+}
+
+static void Planner_Enqueue(const uint8_t* frame, uint64_t sample_ns)
+{
+    queue_depth_sum += queue_count;
+    queue_depth_samples++;
+    if (queue_count >= queue_frames)
+    {
+        queue_drops++;
+        return;
+    }
+    Planner_Frame* slot = &queue[(queue_head + queue_count) % PLANNER_MAX_QUEUE];
+    memcpy(slot->data, frame, frame_size);
+    slot->sample_ns = sample_ns;
+    queue_count++;
+    if (queue_count > queue_max)
+    {
+        queue_max = queue_count;
+    }
+}
+
+/*
+* Move queued bytes to the UART as long as its FIFO has room.
+*/
+static void Planner_Transmit(void)
+{
+    while (queue_count > 0 && UART_Debug_GetTxBufferSize() < HOST_SIM_UART_TX_DEPTH)
+    {
+        Planner_Frame* frame = &queue[queue_head];
+        if (queue_byte == 0)
+        {
+            in_flight_ns[frames_started++ % PLANNER_IN_FLIGHT] = frame->sample_ns;
+        }
+        UART_Debug_PutChar(frame->data[queue_byte++]);
+        if (queue_byte == frame_size)
+        {
+            queue_byte = 0;
+            queue_head = (queue_head + 1) % PLANNER_MAX_QUEUE;
+            queue_count--;
+        }
+    }
+}
+
+static void Planner_Encode(const uint8_t* raw, uint8_t* frame)
+{
+    frame[0] = 0xA0;
+    frame[frame_size - 1] = 0xC0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int16_t counts = (int16_t)(raw[2 * axis] | (raw[2 * axis + 1] << 8)) >> 4;
+        int32_t value = counts * 2;
+        if (frame_size == 8)
+        {
+            frame[1 + 2 * axis] = (uint8_t)(value & 0xFF);
+            frame[2 + 2 * axis] = (uint8_t)(value >> 8);
+        }
+        else
+        {
+            value = (int32_t)(value * 9.80665f);
+            for (int b = 0; b < 4; b++)
+            {
+                frame[1 + 4 * axis + b] = (uint8_t)(value >> (8 * b));
+            }
+        }
+    }
+}
+
+static void Planner_ReadSample(uint8_t* raw)
+{
+    uint8_t data[6];
+    if (burst_read)
+    {
+        I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS, LIS3DH_OUT_X_L, 6, data);
+        // I2C_Peripheral_ReadRegisterMulti stores the bytes last to first
+        for (int i = 0; i < 6; i++)
+        {
+            raw[i] = data[5 - i];
+        }
+        return;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        I2C_Peripheral_ReadRegisterMulti(LIS3DH_DEVICE_ADDRESS, LIS3DH_OUT_X_L + 2 * axis, 2, data);
+        raw[2 * axis] = data[1];
+        raw[2 * axis + 1] = data[0];
+    }
+}
+
+static uint8_t Planner_OdrBits(uint32_t hz)
+{
+    static const uint32_t rates[] = {0, 1, 10, 25, 50, 100, 200, 400};
+    for (uint8_t i = 1; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        if (rates[i] == hz)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+static void Planner_Pipeline(void)
+{
+    uint8_t raw[6];
+    uint8_t frame[PLANNER_MAX_FRAME];
+    uint8_t status;
+
+    I2C_Peripheral_Start();
+    UART_Debug_Start();
+    I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_CTRL_REG4, LIS3DH_CTRL_REG4_4G_HIGH);
+    I2C_Peripheral_WriteRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_CTRL_REG1,
+                                 (uint8_t)((Planner_OdrBits(odr_hz) << 4) | 0x07));
+    Timer_WritePeriod((uint16)(Timer_CLOCK_HZ / (2 * odr_hz) - 1));
+    Timer_Start();
+    isr_Timer_StartEx(Planner_TimerIsr);
+    CyGlobalIntEnable;
+
+    for (;;)
+    {
+        Planner_Transmit();
+        if (tick)
+        {
+            tick = 0;
+            if (I2C_Peripheral_ReadRegister(LIS3DH_DEVICE_ADDRESS, LIS3DH_STATUS_REG, &status) == NO_ERROR &&
+                (status & LIS3DH_STATUS_REG_NEW_VALUES) == LIS3DH_STATUS_REG_NEW_VALUES)
+            {
+                Planner_ReadSample(raw);
+                Planner_Encode(raw, frame);
+                Planner_Enqueue(frame, LIS3DH_Model_LastReadSampleTime());
+            }
+        }
+        else if (queue_count > 0)
+        {
+            // Wait for the UART FIFO to make room
+            VirtualTime_Advance(byte_ns);
+        }
+        else
+        {
+            VirtualTime_AdvanceToNextEvent();
+        }
+    }
+}
+
+static int Planner_CompareLatency(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static Planner_Result Planner_Simulate(uint32_t odr, uint32_t i2c_hz, uint32_t baud,
+                                       uint32_t frame_bytes, double seconds)
+{
+    Planner_Result result;
+
+    odr_hz = odr;
+    frame_size = frame_bytes;
+    queue_head = queue_count = queue_byte = 0;
+    queue_depth_sum = queue_depth_samples = queue_max = queue_drops = 0;
+    latency_count = 0;
+    bytes_on_wire = 0;
+    frames_started = 0;
+    byte_ns = 10u * VIRTUAL_TIME_NS_PER_S / baud;
+    tick = 0;
+
+    VirtualTime_Reset();
+    HostSim_Reset();
+    LIS3DH_Model_Reset();
+    HostSim_SetI2CSpeed(i2c_hz);
+    HostSim_SetBaudRate(baud);
+    HostSim_SetUartSink(Planner_UartSink);
+
+    VirtualTime_Run(Planner_Pipeline, (uint64_t)(seconds * VIRTUAL_TIME_NS_PER_S));
+
+    const LIS3DH_Model_Stats* model = LIS3DH_Model_GetStats();
+    const HostSim_Stats* sim = HostSim_GetStats();
+    double elapsed = (double)VirtualTime_Now() / VIRTUAL_TIME_NS_PER_S;
+
+    result.sustained_hz = (bytes_on_wire / frame_size) / elapsed;
+    result.mean_queue = queue_depth_samples ? (double)queue_depth_sum / queue_depth_samples : 0.0;
+    result.max_queue = queue_max;
+    result.drop_rate = model->samples_generated ?
+        (double)(model->samples_missed + queue_drops) / model->samples_generated : 0.0;
+    result.i2c_utilization = (double)sim->i2c_busy_ns / VirtualTime_Now();
+
+    qsort(latencies, latency_count, sizeof(latencies[0]), Planner_CompareLatency);
+    static const double percentiles[3] = {0.50, 0.95, 0.99};
+    for (int i = 0; i < 3; i++)
+    {
+        result.latency_ms[i] = latency_count ?
+            latencies[(uint32_t)(percentiles[i] * (latency_count - 1))] / 1e6 : 0.0;
+    }
+    return result;
+}
+
+static uint32_t Planner_ParseList(const char* text, uint32_t* values)
+{
+    uint32_t count = 0;
+    char* end;
+    while (*text != '\0' && count < PLANNER_MAX_VALUES)
+    {
+        if (strncmp(text, "int16", 5) == 0)
+        {
+            values[count++] = 8;
+            text += 5;
+        }
+        else if (strncmp(text, "int32", 5) == 0)
+        {
+            values[count++] = 14;
+            text += 5;
+        }
+        else
+        {
+            values[count++] = (uint32_t)strtoul(text, &end, 10);
+            if (end == text)
+            {
+                return 0;
+            }
+            text = end;
+        }
+        if (*text == ',')
+        {
+            text++;
+        }
+    }
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t odrs[PLANNER_MAX_VALUES] = {25, 50, 100, 200, 400};
+    uint32_t buses[PLANNER_MAX_VALUES] = {100000, 400000};
+    uint32_t bauds[PLANNER_MAX_VALUES] = {9600, 19200, 57600, 115200};
+    uint32_t formats[PLANNER_MAX_VALUES] = {8, 14};
+    uint32_t n_odrs = 5, n_buses = 2, n_bauds = 4, n_formats = 2;
+    double seconds = 5.0;
+    uint8_t csv = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc)
+        {
+            queue_frames = (uint32_t)atoi(argv[++i]);
+            if (queue_frames < 1 || queue_frames > PLANNER_MAX_QUEUE)
+            {
+                fprintf(stderr, "Queue must hold 1 to %d frames\n", PLANNER_MAX_QUEUE);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            burst_read = 1;
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            csv = 1;
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            n_odrs = Planner_ParseList(argv[++i], odrs);
+        }
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            n_buses = Planner_ParseList(argv[++i], buses);
+        }
+        else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
+        {
+            n_bauds = Planner_ParseList(argv[++i], bauds);
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            n_formats = Planner_ParseList(argv[++i], formats);
+        }
+        else
+        {
+            n_odrs = 0;
+        }
+        if (n_odrs == 0 || n_buses == 0 || n_bauds == 0 || n_formats == 0)
+        {
+            fprintf(stderr, "Usage: %s [-t seconds] [-q queue_frames] [-b] [-c]\n"
+                            "       [-r odr_list] [-i i2c_list] [-u baud_list] [-f format_list]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    for (uint32_t i = 0; i < n_odrs; i++)
+    {
+        if (Planner_OdrBits(odrs[i]) == 0)
+        {
+            fprintf(stderr, "Unsupported ODR %u Hz\n", odrs[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    latency_capacity = (uint32_t)(seconds * 5376) + 1;
+    latencies = malloc(latency_capacity * sizeof(latencies[0]));
+    if (latencies == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (csv)
+    {
+        printf("odr_hz,i2c_hz,baud,frame_bytes,sustained_hz,mean_queue,max_queue,"
+               "p50_ms,p95_ms,p99_ms,drop_rate,i2c_utilization,ok\n");
+    }
+    else
+    {
+        printf("  ODR    I2C    baud frame | sustained  queue(mean/max)  latency p50/p95/p99 ms   drop    I2C\n");
+    }
+
+    for (uint32_t f = 0; f < n_formats; f++)
+    {
+        for (uint32_t o = 0; o < n_odrs; o++)
+        {
+            for (uint32_t b = 0; b < n_buses; b++)
+            {
+                for (uint32_t u = 0; u < n_bauds; u++)
+                {
+                    Planner_Result r = Planner_Simulate(odrs[o], buses[b], bauds[u], formats[f], seconds);
+                    uint8_t ok = r.drop_rate < PLANNER_MAX_DROP_RATE;
+                    if (csv)
+                    {
+                        printf("%u,%u,%u,%u,%.2f,%.2f,%u,%.3f,%.3f,%.3f,%.5f,%.3f,%u\n",
+                               odrs[o], buses[b], bauds[u], formats[f], r.sustained_hz,
+                               r.mean_queue, r.max_queue, r.latency_ms[0], r.latency_ms[1],
+                               r.latency_ms[2], r.drop_rate, r.i2c_utilization, ok);
+                    }
+                    else
+                    {
+                        printf("%5u %6u %7u %5u | %7.1f/s  %6.2f / %-3u     %7.2f %7.2f %7.2f  %6.2f%% %5.1f%% %s\n",
+                               odrs[o], buses[b], bauds[u], formats[f], r.sustained_hz,
+                               r.mean_queue, r.max_queue, r.latency_ms[0], r.latency_ms[1],
+                               r.latency_ms[2], 100.0 * r.drop_rate, 100.0 * r.i2c_utilization,
+                               ok ? "ok" : "DROPS");
+                    }
+                }
+            }
+        }
+    }
+
+    free(latencies);
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,20 @@
+/*
+* This file includes the host substitute of the firmware ClockProfile: the
+* simulated UART_Debug is moved to the bus clock of the profile and given
+* the divider the firmware sets, so that the baud rate error of the
+* profile is simulated. The Timer and I2C_Master keep their rates, as the
+* configuration checks that they can. Computation takes no virtual time,
+* so the profiles differ only in the cycles counted for the same time.
+*/
+
+#include "ClockProfile.h"
+#include "UART_Debug_IntClock.h"
+#include "HostSim.h"
+
+void ClockProfile_Apply(void)
+{
+    HostSim_SetBusClock(ACQ_BUS_CLK_HZ);
+    UART_Debug_IntClock_SetDividerValue(ACQ_UART_CLOCK_DIVIDER);
+}
+
+/* [] END OF FILE */
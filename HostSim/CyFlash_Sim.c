@@ -0,0 +1,142 @@
+/*
+* This file includes the simulated flash programming and Emulated EEPROM
+* library: the flash and the EEPROM contents are kept in RAM, optionally
+* backed by files so that they survive between runs as they do across
+* resets.
+*/
+
+#include "CyFlash.h"
+#include "cy_em_eeprom.h"
+#include "HostSim.h"
+#include "HostSim_Private.h"
+#include "VirtualTime.h"
+
+#include <string.h>
+
+_Static_assert(CY_FLASH_SIZE == HOST_SIM_FLASH_SIZE, "CY_FLASH_SIZE does not match the simulated flash");
+
+uint8 HostSim_Flash[HOST_SIM_FLASH_SIZE];
+static const char* flash_path;
+static uint8_t eeprom[HOST_SIM_EEPROM_MAX_SIZE];
+static const char* eeprom_path;
+
+void HostSim_SetFlashFile(const char* path)
+{
+    FILE* file;
+
+    flash_path = path;
+    memset(HostSim_Flash, 0, sizeof(HostSim_Flash));
+    if (path != NULL && (file = fopen(path, "rb")) != NULL)
+    {
+        size_t read = fread(HostSim_Flash, 1, sizeof(HostSim_Flash), file);
+        (void)read;
+        fclose(file);
+    }
+}
+
+void HostSim_SetEepromFile(const char* path)
+{
+    eeprom_path = path;
+}
+
+cystatus CySetTemp(void)
+{
+    return CYRET_SUCCESS;
+}
+
+cystatus CyWriteRowData(uint8 arrayId, uint16 rowAddress, const uint8* rowData)
+{
+    uint32 address = arrayId * CY_FLASH_SIZEOF_ARRAY + (uint32)rowAddress * CY_FLASH_SIZEOF_ROW;
+    FILE* file;
+
+    if (rowData == NULL || rowAddress >= CY_FLASH_SIZEOF_ARRAY / CY_FLASH_SIZEOF_ROW ||
+        address >= HOST_SIM_FLASH_SIZE)
+    {
+        return CYRET_BAD_PARAM;
+    }
+    // The CPU stalls while the row is erased and programmed
+    memcpy(&HostSim_Flash[address], rowData, CY_FLASH_SIZEOF_ROW);
+    host_sim_stats.flash_rows_written++;
+    VirtualTime_Advance(HOST_SIM_FLASH_ROW_WRITE_NS);
+
+    // Only the row changes in the file
+    file = (flash_path != NULL) ? fopen(flash_path, "r+b") : NULL;
+    if (flash_path != NULL && file == NULL)
+    {
+        file = fopen(flash_path, "wb");
+    }
+    if (file != NULL)
+    {
+        fseek(file, (long)address, SEEK_SET);
+        fwrite(rowData, 1, CY_FLASH_SIZEOF_ROW, file);
+        fclose(file);
+    }
+    return CYRET_SUCCESS;
+}
+
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Init(cy_stc_eeprom_config_t* config, cy_stc_eeprom_context_t* context)
+{
+    FILE* file;
+
+    if (config == NULL || context == NULL || config->userFlashStartAddr == 0 ||
+        config->eepromSize == 0 || config->eepromSize > HOST_SIM_EEPROM_MAX_SIZE ||
+        config->wearLevelingFactor == 0 || config->wearLevelingFactor > CY_EM_EEPROM_MAX_WEAR_LEVELING_FACTOR)
+    {
+        return CY_EM_EEPROM_BAD_PARAM;
+    }
+    context->eepromSize = config->eepromSize;
+    context->numberOfRows = CY_EM_EEPROM_GET_NUM_ROWS_IN_EEPROM(config->eepromSize);
+    context->wearLevelingFactor = config->wearLevelingFactor;
+    context->redundantCopy = config->redundantCopy;
+    context->blockingWrite = config->blockingWrite;
+    context->userFlashStartAddr = config->userFlashStartAddr;
+
+    // A blank EEPROM reads as zeros
+    memset(eeprom, 0, sizeof(eeprom));
+    if (eeprom_path != NULL && (file = fopen(eeprom_path, "rb")) != NULL)
+    {
+        size_t read = fread(eeprom, 1, config->eepromSize, file);
+        (void)read;
+        fclose(file);
+    }
+    return CY_EM_EEPROM_SUCCESS;
+}
+
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Read(uint32 addr, void* eepromData, uint32 size,
+                                           cy_stc_eeprom_context_t* context)
+{
+    if (context == NULL || eepromData == NULL || size == 0 || addr + size > context->eepromSize)
+    {
+        return CY_EM_EEPROM_BAD_PARAM;
+    }
+    memcpy(eepromData, &eeprom[addr], size);
+    return CY_EM_EEPROM_SUCCESS;
+}
+
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Write(uint32 addr, void* eepromData, uint32 size,
+                                            cy_stc_eeprom_context_t* context)
+{
+    FILE* file;
+    uint32 rows;
+
+    if (context == NULL || eepromData == NULL || size == 0 || addr + size > context->eepromSize)
+    {
+        return CY_EM_EEPROM_BAD_PARAM;
+    }
+    memcpy(&eeprom[addr], eepromData, size);
+
+    // One row per EEPROM row touched, twice with the redundant copy; the CPU stalls meanwhile
+    rows = ((addr + size - 1) / CY_EM_EEPROM_EEPROM_DATA_LEN - addr / CY_EM_EEPROM_EEPROM_DATA_LEN + 1) *
+           (1u + context->redundantCopy);
+    host_sim_stats.flash_rows_written += rows;
+    VirtualTime_Advance(rows * HOST_SIM_FLASH_ROW_WRITE_NS);
+
+    if (eeprom_path != NULL && (file = fopen(eeprom_path, "wb")) != NULL)
+    {
+        fwrite(eeprom, 1, context->eepromSize, file);
+        fclose(file);
+    }
+    return CY_EM_EEPROM_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,151 @@
+/*
+* This file includes the simulated system library: global interrupt
+* control, critical sections, interrupt priorities, the CyDelay busy
+* waits and the CPU halt of WFI and Alternate Active.
+*/
+
+#include "CyLib.h"
+#include "cyPm.h"
+#include "HostSim.h"
+#include "HostSim_Private.h"
+#include "VirtualTime.h"
+
+#include <string.h>
+
+HostSim_Stats host_sim_stats;
+
+/**
+*   \brief Interrupts raised while globally disabled, serviced on enable.
+*/
+#define HOST_SIM_MAX_PENDING 4
+
+static uint8 global_int_enabled;
+static void (*pending[HOST_SIM_MAX_PENDING])(void);
+static uint8 pending_count;
+static uint8 priorities[CY_INT_NUMBER_MAX + 1];
+
+static void HostSim_ServicePending(void)
+{
+    while (global_int_enabled && pending_count > 0)
+    {
+        void (*handler)(void) = pending[0];
+        pending_count--;
+        memmove(&pending[0], &pending[1], pending_count * sizeof(pending[0]));
+        handler();
+    }
+}
+
+void HostSim_Reset(void)
+{
+    memset(&host_sim_stats, 0, sizeof(host_sim_stats));
+    global_int_enabled = 0;
+    pending_count = 0;
+    memset(priorities, CY_INT_DEFAULT_PRIORITY, sizeof(priorities));
+    HostSim_I2CReset();
+    HostSim_UartReset();
+    HostSim_TimerReset();
+}
+
+const HostSim_Stats* HostSim_GetStats(void)
+{
+    return &host_sim_stats;
+}
+
+uint8_t HostSim_RaiseInterrupt(void (*handler)(void))
+{
+    if (!global_int_enabled)
+    {
+        // Keep it pending, once per source as the NVIC does
+        for (uint8 i = 0; i < pending_count; i++)
+        {
+            if (pending[i] == handler)
+            {
+                return 0;
+            }
+        }
+        if (pending_count < HOST_SIM_MAX_PENDING)
+        {
+            pending[pending_count++] = handler;
+        }
+        return 0;
+    }
+    handler();
+    return 1;
+}
+
+void HostSim_GlobalIntEnable(void)
+{
+    global_int_enabled = 1;
+    HostSim_ServicePending();
+}
+
+void HostSim_GlobalIntDisable(void)
+{
+    global_int_enabled = 0;
+}
+
+uint8 CyEnterCriticalSection(void)
+{
+    uint8 saved = global_int_enabled;
+    global_int_enabled = 0;
+    return saved;
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    global_int_enabled = savedIntrStatus;
+    HostSim_ServicePending();
+}
+
+void CyIntSetPriority(uint8 number, uint8 priority)
+{
+    if (number <= CY_INT_NUMBER_MAX)
+    {
+        priorities[number] = priority & 0x07u;
+    }
+}
+
+uint8 CyIntGetPriority(uint8 number)
+{
+    return (number <= CY_INT_NUMBER_MAX) ? priorities[number] : 0u;
+}
+
+void CyDelay(uint32 milliseconds)
+{
+    uint64_t ns = (uint64_t)milliseconds * 1000000u;
+    host_sim_stats.delay_ns += ns;
+    VirtualTime_Advance(ns);
+}
+
+void CyDelayUs(uint16 microseconds)
+{
+    uint64_t ns = (uint64_t)microseconds * 1000u;
+    host_sim_stats.delay_ns += ns;
+    VirtualTime_Advance(ns);
+}
+
+void CyFlushCache(void)
+{
+}
+
+void CyPmAltAct(uint16 wakeupTime, uint16 wakeupSource)
+{
+    (void)wakeupTime;
+    (void)wakeupSource;
+    HostSim_WaitForInterrupt();
+}
+
+void HostSim_WaitForInterrupt(void)
+{
+    host_sim_stats.sleeps++;
+    if (pending_count > 0)
+    {
+        // WFI returns at once with an interrupt already pending
+        return;
+    }
+    uint64_t start_ns = VirtualTime_Now();
+    VirtualTime_AdvanceToNextEvent();
+    host_sim_stats.sleep_ns += VirtualTime_Now() - start_ns;
+}
+
+/* [] END OF FILE */
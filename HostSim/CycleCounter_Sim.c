@@ -0,0 +1,21 @@
+/*
+* This file includes the host substitute of the firmware CycleCounter: the
+* DWT is not available, so the counter follows virtual time at the bus
+* clock of the selected profile. It measures the time spent on the modeled
+* buses, delays and interrupts; plain computation takes no virtual time.
+*/
+
+#include "CycleCounter.h"
+#include "AcquisitionConfig.h"
+#include "VirtualTime.h"
+
+void CycleCounter_Start(void)
+{
+}
+
+uint32 CycleCounter_Read(void)
+{
+    return (uint32)(VirtualTime_Now() * ACQ_BUS_CLK_MHZ / 1000u);
+}
+
+/* [] END OF FILE */
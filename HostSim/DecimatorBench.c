@@ -0,0 +1,156 @@
+/*
+* This file includes the Decimator benchmark: it measures the frequency
+* response of the filter compiled for the firmware by feeding it sines at
+* the LIS3DH rate, and the time it takes per input sample.
+*
+* Usage: decimator_bench [-n samples] [-s min_db]
+*
+* The gain of tones above the output Nyquist frequency is the attenuation
+* of what would otherwise alias into the stream; with -s the run fails
+* when one of them is attenuated by less than min_db. The cost is given as the
+* time taken on the host and as an estimate of the Cortex-M3 cycles; the
+* firmware prints the figure measured with the DWT at start-up when
+* ACQ_BENCHMARK is set.
+*/
+
+#include "Decimator.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if DECIMATOR_RATIO == 1
+
+int main(void)
+{
+    printf("Decimation disabled (ACQ_DECIMATION is 1)\n");
+    return EXIT_SUCCESS;
+}
+
+#else
+
+/**
+*   \brief Amplitude of the test tones, in mg.
+*/
+#define BENCH_AMPLITUDE_MG 1000
+
+/**
+*   \brief Estimated Cortex-M3 cycles: per input sample (store, wrap and
+*   phase), per symmetric tap pair (three LDRSH, ADD, MLA and the loop)
+*   and per output (rounding, saturation and call).
+*/
+#define BENCH_M3_CYCLES_PER_INPUT 20
+#define BENCH_M3_CYCLES_PER_TAP_PAIR 9
+#define BENCH_M3_CYCLES_PER_OUTPUT 30
+
+/*
+* Gain of the filter at the given frequency, measured on the output once
+* the history is full.
+*/
+static double DecimatorBench_Gain(double frequency_hz)
+{
+    Decimator decimator;
+    int16_t output;
+    int32_t peak = 0;
+    uint32_t outputs = 0;
+    uint32_t i;
+
+    Decimator_Init(&decimator);
+    for (i = 0; outputs < DECIMATOR_TAPS + 400; i++)
+    {
+        double t = (double)i / ACQ_ODR_HZ;
+        int16_t sample = (int16_t)lround(BENCH_AMPLITUDE_MG * sin(2.0 * M_PI * frequency_hz * t + 0.3));
+        if (Decimator_Push(&decimator, sample, &output))
+        {
+            if (++outputs > DECIMATOR_TAPS && abs(output) > peak)
+            {
+                peak = abs(output);
+            }
+        }
+    }
+    return (double)peak / BENCH_AMPLITUDE_MG;
+}
+
+int main(int argc, char* argv[])
+{
+    static const double fractions[] = {0.1, 0.2, 0.4, 0.6, 0.8, 1.0, 1.2, 1.6, 2.0, 3.0};
+    uint32_t samples = 100000;
+    double min_stopband_db = -1.0;
+    int failed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            samples = (uint32_t)atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            min_stopband_db = atof(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n samples] [-s min_db]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("Decimation %d: %d Hz -> %d Hz, %d taps (%d multiplications per output)\n",
+           DECIMATOR_RATIO, ACQ_ODR_HZ, ACQ_OUTPUT_HZ, DECIMATOR_TAPS, DECIMATOR_TAPS / 2);
+    printf("  Frequency    Gain\n");
+    for (size_t i = 0; i < sizeof(fractions) / sizeof(fractions[0]); i++)
+    {
+        // Fractions of the output Nyquist frequency, up to the input one
+        double frequency_hz = fractions[i] * ACQ_OUTPUT_HZ / 2.0;
+        if (frequency_hz >= ACQ_ODR_HZ / 2.0)
+        {
+            break;
+        }
+        double gain = DecimatorBench_Gain(frequency_hz);
+        double gain_db = gain > 0 ? 20.0 * log10(gain) : -99.9;
+        int aliased = frequency_hz > ACQ_OUTPUT_HZ / 2.0;
+        int below = aliased && min_stopband_db >= 0.0 && -gain_db < min_stopband_db;
+        printf("  %6.1f Hz  %6.1f dB%s%s\n", frequency_hz, gain_db, aliased ? "  (aliased)" : "",
+               below ? "  FAIL" : "");
+        failed |= below;
+    }
+
+    Decimator decimators[3];
+    int16_t output;
+    volatile int32_t sink = 0;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        Decimator_Init(&decimators[axis]);
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (Decimator_Push(&decimators[axis], (int16_t)(i * 37 + axis), &output))
+            {
+                sink += output;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double host_ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / samples;
+    double m3_cycles = 3.0 * (BENCH_M3_CYCLES_PER_INPUT +
+        (BENCH_M3_CYCLES_PER_TAP_PAIR * DECIMATOR_TAPS / 2 + BENCH_M3_CYCLES_PER_OUTPUT) /
+        (double)DECIMATOR_RATIO);
+    double budget = (double)ACQ_BUS_CLK_HZ / ACQ_ODR_HZ;
+    printf("Host time             : %.1f ns per sample (3 axes)\n", host_ns);
+    printf("Cortex-M3 estimate    : %.0f cycles per sample (3 axes)\n", m3_cycles);
+    printf("Budget at %d Hz      : %.0f cycles per sample (%.2f %% used)\n",
+           ACQ_ODR_HZ, budget, 100.0 * m3_cycles / budget);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,110 @@
+/*
+* This file includes the DebugText benchmark: it checks the formatter of
+* the firmware against sprintf on every byte and on a sweep of integers,
+* then times a typical diagnostic line built both ways.
+*
+* Usage: format_bench [-n lines]
+*
+* The times are taken on the host and only their ratio carries over to the
+* Cortex-M3; the flash saved by dropping the printf machinery is only seen
+* in the .map of the ARM build.
+*/
+
+#include "DebugText.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+* Nanoseconds between two readings of the monotonic clock.
+*/
+static double FormatBench_Ns(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+/*
+* Build "CONTROL REGISTER 1: 0x.." with DebugText, as the firmware does.
+*/
+static size_t FormatBench_Line(char* line, uint8_t value)
+{
+    static const char label[] = "CONTROL REGISTER 1: ";
+    size_t length = sizeof(label) - 1;
+
+    memcpy(line, label, length);
+    length += DebugText_Hex(&line[length], value);
+    memcpy(&line[length], "\r\n", 3);
+    return length + 2;
+}
+
+int main(int argc, char* argv[])
+{
+    static const int32_t edges[] = {0, 1, -1, 9, 10, -10, 99, 100, 32767, -32768,
+                                    2147483647, -2147483647 - 1};
+    uint32_t lines = 1000000;
+    uint32_t mismatches = 0;
+    char expected[32];
+    char text[32];
+    uint8_t length;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            lines = (uint32_t)atol(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n lines]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (int value = 0; value < 256; value++)
+    {
+        sprintf(expected, "0x%02X", value);
+        length = DebugText_Hex(text, (uint8_t)value);
+        mismatches += (strcmp(text, expected) != 0 || length != strlen(expected));
+    }
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    {
+        sprintf(expected, "%ld", (long)edges[i]);
+        length = DebugText_Decimal(text, edges[i]);
+        mismatches += (strcmp(text, expected) != 0 || length != strlen(expected));
+    }
+    for (int32_t value = -100000; value <= 100000; value += 7)
+    {
+        sprintf(expected, "%ld", (long)value);
+        length = DebugText_Decimal(text, value);
+        mismatches += (strcmp(text, expected) != 0 || length != strlen(expected));
+    }
+    printf("Mismatches with sprintf : %u\n", mismatches);
+
+    volatile size_t sink = 0;
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < lines; i++)
+    {
+        sink += (size_t)sprintf(text, "CONTROL REGISTER 1: 0x%02X\r\n", (unsigned int)(i & 0xFF));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double sprintf_ns = FormatBench_Ns(&start, &end) / lines;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < lines; i++)
+    {
+        sink += FormatBench_Line(text, (uint8_t)i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double debug_text_ns = FormatBench_Ns(&start, &end) / lines;
+
+    printf("sprintf                 : %.1f ns per line\n", sprintf_ns);
+    printf("DebugText               : %.1f ns per line (%.1f times faster)\n",
+           debug_text_ns, sprintf_ns / debug_text_ns);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,895 @@
+/*
+* This file includes the entry point of the host build: it runs the
+* firmware main loop for a given amount of virtual time against the
+* simulated components and prints what happened on the bus and the link.
+*
+* Usage: firmware_host [-t seconds] [-o uart_capture.bin] [-r trace.txt]
+*                      [-v amplitude_mg frequency_hz] [-n noise_mg]
+*                      [-g on_s off_s] [-k every_s mg] [-d every_s fall_s]
+*                      [-p at_s dwell_s] [-b x_mg y_mg z_mg] [-s x_% y_% z_%]
+*                      [-c at_s text] [-e eeprom.bin] [-f flash.bin]
+*                      [-u boot_ms] [-x ppm] [-a settle_ms]
+*
+* -r logs every sample the firmware missed or read twice, -v shakes the
+* device along X with a sine, -n adds noise on every axis, -g shakes it in
+* bursts of on_s seconds separated by off_s seconds of stillness, -k taps
+* it on Z every every_s seconds, -d drops it for fall_s seconds every
+* every_s seconds. -p turns it through the six positions of the
+* calibration from at_s, dwell_s seconds each. -b and -s give the device
+* offset and gain errors. -c sends the characters of text to the firmware
+* from at_s on (repeat it in order of time), -e keeps the emulated EEPROM
+* and -f the flash in a file across runs. -u keeps the device silent on
+* the bus for boot_ms after the start of the firmware, as at power-up.
+* -x makes the clock of the device ppm parts per million faster than the
+* ODR (slower if negative). With -a the run fails if a sample is missed
+* or read twice later than settle_ms after the boot record, that is out
+* of the start-up register dump and of the first frames of the stream,
+* for use as a regression test.
+*/
+
+#include "HostSim.h"
+#include "LIS3DH_Model.h"
+#include "VirtualTime.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+*   \brief Firmware main(), renamed at compile time.
+*/
+int Firmware_Main(void);
+
+/**
+*   \brief Header and footer of the data frames sent by the firmware.
+*/
+#define FRAME_HEADER 0xA0
+#define FRAME_FOOTER 0xC0
+
+/**
+*   \brief Header of the frames marking a change of the data rate.
+*/
+#define RATE_MARKER_HEADER 0xA1
+
+/**
+*   \brief Header of the frames with the statistics of a window.
+*/
+#define STATS_HEADER 0xA2
+
+/**
+*   \brief Header of the frames with the spectrum of one axis.
+*/
+#define SPECTRUM_HEADER 0xA3
+
+/**
+*   \brief Header of the packets of the event-triggered captures.
+*/
+#define CAPTURE_HEADER 0xA4
+
+/**
+*   \brief Header of the frames reporting click and free-fall events.
+*/
+#define EVENT_HEADER 0xA5
+
+/**
+*   \brief Header of the frames marking a change of the full scale.
+*/
+#define RANGE_MARKER_HEADER 0xA6
+
+/**
+*   \brief Header of the data frames with only some of the axes or with
+*   int16 fields: the mode byte follows, axis mask and 0x08 for int16.
+*/
+#define MASKED_FRAME_HEADER 0xA7
+
+/**
+*   \brief Header of the frames reporting the calibration coefficients.
+*/
+#define CALIBRATION_HEADER 0xA8
+
+/**
+*   \brief Header of the frames of the flash log dump.
+*/
+#define LOG_HEADER 0xA9
+
+/**
+*   \brief Header of the boot record.
+*/
+#define BOOT_HEADER 0xAA
+
+/**
+*   \brief Header of the status records of the register dump, and code of
+*   a device found on the I2C bus.
+*/
+#define STATUS_HEADER 0xAB
+#define STATUS_DEVICE 0x80
+
+/**
+*   \brief Header of the profile frames of the acquisition loop.
+*/
+#define PROFILE_HEADER 0xAC
+
+/**
+*   \brief Header of the stack reports.
+*/
+#define STACK_HEADER 0xAD
+
+/**
+*   \brief Header of the phase reports.
+*/
+#define PHASE_HEADER 0xAE
+
+/**
+*   \brief Header of the interrupt reports.
+*/
+#define ISR_HEADER 0xAF
+
+/**
+*   \brief Length of the data, statistics, spectrum, capture, event, calibration, log, boot, status, profile, stack, phase and interrupt frames sent by the firmware.
+*/
+#define FRAME_SIZE 14
+#define STATS_FRAME_SIZE 32
+#define SPECTRUM_FRAME_SIZE 19
+#define CAPTURE_FRAME_SIZE 28
+#define EVENT_FRAME_SIZE 8
+#define CALIBRATION_FRAME_SIZE 16
+#define LOG_FRAME_SIZE 260
+#define BOOT_FRAME_SIZE 8
+#define STATUS_FRAME_SIZE 5
+#define PROFILE_FRAME_SIZE 19
+#define STACK_FRAME_SIZE 6
+#define PHASE_FRAME_SIZE 24
+#define ISR_FRAME_SIZE 13
+
+/**
+*   \brief Bytes of the header of a row of the flash log.
+*/
+#define LOG_ROW_HEADER_SIZE 12
+
+static uint8_t frame[LOG_FRAME_SIZE];
+static uint16_t frame_length;
+static uint32_t frames_received;
+static uint32_t rate_markers;
+static int32_t stream_rate_hz;
+static uint32_t stats_received;
+static uint8_t last_stats[STATS_FRAME_SIZE];
+static uint32_t spectra_received;
+static uint8_t last_spectrum[3][SPECTRUM_FRAME_SIZE];
+static uint32_t captures_received;
+static int16_t capture_last_index;
+static uint16_t capture_samples;
+static uint16_t capture_pre_samples;
+static double capture_trigger_mg;
+static double capture_peak_mg;
+static uint32_t events_received[4];
+static uint32_t range_markers;
+static int32_t full_scale_g;
+static int32_t sensitivity_mg;
+static double frame_peak_mg[3];
+static double frame_sum_mg[3];
+static uint32_t calibrations_received;
+static uint8_t last_calibration[CALIBRATION_FRAME_SIZE];
+static uint32_t log_frames;
+static uint32_t log_rows;
+static uint32_t log_samples;
+static uint32_t log_bytes;
+static uint32_t log_errors;
+static uint32_t log_first_sequence;
+static uint32_t log_last_sequence;
+static double log_sum_mg[3];
+static uint64_t log_start_ns;
+static uint64_t log_end_ns;
+static uint32_t boot_records;
+static uint8_t last_boot[BOOT_FRAME_SIZE];
+static uint64_t boot_ns;
+static uint64_t settle_ns;
+static uint32_t settle_missed;
+static uint32_t settle_double_read;
+static uint32_t status_records;
+static uint32_t status_errors;
+static uint32_t status_devices;
+static uint32_t profiles_received;
+static uint64_t profile_ticks;
+static double profile_sum_cycles;
+static uint32_t profile_worst_cycles;
+static uint64_t profile_samples;
+static double profile_window_cycles;
+static uint8_t profile_mhz;
+static uint32_t stack_reports;
+static uint16_t stack_size;
+static uint16_t stack_used;
+static uint32_t phase_reports;
+static uint64_t phase_ticks;
+static uint32_t phase_merged;
+static uint32_t phase_early;
+static uint32_t phase_overruns;
+static int16_t phase_drift_ppm;
+static int32_t phase_interval_min = INT32_MAX;
+static int32_t phase_interval_max = INT32_MIN;
+static uint32_t phase_latency_max;
+static uint32_t isr_reports;
+static uint16_t isr_cycles_max[3];
+static uint16_t isr_delay_max_us;
+static uint8_t isr_priorities[3];
+
+/*
+* Length of the frame received so far, 0 while the mode byte of a masked
+* data frame is still missing.
+*/
+static uint16_t HostMain_FrameSize(void)
+{
+    switch (frame[0])
+    {
+        case LOG_HEADER:
+            return LOG_FRAME_SIZE;
+        case MASKED_FRAME_HEADER:
+            if (frame_length < 2)
+            {
+                return 0;
+            }
+            return 3 + ((frame[1] & 0x08) ? 2 : 4) * ((frame[1] & 1) + ((frame[1] >> 1) & 1) + ((frame[1] >> 2) & 1));
+        case CAPTURE_HEADER:
+            return CAPTURE_FRAME_SIZE;
+        case EVENT_HEADER:
+            return EVENT_FRAME_SIZE;
+        case CALIBRATION_HEADER:
+            return CALIBRATION_FRAME_SIZE;
+        case BOOT_HEADER:
+            return BOOT_FRAME_SIZE;
+        case STATUS_HEADER:
+            return STATUS_FRAME_SIZE;
+        case PROFILE_HEADER:
+            return PROFILE_FRAME_SIZE;
+        case STACK_HEADER:
+            return STACK_FRAME_SIZE;
+        case PHASE_HEADER:
+            return PHASE_FRAME_SIZE;
+        case ISR_HEADER:
+            return ISR_FRAME_SIZE;
+        case STATS_HEADER:
+            return STATS_FRAME_SIZE;
+        case SPECTRUM_HEADER:
+            return SPECTRUM_FRAME_SIZE;
+        default:
+            return FRAME_SIZE;
+    }
+}
+
+/*
+* Add a packet to the current capture: a packet that does not follow the
+* previous one starts a new capture.
+*/
+static void HostMain_CapturePacket(void)
+{
+    int16_t index = (int16_t)(frame[1] | frame[2] << 8);
+
+    if (captures_received == 0 || index <= capture_last_index)
+    {
+        captures_received++;
+        capture_samples = 0;
+        capture_pre_samples = index < 0 ? (uint16_t)-index : 0;
+        capture_trigger_mg = 0.0;
+        capture_peak_mg = 0.0;
+    }
+    capture_last_index = index;
+
+    for (int sample = 0; sample < (CAPTURE_FRAME_SIZE - 4) / 6; sample++)
+    {
+        const uint8_t* v = &frame[3 + 6 * sample];
+        double sum = 0.0;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            double value = (int16_t)(v[2 * axis] | v[2 * axis + 1] << 8);
+            sum += value * value;
+        }
+        if (index + sample == 0)
+        {
+            capture_trigger_mg = sqrt(sum);
+        }
+        if (sqrt(sum) > capture_peak_mg)
+        {
+            capture_peak_mg = sqrt(sum);
+        }
+        capture_samples++;
+    }
+}
+
+/*
+* Decode a row of the flash log dump: the enabled axes of each sample as
+* zigzag differences from the previous one, 7 bits per byte. A row that
+* does not decode to the samples and bytes of its header is an error.
+*/
+static void HostMain_LogFrame(void)
+{
+    const uint8_t* row = &frame[3];
+    uint32_t sequence = row[0] | row[1] << 8 | row[2] << 16 | (uint32_t)row[3] << 24;
+    uint16_t samples = (uint16_t)(row[8] | row[9] << 8);
+    uint8_t mask = row[10];
+    uint16_t end = LOG_ROW_HEADER_SIZE + row[11];
+    uint16_t position = LOG_ROW_HEADER_SIZE;
+    int32_t last[3] = {0, 0, 0};
+
+    log_frames++;
+    if (sequence == 0)
+    {
+        return;
+    }
+    if (end > LOG_FRAME_SIZE - 4 || mask == 0 || mask > 0x07)
+    {
+        log_errors++;
+        return;
+    }
+    for (uint16_t sample = 0; sample < samples; sample++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            uint32_t zigzag = 0;
+            int shift = 0;
+
+            if (!(mask & (1 << axis)))
+            {
+                continue;
+            }
+            do
+            {
+                if (position >= end || shift > 28)
+                {
+                    log_errors++;
+                    return;
+                }
+                zigzag |= (uint32_t)(row[position] & 0x7F) << shift;
+                shift += 7;
+            } while (row[position++] & 0x80);
+            last[axis] += (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+            log_sum_mg[axis] += last[axis];
+        }
+    }
+    if (position != end)
+    {
+        log_errors++;
+        return;
+    }
+    if (log_rows == 0)
+    {
+        log_first_sequence = sequence;
+    }
+    log_last_sequence = sequence;
+    log_rows++;
+    log_samples += samples;
+    log_bytes += end;
+}
+
+/*
+* Count a data frame and keep the peak and the sum of each axis it
+* carries, from the given offset and mode byte.
+*/
+static void HostMain_DataFrame(uint8_t offset, uint8_t mode)
+{
+    const uint8_t* v = &frame[offset];
+
+    frames_received++;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        double mg;
+
+        if (!(mode & (1 << axis)))
+        {
+            continue;
+        }
+        if (mode & 0x08)
+        {
+            mg = (int16_t)(v[0] | v[1] << 8) / 9.80665;
+            v += 2;
+        }
+        else
+        {
+            mg = (int32_t)(v[0] | v[1] << 8 | v[2] << 16 | (uint32_t)v[3] << 24) / 9.80665;
+            v += 4;
+        }
+        frame_sum_mg[axis] += mg;
+        if (fabs(mg) > frame_peak_mg[axis])
+        {
+            frame_peak_mg[axis] = fabs(mg);
+        }
+    }
+}
+
+/*
+* Look for complete data frames in the transmitted byte stream.
+*/
+static void HostMain_UartSink(uint8_t data, uint64_t done_ns)
+{
+    if (boot_records == 0 || done_ns <= boot_ns + settle_ns)
+    {
+        // Still starting: the losses so far are not checked
+        const LIS3DH_Model_Stats* model = LIS3DH_Model_GetStats();
+
+        settle_missed = model->samples_missed;
+        settle_double_read = model->samples_double_read;
+    }
+    if (frame_length == 0 && data != FRAME_HEADER && data != RATE_MARKER_HEADER &&
+        data != STATS_HEADER && data != SPECTRUM_HEADER && data != CAPTURE_HEADER &&
+        data != EVENT_HEADER && data != RANGE_MARKER_HEADER && data != MASKED_FRAME_HEADER &&
+        data != CALIBRATION_HEADER && data != LOG_HEADER && data != BOOT_HEADER &&
+        data != STATUS_HEADER && data != PROFILE_HEADER && data != STACK_HEADER &&
+        data != PHASE_HEADER && data != ISR_HEADER)
+    {
+        return;
+    }
+    if (frame_length == 0 && data == LOG_HEADER && log_frames == 0)
+    {
+        log_start_ns = done_ns;
+    }
+    frame[frame_length++] = data;
+    if (frame_length == 2 && frame[0] == MASKED_FRAME_HEADER && ((frame[1] & 0x07) == 0 || frame[1] > 0x0F))
+    {
+        // Not a mode byte: resynchronize
+        frame_length = 0;
+        return;
+    }
+    if (frame_length == HostMain_FrameSize())
+    {
+        if (data == FRAME_FOOTER && frame[0] == FRAME_HEADER)
+        {
+            HostMain_DataFrame(1, 0x07);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == MASKED_FRAME_HEADER)
+        {
+            HostMain_DataFrame(2, frame[1]);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == STATS_HEADER)
+        {
+            stats_received++;
+            memcpy(last_stats, frame, STATS_FRAME_SIZE);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == SPECTRUM_HEADER && frame[1] < 3)
+        {
+            spectra_received++;
+            memcpy(last_spectrum[frame[1]], frame, SPECTRUM_FRAME_SIZE);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == CAPTURE_HEADER)
+        {
+            HostMain_CapturePacket();
+        }
+        else if (data == FRAME_FOOTER && frame[0] == EVENT_HEADER)
+        {
+            events_received[frame[1] & 0x03]++;
+        }
+        else if (data == FRAME_FOOTER && frame[0] == LOG_HEADER)
+        {
+            HostMain_LogFrame();
+            log_end_ns = done_ns;
+        }
+        else if (data == FRAME_FOOTER && frame[0] == PROFILE_HEADER)
+        {
+            uint16_t ticks = (uint16_t)(frame[1] | frame[2] << 8);
+            uint32_t mean = frame[3] | frame[4] << 8 | frame[5] << 16 | (uint32_t)frame[6] << 24;
+            uint32_t worst = frame[7] | frame[8] << 8 | frame[9] << 16 | (uint32_t)frame[10] << 24;
+            uint16_t samples = (uint16_t)(frame[11] | frame[12] << 8);
+            uint32_t window = frame[13] | frame[14] << 8 | frame[15] << 16 | (uint32_t)frame[16] << 24;
+            profiles_received++;
+            profile_ticks += ticks;
+            profile_sum_cycles += (double)mean * ticks;
+            profile_samples += samples;
+            profile_window_cycles += window;
+            profile_mhz = frame[17];
+            if (worst > profile_worst_cycles)
+            {
+                profile_worst_cycles = worst;
+            }
+        }
+        else if (data == FRAME_FOOTER && frame[0] == STACK_HEADER)
+        {
+            stack_reports++;
+            stack_size = (uint16_t)(frame[1] | frame[2] << 8);
+            stack_used = (uint16_t)(frame[3] | frame[4] << 8);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == PHASE_HEADER)
+        {
+            uint16_t ticks = (uint16_t)(frame[1] | frame[2] << 8);
+            int32_t interval_min = (int32_t)(frame[11] | frame[12] << 8 | frame[13] << 16 | (uint32_t)frame[14] << 24);
+            int32_t interval_max = (int32_t)(frame[15] | frame[16] << 8 | frame[17] << 16 | (uint32_t)frame[18] << 24);
+            uint32_t latency = frame[19] | frame[20] << 8 | frame[21] << 16 | (uint32_t)frame[22] << 24;
+            phase_reports++;
+            phase_ticks += ticks;
+            phase_merged += (uint16_t)(frame[3] | frame[4] << 8);
+            phase_early += (uint16_t)(frame[5] | frame[6] << 8);
+            phase_overruns += (uint16_t)(frame[7] | frame[8] << 8);
+            phase_drift_ppm = (int16_t)(frame[9] | frame[10] << 8);
+            if (interval_min <= interval_max && interval_min < phase_interval_min)
+            {
+                // Empty range when no interval was measured
+                phase_interval_min = interval_min;
+            }
+            if (interval_min <= interval_max && interval_max > phase_interval_max)
+            {
+                phase_interval_max = interval_max;
+            }
+            if (latency > phase_latency_max)
+            {
+                phase_latency_max = latency;
+            }
+        }
+        else if (data == FRAME_FOOTER && frame[0] == ISR_HEADER)
+        {
+            uint8_t i;
+            isr_reports++;
+            for (i = 0; i < 3; i++)
+            {
+                uint16_t cycles = (uint16_t)(frame[1 + 2 * i] | frame[2 + 2 * i] << 8);
+                if (cycles > isr_cycles_max[i])
+                {
+                    isr_cycles_max[i] = cycles;
+                }
+                isr_priorities[i] = frame[9 + i];
+            }
+            if ((uint16_t)(frame[7] | frame[8] << 8) > isr_delay_max_us)
+            {
+                isr_delay_max_us = (uint16_t)(frame[7] | frame[8] << 8);
+            }
+        }
+        else if (data == FRAME_FOOTER && frame[0] == STATUS_HEADER)
+        {
+            status_records++;
+            status_errors += (frame[3] != 0);
+            status_devices += (frame[1] == STATUS_DEVICE);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == BOOT_HEADER)
+        {
+            boot_records++;
+            memcpy(last_boot, frame, BOOT_FRAME_SIZE);
+            boot_ns = done_ns;
+        }
+        else if (data == FRAME_FOOTER && frame[0] == CALIBRATION_HEADER)
+        {
+            calibrations_received++;
+            memcpy(last_calibration, frame, CALIBRATION_FRAME_SIZE);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == RANGE_MARKER_HEADER)
+        {
+            range_markers++;
+            full_scale_g = (int32_t)(frame[1] | frame[2] << 8 | frame[3] << 16 | (uint32_t)frame[4] << 24);
+            sensitivity_mg = (int32_t)(frame[5] | frame[6] << 8 | frame[7] << 16 | (uint32_t)frame[8] << 24);
+        }
+        else if (data == FRAME_FOOTER && frame[0] == RATE_MARKER_HEADER)
+        {
+            rate_markers++;
+            stream_rate_hz = (int32_t)(frame[1] | frame[2] << 8 | frame[3] << 16 | (uint32_t)frame[4] << 24);
+        }
+        frame_length = 0;
+    }
+}
+
+static void HostMain_Entry(void)
+{
+    Firmware_Main();
+}
+
+int main(int argc, char* argv[])
+{
+    double seconds = 10.0;
+    FILE* capture = NULL;
+    FILE* trace = NULL;
+    LIS3DH_Model_Waveform waveform = { .offset_mg = {0, 0, 1000} };
+    int32_t error_offset_mg[3] = {0, 0, 0};
+    double error_gain_percent[3] = {0.0, 0.0, 0.0};
+    const char* eeprom = NULL;
+    const char* flash = NULL;
+    double boot_ms = 0.0;
+    int32_t odr_error_ppm = 0;
+    int check = 0;
+    double settle_ms = 0.0;
+
+    VirtualTime_Reset();
+    HostSim_Reset();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            capture = fopen(argv[++i], "wb");
+            if (capture == NULL)
+            {
+                perror(argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            trace = fopen(argv[++i], "w");
+            if (trace == NULL)
+            {
+                perror(argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "-v") == 0 && i + 2 < argc)
+        {
+            waveform.amplitude_mg[0] = atoi(argv[++i]);
+            waveform.frequency_hz[0] = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            waveform.noise_mg = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-g") == 0 && i + 2 < argc)
+        {
+            waveform.burst_on_s = atof(argv[++i]);
+            waveform.burst_off_s = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-k") == 0 && i + 2 < argc)
+        {
+            waveform.tap_every_s = atof(argv[++i]);
+            waveform.tap_mg = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-d") == 0 && i + 2 < argc)
+        {
+            waveform.fall_every_s = atof(argv[++i]);
+            waveform.fall_s = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 2 < argc)
+        {
+            waveform.tumble_at_s = atof(argv[++i]);
+            waveform.tumble_s = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 3 < argc)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                error_offset_mg[axis] = atoi(argv[++i]);
+            }
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 3 < argc)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                error_gain_percent[axis] = atof(argv[++i]);
+            }
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 2 < argc)
+        {
+            // One character per byte time at the default baud rate
+            uint64_t at_ns = (uint64_t)(atof(argv[++i]) * VIRTUAL_TIME_NS_PER_S);
+            for (const char* c = argv[++i]; *c != 0; c++)
+            {
+                HostSim_UartReceive((uint8_t)*c, at_ns);
+                at_ns += 10 * VIRTUAL_TIME_NS_PER_S / HOST_SIM_DEFAULT_BAUD;
+            }
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+        {
+            eeprom = argv[++i];
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            flash = argv[++i];
+        }
+        else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
+        {
+            boot_ms = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+        {
+            odr_error_ppm = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+        {
+            check = 1;
+            settle_ms = atof(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-t seconds] [-o uart_capture.bin] [-r trace.txt]\n"
+                            "       [-v amplitude_mg frequency_hz] [-n noise_mg] [-g on_s off_s]\n"
+                            "       [-k every_s mg] [-d every_s fall_s] [-p at_s dwell_s]\n"
+                            "       [-b x_mg y_mg z_mg] [-s x_%% y_%% z_%%] [-c at_s text] [-e eeprom.bin]\n"
+                            "       [-f flash.bin] [-u boot_ms] [-x ppm] [-a settle_ms]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    LIS3DH_Model_Reset();
+    LIS3DH_Model_SetWaveform(&waveform);
+    LIS3DH_Model_SetErrors(error_offset_mg, error_gain_percent);
+    LIS3DH_Model_SetBootTime((uint64_t)(boot_ms * 1e6));
+    LIS3DH_Model_SetOdrError(odr_error_ppm);
+    HostSim_SetEepromFile(eeprom);
+    HostSim_SetFlashFile(flash);
+    LIS3DH_Model_SetTrace(trace);
+    HostSim_SetUartCapture(capture);
+    HostSim_SetUartSink(HostMain_UartSink);
+    settle_ns = (uint64_t)(settle_ms * 1e6);
+
+    VirtualTime_Run(HostMain_Entry, (uint64_t)(seconds * VIRTUAL_TIME_NS_PER_S));
+    HostSim_UartFlush();
+
+    const HostSim_Stats* sim = HostSim_GetStats();
+    const LIS3DH_Model_Stats* model = LIS3DH_Model_GetStats();
+    double elapsed = (double)VirtualTime_Now() / VIRTUAL_TIME_NS_PER_S;
+
+    printf("Virtual time          : %.3f s\n", elapsed);
+    printf("LIS3DH ODR            : %u Hz\n", LIS3DH_Model_GetOdrHz());
+    printf("Samples generated     : %u\n", model->samples_generated);
+    printf("Samples read          : %u\n", model->samples_read);
+    printf("Samples missed        : %u (%u STATUS overruns, %u FIFO overruns)\n",
+           model->samples_missed, model->status_overruns, model->fifo_overruns);
+    printf("Samples double-read   : %u\n", model->samples_double_read);
+    if (model->samples_read > 0)
+    {
+        printf("Sample-to-read latency: %.3f ms mean, %.3f ms max\n",
+               model->total_read_latency_ns / 1e6 / model->samples_read,
+               model->max_read_latency_ns / 1e6);
+    }
+    printf("Activity sleeps/wakes : %u / %u\n", model->activity_sleeps, model->activity_wakes);
+    printf("Clicks/double/INT1    : %u / %u / %u in the model, %u / %u / %u events received\n",
+           model->clicks, model->double_clicks, model->int1_events,
+           events_received[1], events_received[2], events_received[3]);
+    printf("Frames received       : %u (%.1f/s)\n", frames_received, frames_received / elapsed);
+    if (frames_received > 0)
+    {
+        printf("Peak |a| in the frames: X %.0f  Y %.0f  Z %.0f mg (%u values clipped by the model)\n",
+               frame_peak_mg[0], frame_peak_mg[1], frame_peak_mg[2], model->values_clipped);
+        printf("Mean a in the frames  : X %.0f  Y %.0f  Z %.0f mg (%u high-pass filter resets)\n",
+               frame_sum_mg[0] / frames_received, frame_sum_mg[1] / frames_received,
+               frame_sum_mg[2] / frames_received, model->filter_resets);
+    }
+    if (range_markers > 0)
+    {
+        printf("Range markers         : %u for %u full-scale changes in the model (last at +/- %d g, %d mg/digit)\n",
+               range_markers, model->range_changes, full_scale_g, sensitivity_mg);
+    }
+    if (calibrations_received > 0)
+    {
+        const uint8_t* v = &last_calibration[3];
+        printf("Calibration frames    : %u, last one state %u, positions 0x%02X, %u flash rows written\n",
+               calibrations_received, last_calibration[1], last_calibration[2], sim->flash_rows_written);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            printf("  %c: offset %5d mg  gain %.4f\n", "XYZ"[axis],
+                   (int16_t)(v[2 * axis] | v[2 * axis + 1] << 8),
+                   (uint16_t)(v[6 + 2 * axis] | v[7 + 2 * axis] << 8) / 16384.0);
+        }
+    }
+    if (profiles_received > 0)
+    {
+        double samples_per_s = profile_samples * 1e6 * profile_mhz / profile_window_cycles;
+        printf("Profile frames        : %u, %.0f cycles per tick on average, %u worst\n",
+               profiles_received, profile_sum_cycles / profile_ticks, profile_worst_cycles);
+        printf("Clock profile         : %u MHz, %.1f samples/s (%.2f per MHz), %.1f %% idle\n",
+               profile_mhz, samples_per_s, samples_per_s / profile_mhz,
+               100.0 * (1.0 - profile_sum_cycles / profile_window_cycles));
+    }
+    if (stack_reports > 0)
+    {
+        printf("Stack reports         : %u, %u of %u bytes used at most\n",
+               stack_reports, stack_used, stack_size);
+    }
+    if (phase_reports > 0)
+    {
+        printf("Phase reports         : %u, %llu ticks (%u merged), %u early, %u overruns, drift %d ppm\n",
+               phase_reports, (unsigned long long)phase_ticks, phase_merged, phase_early,
+               phase_overruns, phase_drift_ppm);
+        if (phase_interval_min <= phase_interval_max)
+        {
+            printf("Tick timing           : interval %+d to %+d cycles off the period, service %u cycles late at most\n",
+                   phase_interval_min, phase_interval_max, phase_latency_max);
+        }
+    }
+    if (isr_reports > 0)
+    {
+        printf("Interrupt reports     : %u, longest runs Timer %u, I2C %u, UART %u cycles, tick delay %u us at most\n",
+               isr_reports, isr_cycles_max[0], isr_cycles_max[1], isr_cycles_max[2], isr_delay_max_us);
+        printf("Interrupt priorities  : Timer %u, I2C %u, UART ", isr_priorities[0], isr_priorities[1]);
+        if (isr_priorities[2] == 0xFF)
+        {
+            printf("none\n");
+        }
+        else
+        {
+            printf("%u\n", isr_priorities[2]);
+        }
+    }
+    if (status_records > 0)
+    {
+        printf("Status records        : %u (%u I2C errors, %u devices on the bus)\n",
+               status_records, status_errors, status_devices);
+    }
+    if (boot_records > 0)
+    {
+        uint32_t boot_us = last_boot[3] | last_boot[4] << 8 | last_boot[5] << 16 | (uint32_t)last_boot[6] << 24;
+        printf("Boot record           : WHO_AM_I 0x%02X, flags 0x%02X, ", last_boot[1], last_boot[2]);
+        if (boot_us == 0xFFFFFFFFu)
+        {
+            printf("no sample\n");
+        }
+        else
+        {
+            printf("first sample after %.3f ms (model: first read at %.3f ms)\n",
+                   boot_us / 1e3, model->first_read_ns / 1e6);
+        }
+        printf("Samples after settling: %u missed, %u double-read (from %.0f ms after the boot record)\n",
+               model->samples_missed - settle_missed, model->samples_double_read - settle_double_read,
+               settle_ms);
+    }
+    if (log_frames > 0)
+    {
+        printf("Log dump frames       : %u, %u rows (sequence %u to %u), %u decode errors, in %.3f s\n",
+               log_frames, log_rows, log_first_sequence, log_last_sequence, log_errors,
+               (log_end_ns - log_start_ns) / 1e9);
+    }
+    if (log_samples > 0)
+    {
+        printf("Log samples           : %u, %.2f bytes each with the row headers, mean X %.0f  Y %.0f  Z %.0f mg\n",
+               log_samples, (double)log_bytes / log_samples, log_sum_mg[0] / log_samples,
+               log_sum_mg[1] / log_samples, log_sum_mg[2] / log_samples);
+    }
+    if (rate_markers > 0)
+    {
+        printf("Rate markers          : %u (last at %d Hz)\n", rate_markers, stream_rate_hz);
+    }
+    if (stats_received > 0)
+    {
+        printf("Statistics frames     : %u, last one in mg:\n", stats_received);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const uint8_t* v = &last_stats[1 + 10 * axis];
+            printf("  %c: mean %6d  rms %5u  min %6d  max %6d  crest %.2f\n", "XYZ"[axis],
+                   (int16_t)(v[0] | v[1] << 8), (uint16_t)(v[2] | v[3] << 8),
+                   (int16_t)(v[4] | v[5] << 8), (int16_t)(v[6] | v[7] << 8),
+                   (uint16_t)(v[8] | v[9] << 8) / 256.0);
+        }
+    }
+    if (spectra_received > 0)
+    {
+        printf("Spectrum frames       : %u, last ones (bands in mg, or peaks in Hz and mg):\n", spectra_received);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            printf("  %c:", "XYZ"[axis]);
+            for (int i = 0; i < 8; i++)
+            {
+                printf(" %6u", last_spectrum[axis][2 + 2 * i] | last_spectrum[axis][3 + 2 * i] << 8);
+            }
+            printf("\n");
+        }
+    }
+    if (captures_received > 0)
+    {
+        printf("Captures              : %u, last one %u samples (%u before the trigger), "
+               "|a| %.0f mg at the trigger, %.0f mg peak\n", captures_received, capture_samples,
+               capture_pre_samples, capture_trigger_mg, capture_peak_mg);
+    }
+    printf("Timer ticks / ISRs    : %u / %u\n", sim->timer_ticks, sim->timer_isr_calls);
+    printf("I2C transactions      : %u (%u bytes, %u NAK)\n",
+           sim->i2c_transactions, sim->i2c_bytes, sim->i2c_naks);
+    printf("I2C bus utilization   : %.1f %%\n", 100.0 * sim->i2c_busy_ns / VirtualTime_Now());
+    printf("UART bytes            : %u (%.0f bps)\n", sim->uart_bytes, sim->uart_bytes * 10.0 / elapsed);
+    printf("UART blocked          : %.3f s\n", (double)sim->uart_blocked_ns / VIRTUAL_TIME_NS_PER_S);
+    printf("CyDelay               : %.3f s\n", (double)sim->delay_ns / VIRTUAL_TIME_NS_PER_S);
+    printf("CPU halted            : %.3f s (%.1f %% idle, %u wakeups)\n",
+           (double)sim->sleep_ns / VIRTUAL_TIME_NS_PER_S, 100.0 * sim->sleep_ns / VirtualTime_Now(),
+           sim->sleeps);
+
+    if (capture != NULL)
+    {
+        fclose(capture);
+    }
+    if (trace != NULL)
+    {
+        fclose(trace);
+    }
+    if (check && (model->samples_missed > settle_missed || model->samples_double_read > settle_double_read))
+    {
+        printf("FAIL: samples missed or read twice after the start of the stream\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
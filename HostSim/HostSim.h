@@ -0,0 +1,157 @@
+/**
+*   \file HostSim.h
+*   \brief Controls and counters of the simulated PSoC components.
+*
+*   This is the interface used by the host harness to configure the
+*   simulated I2C_Master, UART_Debug and Timer and to collect what
+*   happened during a run. The firmware never includes this file.
+*/
+
+#ifndef __HOST_SIM_H
+    #define __HOST_SIM_H
+
+    #include <stdint.h>
+    #include <stdio.h>
+
+    /**
+    *   \brief I2C bus speed set in TopDesign.
+    */
+    #define HOST_SIM_DEFAULT_I2C_HZ 100000u
+
+    /**
+    *   \brief UART_Debug baud rate set in TopDesign.
+    */
+    #define HOST_SIM_DEFAULT_BAUD 19200u
+
+    /**
+    *   \brief Bus clock set in the design, feeding the UART_Debug clock
+    *   divider, and clocks per bit.
+    */
+    #define HOST_SIM_BUS_CLK_HZ 24000000u
+    #define HOST_SIM_UART_OVERSAMPLE 8u
+
+    /**
+    *   \brief Time taken by a read of a status register in a polling loop.
+    */
+    #define HOST_SIM_STATUS_POLL_NS 500u
+
+    /**
+    *   \brief Bytes that can be queued in the UART before PutChar blocks.
+    *
+    *   The component is configured with the 4-byte hardware FIFO only,
+    *   plus the byte being shifted out.
+    */
+    #define HOST_SIM_UART_TX_DEPTH 5u
+
+    /**
+    *   \brief Bytes the harness can queue for the UART receiver.
+    */
+    #define HOST_SIM_UART_RX_DEPTH 64u
+
+    /**
+    *   \brief Time taken to erase and program a flash row of the PSoC 5LP.
+    */
+    #define HOST_SIM_FLASH_ROW_WRITE_NS 15000000ull
+
+    /**
+    *   \brief Largest emulated EEPROM the simulation keeps.
+    */
+    #define HOST_SIM_EEPROM_MAX_SIZE 4096u
+
+    /**
+    *   \brief Flash of the simulated part.
+    */
+    #define HOST_SIM_FLASH_SIZE 0x40000u
+
+    /**
+    *   \brief Counters of the simulated components.
+    */
+    typedef struct {
+        uint32_t i2c_transactions;      ///< Start conditions sent
+        uint32_t i2c_bytes;             ///< Bytes transferred on the bus
+        uint32_t i2c_naks;              ///< Transfers not acknowledged
+        uint64_t i2c_busy_ns;           ///< Time the bus was busy
+        uint32_t uart_bytes;            ///< Bytes transmitted
+        uint64_t uart_blocked_ns;       ///< Time spent waiting in PutChar
+        uint32_t uart_rx_bytes;         ///< Bytes received by the firmware
+        uint32_t flash_rows_written;    ///< Flash rows programmed
+        uint32_t timer_ticks;           ///< Timer terminal counts
+        uint32_t timer_isr_calls;       ///< Timer interrupts serviced
+        uint64_t delay_ns;              ///< Time spent in CyDelay
+        uint32_t sleeps;                ///< Halts of the CPU (CY_PM_WFI, CyPmAltAct)
+        uint64_t sleep_ns;              ///< Time the CPU was halted
+    } HostSim_Stats;
+
+    /**
+    *   \brief Reset all the simulated components and their counters.
+    */
+    void HostSim_Reset(void);
+
+    /**
+    *   \brief Set the I2C bus speed in Hz.
+    */
+    void HostSim_SetI2CSpeed(uint32_t hz);
+
+    /**
+    *   \brief Set the UART baud rate.
+    */
+    void HostSim_SetBaudRate(uint32_t baud);
+
+    /**
+    *   \brief Set the bus clock the UART_Debug clock divider is applied to.
+    */
+    void HostSim_SetBusClock(uint32_t hz);
+
+    /**
+    *   \brief Write every transmitted byte to the given file (NULL to stop).
+    */
+    void HostSim_SetUartCapture(FILE* file);
+
+    /**
+    *   \brief Callback invoked for every byte once it is completely sent.
+    */
+    typedef void (*HostSim_UartSink)(uint8_t data, uint64_t done_ns);
+
+    /**
+    *   \brief Register the callback receiving the transmitted bytes.
+    */
+    void HostSim_SetUartSink(HostSim_UartSink sink);
+
+    /**
+    *   \brief Queue a byte for the UART receiver, readable from the given
+    *   virtual time on. Bytes must be queued in order of time.
+    *   \retval Non-zero if the queue was full and the byte was dropped.
+    */
+    uint8_t HostSim_UartReceive(uint8_t data, uint64_t at_ns);
+
+    /**
+    *   \brief Keep the emulated EEPROM in the given file, loaded at
+    *   Cy_Em_EEPROM_Init and saved at every write (NULL to keep it in RAM).
+    */
+    void HostSim_SetEepromFile(const char* path);
+
+    /**
+    *   \brief Load the flash from the given file, blank if it does not
+    *   exist, and save it there at every row programmed (NULL to keep it
+    *   in RAM).
+    */
+    void HostSim_SetFlashFile(const char* path);
+
+    /**
+    *   \brief Deliver all the bytes still queued in the UART FIFO.
+    */
+    void HostSim_UartFlush(void);
+
+    /**
+    *   \brief Counters collected since the last reset.
+    */
+    const HostSim_Stats* HostSim_GetStats(void);
+
+    /**
+    *   \brief Deliver an interrupt if the global enable allows it.
+    *   \retval Non-zero if the handler was called.
+    */
+    uint8_t HostSim_RaiseInterrupt(void (*handler)(void));
+
+#endif
+/* [] END OF FILE */
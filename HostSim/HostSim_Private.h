@@ -0,0 +1,21 @@
+/**
+*   \file HostSim_Private.h
+*   \brief State shared between the simulated components.
+*/
+
+#ifndef __HOST_SIM_PRIVATE_H
+    #define __HOST_SIM_PRIVATE_H
+
+    #include "HostSim.h"
+
+    /**
+    *   \brief Counters updated by all the simulated components.
+    */
+    extern HostSim_Stats host_sim_stats;
+
+    void HostSim_I2CReset(void);
+    void HostSim_UartReset(void);
+    void HostSim_TimerReset(void);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,106 @@
+/*
+* This file includes the simulated I2C_Master component: every blocking
+* master call is forwarded to the LIS3DH model and costs the bus time of
+* the corresponding bits.
+*/
+
+#include "I2C_Master.h"
+#include "HostSim.h"
+#include "HostSim_Private.h"
+#include "LIS3DH_Model.h"
+#include "VirtualTime.h"
+
+/**
+*   \brief Bits on the bus for a byte plus its acknowledge.
+*/
+#define I2C_BITS_PER_BYTE 9u
+
+static uint32_t bus_hz = HOST_SIM_DEFAULT_I2C_HZ;
+static uint8_t addressed;
+
+void HostSim_SetI2CSpeed(uint32_t hz)
+{
+    bus_hz = hz;
+}
+
+void HostSim_I2CReset(void)
+{
+    bus_hz = HOST_SIM_DEFAULT_I2C_HZ;
+    addressed = 0;
+}
+
+static void I2C_Master_Sim_Clock(uint32_t bits)
+{
+    uint64_t ns = (uint64_t)bits * VIRTUAL_TIME_NS_PER_S / bus_hz;
+    host_sim_stats.i2c_busy_ns += ns;
+    VirtualTime_Advance(ns);
+}
+
+void I2C_Master_Start(void)
+{
+    addressed = 0;
+}
+
+void I2C_Master_Stop(void)
+{
+    addressed = 0;
+}
+
+uint8 I2C_Master_MasterSendStart(uint8 slaveAddress, uint8 R_nW)
+{
+    host_sim_stats.i2c_transactions++;
+    host_sim_stats.i2c_bytes++;
+    // Start condition followed by the address byte
+    I2C_Master_Sim_Clock(1u + I2C_BITS_PER_BYTE);
+    if (slaveAddress != LIS3DH_MODEL_ADDRESS || !LIS3DH_Model_Ready())
+    {
+        addressed = 0;
+        host_sim_stats.i2c_naks++;
+        return I2C_Master_MSTR_ERR_LB_NAK;
+    }
+    addressed = 1;
+    LIS3DH_Model_I2CStart(R_nW == I2C_Master_READ_XFER_MODE);
+    return I2C_Master_MSTR_NO_ERROR;
+}
+
+uint8 I2C_Master_MasterSendRestart(uint8 slaveAddress, uint8 R_nW)
+{
+    return I2C_Master_MasterSendStart(slaveAddress, R_nW);
+}
+
+uint8 I2C_Master_MasterSendStop(void)
+{
+    I2C_Master_Sim_Clock(1u);
+    if (addressed)
+    {
+        LIS3DH_Model_I2CStop();
+    }
+    addressed = 0;
+    return I2C_Master_MSTR_NO_ERROR;
+}
+
+uint8 I2C_Master_MasterWriteByte(uint8 theByte)
+{
+    host_sim_stats.i2c_bytes++;
+    I2C_Master_Sim_Clock(I2C_BITS_PER_BYTE);
+    if (!addressed)
+    {
+        return I2C_Master_MSTR_NOT_READY;
+    }
+    LIS3DH_Model_I2CWrite(theByte);
+    return I2C_Master_MSTR_NO_ERROR;
+}
+
+uint8 I2C_Master_MasterReadByte(uint8 acknNak)
+{
+    (void)acknNak;
+    host_sim_stats.i2c_bytes++;
+    I2C_Master_Sim_Clock(I2C_BITS_PER_BYTE);
+    if (!addressed)
+    {
+        return 0xFF;
+    }
+    return LIS3DH_Model_I2CRead();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,990 @@
+/*
+* This file includes the behavioral model of the LIS3DH accelerometer
+* used by the simulated I2C_Master.
+*/
+
+#include "LIS3DH_Model.h"
+#include "VirtualTime.h"
+
+#include <math.h>
+#include <string.h>
+
+#define REG_STATUS_REG_AUX  0x07
+#define REG_OUT_ADC3_L      0x0C
+#define REG_OUT_ADC3_H      0x0D
+#define REG_WHO_AM_I        0x0F
+#define REG_TEMP_CFG_REG    0x1F
+#define REG_CTRL_REG1       0x20
+#define REG_CTRL_REG2       0x21
+#define REG_CTRL_REG4       0x23
+#define REG_CTRL_REG5       0x24
+#define REG_REFERENCE       0x26
+#define REG_STATUS_REG      0x27
+#define REG_OUT_X_L         0x28
+#define REG_OUT_Z_H         0x2D
+#define REG_FIFO_CTRL_REG   0x2E
+#define REG_FIFO_SRC_REG    0x2F
+#define REG_INT1_CFG        0x30
+#define REG_INT1_SRC        0x31
+#define REG_INT1_THS        0x32
+#define REG_INT1_DURATION   0x33
+#define REG_CLICK_CFG       0x38
+#define REG_CLICK_SRC       0x39
+#define REG_CLICK_THS       0x3A
+#define REG_TIME_LIMIT      0x3B
+#define REG_TIME_LATENCY    0x3C
+#define REG_TIME_WINDOW     0x3D
+#define REG_ACT_THS         0x3E
+#define REG_ACT_DUR         0x3F
+
+#define WHO_AM_I_VALUE      0x33
+
+#define STATUS_XDA          0x01
+#define STATUS_ZYXDA        0x08
+#define STATUS_XOR          0x10
+#define STATUS_ZYXOR        0x80
+
+#define CTRL_REG1_LPEN      0x08
+#define CTRL_REG1_XYZEN     0x07
+#define CTRL_REG2_HPM       0xC0
+#define CTRL_REG2_HPCF      0x30
+#define CTRL_REG2_FDS       0x08
+#define CTRL_REG2_HP_CLICK  0x04
+#define CTRL_REG4_BDU       0x80
+#define CTRL_REG4_HR        0x08
+#define CTRL_REG4_FS        0x30
+#define CTRL_REG5_FIFO_EN   0x40
+#define CTRL_REG5_LIR_INT1  0x08
+#define TEMP_CFG_ADC_EN     0x80
+#define TEMP_CFG_TEMP_EN    0x40
+
+#define FIFO_MODE_BYPASS    0x00
+#define FIFO_MODE_FIFO      0x01
+#define FIFO_MODE_STREAM    0x02
+
+#define FIFO_SRC_WTM        0x80
+#define FIFO_SRC_OVRN       0x40
+#define FIFO_SRC_EMPTY      0x20
+
+#define INT1_CFG_AOI        0x80
+#define CLICK_THS_LIR       0x80
+#define SRC_IA              0x40
+#define CLICK_SRC_DCLICK    0x20
+#define CLICK_SRC_SCLICK    0x10
+#define CLICK_SRC_SIGN      0x08
+
+#define SUBADDRESS_AUTO_INCREMENT 0x80
+
+/**
+*   \brief Length of the taps of the waveform.
+*/
+#define TAP_LENGTH_S        0.010
+
+/**
+*   \brief Output data rate while asleep for inactivity (low-power mode).
+*/
+#define ACT_SLEEP_ODR_HZ    10
+
+/**
+*   \brief Temperature at which OUT_ADC3 reads zero.
+*/
+#define TEMPERATURE_REFERENCE_C 25
+
+/**
+*   \brief A sample followed from generation until it is read or lost.
+*/
+typedef struct {
+    int16_t out[3];             ///< Left-justified output words
+    uint32_t seq;               ///< Sequence number since reset
+    uint64_t t_ns;              ///< Generation time
+    uint8_t h_reads[3];         ///< Reads of the high byte of each axis
+    uint8_t read_reported;      ///< Counted as read
+    uint8_t double_reported;    ///< Counted as double-read
+} LIS3DH_Model_Sample;
+
+/**
+*   \brief Output data rates selected by CTRL_REG1[7:4] in normal mode.
+*/
+static const uint32_t odr_table_hz[16] = {
+    0, 1, 10, 25, 50, 100, 200, 400, 1600, 1344, 0, 0, 0, 0, 0, 0
+};
+
+static uint8_t registers[0x40];
+static uint8_t register_pointer;
+static uint8_t auto_increment;
+static uint8_t expecting_subaddress;
+static uint64_t next_sample_ns;
+static int32_t odr_error_ppm;
+static uint32_t next_seq;
+
+static LIS3DH_Model_Sample presented;
+static uint8_t presented_valid;
+static LIS3DH_Model_Sample bdu_pending;
+static uint8_t bdu_pending_valid;
+static uint8_t axis_locked[3];
+
+static LIS3DH_Model_Sample fifo[LIS3DH_MODEL_FIFO_DEPTH];
+static uint8_t fifo_head;
+static uint8_t fifo_count;
+static uint8_t fifo_overrun;
+
+static LIS3DH_Model_Waveform waveform;
+static LIS3DH_Model_Source source;
+static uint32_t noise_state;
+static int32_t temperature_c;
+static FILE* trace;
+static uint64_t last_read_sample_ns;
+static uint64_t ready_ns;
+static uint8_t act_sleeping;
+static uint32_t inactive_samples;
+static uint32_t int1_samples;
+static uint8_t int1_active;
+static int32_t click_lowpass_mg[3];
+static double output_lowpass_mg[3];
+static int32_t output_input_mg[3];
+static uint32_t click_run;
+static uint8_t click_axes;
+static uint32_t click_quiet;
+static uint32_t click_window;
+static uint8_t click_first;
+static int32_t error_offset_mg[3];
+static double error_gain[3];
+static LIS3DH_Model_Stats stats;
+
+uint32_t LIS3DH_Model_GetOdrHz(void)
+{
+    if (act_sleeping)
+    {
+        return ACT_SLEEP_ODR_HZ;
+    }
+    uint8_t odr = registers[REG_CTRL_REG1] >> 4;
+    if (odr == 9 && (registers[REG_CTRL_REG1] & CTRL_REG1_LPEN))
+    {
+        return 5376;
+    }
+    return odr_table_hz[odr];
+}
+
+static uint8_t LIS3DH_Model_FifoMode(void)
+{
+    if ((registers[REG_CTRL_REG5] & CTRL_REG5_FIFO_EN) == 0)
+    {
+        return FIFO_MODE_BYPASS;
+    }
+    return registers[REG_FIFO_CTRL_REG] >> 6;
+}
+
+/*
+* Convert an acceleration in mg to the left-justified output word for the
+* current full scale and operating mode.
+*/
+static int16_t LIS3DH_Model_Encode(int32_t mg)
+{
+    static const int32_t sens_hr_mg[4] = {1, 2, 4, 12};
+    uint8_t fs = (registers[REG_CTRL_REG4] >> 4) & 0x03;
+    int32_t bits;
+    int32_t sens;
+
+    if ((registers[REG_CTRL_REG1] & CTRL_REG1_LPEN) || act_sleeping)
+    {
+        bits = 8;
+        sens = sens_hr_mg[fs] * 16;
+    }
+    else if (registers[REG_CTRL_REG4] & CTRL_REG4_HR)
+    {
+        bits = 12;
+        sens = sens_hr_mg[fs];
+    }
+    else
+    {
+        bits = 10;
+        sens = sens_hr_mg[fs] * 4;
+    }
+
+    int32_t counts = mg / sens;
+    int32_t limit = 1 << (bits - 1);
+    if (counts > limit - 1)
+    {
+        counts = limit - 1;
+        stats.values_clipped++;
+    }
+    if (counts < -limit)
+    {
+        counts = -limit;
+        stats.values_clipped++;
+    }
+    return (int16_t)(counts * (1 << (16 - bits)));
+}
+
+static void LIS3DH_Model_Acceleration(uint64_t t_ns, int32_t mg[3])
+{
+    if (source != NULL)
+    {
+        source(t_ns, mg);
+        return;
+    }
+    double t = (double)t_ns / VIRTUAL_TIME_NS_PER_S;
+    double gain = 1.0;
+    if (waveform.burst_on_s > 0 &&
+        fmod(t, waveform.burst_on_s + waveform.burst_off_s) >= waveform.burst_on_s)
+    {
+        gain = 0.0;
+    }
+    // Taps and falls happen halfway through their period
+    double tap = waveform.tap_every_s > 0 ? fmod(t, waveform.tap_every_s) - waveform.tap_every_s / 2 : -1.0;
+    double fall = waveform.fall_every_s > 0 ? fmod(t, waveform.fall_every_s) - waveform.fall_every_s / 2 : -1.0;
+    int32_t gravity_mg[3] = {waveform.offset_mg[0], waveform.offset_mg[1], waveform.offset_mg[2]};
+    if (waveform.tumble_s > 0 && t >= waveform.tumble_at_s && t < waveform.tumble_at_s + 6 * waveform.tumble_s)
+    {
+        int position = (int)((t - waveform.tumble_at_s) / waveform.tumble_s);
+        memset(gravity_mg, 0, sizeof(gravity_mg));
+        gravity_mg[position / 2] = (position & 1) ? -1000 : 1000;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        double value = gravity_mg[axis] +
+            gain * waveform.amplitude_mg[axis] * sin(2.0 * M_PI * waveform.frequency_hz[axis] * t);
+        if (axis == 2 && tap >= 0.0 && tap < TAP_LENGTH_S)
+        {
+            value += waveform.tap_mg * sin(M_PI * tap / TAP_LENGTH_S);
+        }
+        if (fall >= 0.0 && fall < waveform.fall_s)
+        {
+            value = 0.0;
+        }
+        if (waveform.noise_mg > 0)
+        {
+            // Deterministic uniform noise, so that runs are reproducible
+            noise_state = noise_state * 1664525u + 1013904223u;
+            value += (int32_t)(noise_state >> 16) % (2 * waveform.noise_mg + 1) - waveform.noise_mg;
+        }
+        mg[axis] = (int32_t)lround(value);
+    }
+}
+
+static void LIS3DH_Model_Trace(const char* event, const LIS3DH_Model_Sample* sample)
+{
+    if (trace != NULL)
+    {
+        fprintf(trace, "%12.6f s  sample #%-8u %-12s (generated at %.6f s)\n",
+                (double)VirtualTime_Now() / VIRTUAL_TIME_NS_PER_S, sample->seq, event,
+                (double)sample->t_ns / VIRTUAL_TIME_NS_PER_S);
+    }
+}
+
+/*
+* A sample leaves the output registers or the FIFO: if it was never read
+* completely, it is lost for the firmware.
+*/
+static void LIS3DH_Model_Retire(LIS3DH_Model_Sample* sample)
+{
+    if (!sample->read_reported)
+    {
+        stats.samples_missed++;
+        LIS3DH_Model_Trace("missed", sample);
+    }
+}
+
+/*
+* Sample currently visible in the OUT_X/Y/Z registers.
+*/
+static LIS3DH_Model_Sample* LIS3DH_Model_Head(void)
+{
+    if (LIS3DH_Model_FifoMode() != FIFO_MODE_BYPASS)
+    {
+        return fifo_count > 0 ? &fifo[fifo_head] : NULL;
+    }
+    return presented_valid ? &presented : NULL;
+}
+
+static void LIS3DH_Model_Present(const LIS3DH_Model_Sample* sample)
+{
+    uint8_t status = registers[REG_STATUS_REG];
+    if (presented_valid)
+    {
+        LIS3DH_Model_Retire(&presented);
+    }
+    // Enabled axes whose previous data were not read are overrun
+    uint8_t enabled = registers[REG_CTRL_REG1] & CTRL_REG1_XYZEN;
+    uint8_t overrun = (uint8_t)((status & enabled) << 4);
+    if (overrun)
+    {
+        status |= overrun | STATUS_ZYXOR;
+        stats.status_overruns++;
+    }
+    registers[REG_STATUS_REG] = status | enabled | STATUS_ZYXDA;
+    presented = *sample;
+    presented_valid = 1;
+}
+
+static void LIS3DH_Model_FifoDrop(void)
+{
+    fifo_head = (fifo_head + 1) % LIS3DH_MODEL_FIFO_DEPTH;
+    fifo_count--;
+}
+
+static void LIS3DH_Model_FifoClear(void)
+{
+    while (fifo_count > 0)
+    {
+        LIS3DH_Model_Retire(&fifo[fifo_head]);
+        LIS3DH_Model_FifoDrop();
+    }
+    fifo_overrun = 0;
+}
+
+/*
+* Sleep-to-wake engine: with ACT_THS set, the device falls back to 10 Hz
+* low-power mode after all the axes stay below the threshold for ACT_DUR,
+* and returns to the configured mode as soon as one axis exceeds it.
+*/
+static void LIS3DH_Model_Activity(const int32_t mg[3])
+{
+    static const int32_t ths_lsb_mg[4] = {16, 32, 62, 186};
+    uint8_t ths = registers[REG_ACT_THS] & 0x7F;
+    int32_t ths_mg = ths * ths_lsb_mg[(registers[REG_CTRL_REG4] >> 4) & 0x03];
+    uint8_t active = 0;
+
+    if (ths == 0)
+    {
+        act_sleeping = 0;
+        inactive_samples = 0;
+        return;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (mg[axis] > ths_mg || mg[axis] < -ths_mg)
+        {
+            active = 1;
+        }
+    }
+    if (active)
+    {
+        inactive_samples = 0;
+        if (act_sleeping)
+        {
+            act_sleeping = 0;
+            stats.activity_wakes++;
+        }
+        return;
+    }
+    // Duration is (8 ACT_DUR + 1) / ODR, counted at the configured rate
+    if (!act_sleeping && ++inactive_samples >= 8u * registers[REG_ACT_DUR] + 1u)
+    {
+        act_sleeping = 1;
+        stats.activity_sleeps++;
+    }
+}
+
+/*
+* Interrupt generator 1: the enabled high and low events of the axes,
+* combined with AND or OR, must hold for INT1_DURATION samples. The source
+* register stays set until read when latched.
+*/
+static void LIS3DH_Model_Interrupt1(const int32_t mg[3])
+{
+    static const int32_t ths_lsb_mg[4] = {16, 32, 62, 186};
+    uint8_t cfg = registers[REG_INT1_CFG];
+    int32_t ths_mg = (registers[REG_INT1_THS] & 0x7F) * ths_lsb_mg[(registers[REG_CTRL_REG4] >> 4) & 0x03];
+    uint8_t events = 0;
+    uint8_t active;
+
+    if ((cfg & 0x3F) == 0)
+    {
+        return;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int32_t value = mg[axis] < 0 ? -mg[axis] : mg[axis];
+        events |= (uint8_t)((value > ths_mg ? 0x02 : 0x01) << (2 * axis));
+    }
+    events &= cfg & 0x3F;
+    active = (cfg & INT1_CFG_AOI) ? events == (cfg & 0x3F) : events != 0;
+
+    if (!active)
+    {
+        int1_samples = 0;
+        int1_active = 0;
+        if (!(registers[REG_CTRL_REG5] & CTRL_REG5_LIR_INT1))
+        {
+            registers[REG_INT1_SRC] = 0;
+        }
+        return;
+    }
+    if (++int1_samples > registers[REG_INT1_DURATION] && !int1_active)
+    {
+        int1_active = 1;
+        stats.int1_events++;
+    }
+    if (int1_active)
+    {
+        registers[REG_INT1_SRC] = SRC_IA | events;
+    }
+}
+
+/*
+* High-pass filter on the output data when FDS is set: first order, with
+* the cut-off at ODR / (50 << HPCF). The interrupt generator and the
+* activity engine keep the unfiltered data.
+*/
+static void LIS3DH_Model_HighPass(int32_t mg[3])
+{
+    uint8_t cfg = registers[REG_CTRL_REG2];
+    double k = 2.0 * M_PI / (50 << ((cfg & CTRL_REG2_HPCF) >> 4));
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        output_input_mg[axis] = mg[axis];
+        if (cfg & CTRL_REG2_FDS)
+        {
+            double value = mg[axis] - output_lowpass_mg[axis];
+            output_lowpass_mg[axis] += k * value;
+            mg[axis] = (int32_t)lround(value);
+        }
+    }
+}
+
+/*
+* Click engine: a click is a crossing of CLICK_THS (FS / 128 per LSB) by
+* an enabled axis that ends within TIME_LIMIT samples. A double click is
+* a second click starting after TIME_LATENCY and within TIME_WINDOW.
+*/
+static void LIS3DH_Model_Click(const int32_t mg[3])
+{
+    static const int32_t fs_mg[4] = {2000, 4000, 8000, 16000};
+    uint8_t cfg = registers[REG_CLICK_CFG];
+    int32_t ths_mg = (registers[REG_CLICK_THS] & 0x7F) * fs_mg[(registers[REG_CTRL_REG4] >> 4) & 0x03] / 128;
+    uint8_t axes = 0;
+    uint8_t source = 0;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int32_t value = mg[axis];
+        if (registers[REG_CTRL_REG2] & CTRL_REG2_HP_CLICK)
+        {
+            // First-order high-pass filter, so that gravity does not count
+            value -= click_lowpass_mg[axis];
+            click_lowpass_mg[axis] += value / 16;
+        }
+        if ((cfg & (0x03 << (2 * axis))) && (value > ths_mg || value < -ths_mg))
+        {
+            axes |= (uint8_t)(1 << axis);
+        }
+    }
+    if ((cfg & 0x3F) == 0 || ths_mg == 0)
+    {
+        return;
+    }
+
+    if (click_quiet > 0)
+    {
+        click_quiet--;
+        if (click_quiet == 0 && click_first)
+        {
+            click_window = registers[REG_TIME_WINDOW];
+        }
+    }
+    else if (click_window > 0 && --click_window == 0)
+    {
+        click_first = 0;
+    }
+
+    if (axes)
+    {
+        click_run++;
+        click_axes |= axes;
+        return;
+    }
+    if (click_run == 0)
+    {
+        return;
+    }
+    uint8_t clicked = click_run <= registers[REG_TIME_LIMIT] && click_quiet == 0;
+    uint8_t clicked_axes = click_axes;
+    click_run = 0;
+    click_axes = 0;
+    if (!clicked)
+    {
+        return;
+    }
+
+    if (cfg & 0x15)
+    {
+        source = SRC_IA | CLICK_SRC_SCLICK;
+        stats.clicks++;
+    }
+    if (cfg & 0x2A)
+    {
+        if (click_first && click_window > 0)
+        {
+            source = SRC_IA | CLICK_SRC_DCLICK;
+            click_first = 0;
+            click_window = 0;
+            stats.double_clicks++;
+        }
+        else
+        {
+            click_first = 1;
+        }
+    }
+    click_quiet = registers[REG_TIME_LATENCY];
+    if (source)
+    {
+        registers[REG_CLICK_SRC] = source | clicked_axes;
+    }
+    else if (!(registers[REG_CLICK_THS] & CLICK_THS_LIR))
+    {
+        registers[REG_CLICK_SRC] = 0;
+    }
+}
+
+static void LIS3DH_Model_NewSample(uint64_t t_ns)
+{
+    LIS3DH_Model_Sample sample;
+    int32_t mg[3];
+
+    memset(&sample, 0, sizeof(sample));
+    LIS3DH_Model_Acceleration(t_ns, mg);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        // Offset and gain errors of the device
+        mg[axis] = (int32_t)lround(mg[axis] * error_gain[axis]) + error_offset_mg[axis];
+    }
+    LIS3DH_Model_Activity(mg);
+    LIS3DH_Model_Interrupt1(mg);
+    LIS3DH_Model_Click(mg);
+    LIS3DH_Model_HighPass(mg);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        // Disabled axes are not converted and read as zero
+        if (registers[REG_CTRL_REG1] & (1 << axis))
+        {
+            sample.out[axis] = LIS3DH_Model_Encode(mg[axis]);
+        }
+    }
+    sample.seq = next_seq++;
+    sample.t_ns = t_ns;
+    stats.samples_generated++;
+
+    uint8_t mode = LIS3DH_Model_FifoMode();
+    if (mode != FIFO_MODE_BYPASS)
+    {
+        if (fifo_count == LIS3DH_MODEL_FIFO_DEPTH)
+        {
+            fifo_overrun = 1;
+            stats.fifo_overruns++;
+            if (mode == FIFO_MODE_FIFO)
+            {
+                // FIFO mode stops collecting once full
+                LIS3DH_Model_Retire(&sample);
+                return;
+            }
+            // Stream modes discard the oldest sample
+            LIS3DH_Model_Retire(&fifo[fifo_head]);
+            LIS3DH_Model_FifoDrop();
+        }
+        fifo[(fifo_head + fifo_count) % LIS3DH_MODEL_FIFO_DEPTH] = sample;
+        fifo_count++;
+        return;
+    }
+
+    if ((registers[REG_CTRL_REG4] & CTRL_REG4_BDU) &&
+        (axis_locked[0] || axis_locked[1] || axis_locked[2]))
+    {
+        // Block data update: wait until the high byte being read is read
+        if (bdu_pending_valid)
+        {
+            LIS3DH_Model_Retire(&bdu_pending);
+        }
+        bdu_pending = sample;
+        bdu_pending_valid = 1;
+        return;
+    }
+    LIS3DH_Model_Present(&sample);
+}
+
+/*
+* Time between two samples at the given rate, with the clock error of the
+* device.
+*/
+static uint64_t LIS3DH_Model_SamplePeriodNs(uint32_t odr)
+{
+    return VIRTUAL_TIME_NS_PER_S * 1000000u / ((uint64_t)odr * (uint64_t)(1000000 + odr_error_ppm));
+}
+
+/*
+* Produce all the samples due up to the current virtual time.
+*/
+static void LIS3DH_Model_Update(void)
+{
+    uint32_t odr;
+    while ((odr = LIS3DH_Model_GetOdrHz()) != 0 && next_sample_ns <= VirtualTime_Now())
+    {
+        // The rate may change with each sample through the sleep-to-wake engine
+        LIS3DH_Model_NewSample(next_sample_ns);
+        next_sample_ns += LIS3DH_Model_SamplePeriodNs(LIS3DH_Model_GetOdrHz());
+    }
+}
+
+void LIS3DH_Model_Reset(void)
+{
+    memset(registers, 0, sizeof(registers));
+    memset(&stats, 0, sizeof(stats));
+    memset(&waveform, 0, sizeof(waveform));
+    registers[REG_WHO_AM_I] = WHO_AM_I_VALUE;
+    registers[REG_CTRL_REG1] = 0x07;
+    register_pointer = 0;
+    auto_increment = 0;
+    expecting_subaddress = 0;
+    next_seq = 0;
+    last_read_sample_ns = 0;
+    ready_ns = 0;
+    act_sleeping = 0;
+    inactive_samples = 0;
+    int1_samples = 0;
+    int1_active = 0;
+    memset(click_lowpass_mg, 0, sizeof(click_lowpass_mg));
+    memset(output_lowpass_mg, 0, sizeof(output_lowpass_mg));
+    memset(output_input_mg, 0, sizeof(output_input_mg));
+    click_run = 0;
+    click_axes = 0;
+    click_quiet = 0;
+    click_window = 0;
+    click_first = 0;
+    presented_valid = 0;
+    bdu_pending_valid = 0;
+    memset(axis_locked, 0, sizeof(axis_locked));
+    fifo_head = 0;
+    fifo_count = 0;
+    fifo_overrun = 0;
+    waveform.offset_mg[2] = 1000;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        error_offset_mg[axis] = 0;
+        error_gain[axis] = 1.0;
+    }
+    source = NULL;
+    noise_state = 1;
+    temperature_c = TEMPERATURE_REFERENCE_C;
+}
+
+void LIS3DH_Model_SetWaveform(const LIS3DH_Model_Waveform* new_waveform)
+{
+    waveform = *new_waveform;
+}
+
+void LIS3DH_Model_SetSource(LIS3DH_Model_Source new_source)
+{
+    source = new_source;
+}
+
+void LIS3DH_Model_SetErrors(const int32_t offset_mg[3], const double gain_percent[3])
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        error_offset_mg[axis] = offset_mg[axis];
+        error_gain[axis] = 1.0 + gain_percent[axis] / 100.0;
+    }
+}
+
+void LIS3DH_Model_SetTemperature(int32_t celsius)
+{
+    temperature_c = celsius;
+}
+
+void LIS3DH_Model_SetBootTime(uint64_t ns)
+{
+    ready_ns = VirtualTime_Now() + ns;
+}
+
+void LIS3DH_Model_SetOdrError(int32_t ppm)
+{
+    odr_error_ppm = ppm;
+}
+
+uint8_t LIS3DH_Model_Ready(void)
+{
+    return VirtualTime_Now() >= ready_ns;
+}
+
+void LIS3DH_Model_SetTrace(FILE* file)
+{
+    trace = file;
+}
+
+static void LIS3DH_Model_WriteRegister(uint8_t address, uint8_t data)
+{
+    stats.register_writes++;
+    switch (address)
+    {
+        case REG_STATUS_REG_AUX:
+        case REG_OUT_ADC3_L:
+        case REG_OUT_ADC3_H:
+        case REG_WHO_AM_I:
+        case REG_STATUS_REG:
+        case REG_FIFO_SRC_REG:
+        case REG_INT1_SRC:
+        case REG_CLICK_SRC:
+            // Read-only registers
+            break;
+        case REG_CTRL_REG1:
+        {
+            uint32_t old_odr = LIS3DH_Model_GetOdrHz();
+            registers[address] = data;
+            uint32_t new_odr = LIS3DH_Model_GetOdrHz();
+            if (new_odr != 0 && new_odr != old_odr)
+            {
+                // First sample one period after the rate change
+                next_sample_ns = VirtualTime_Now() + LIS3DH_Model_SamplePeriodNs(new_odr);
+            }
+            break;
+        }
+        case REG_CTRL_REG4:
+            if ((registers[address] ^ data) & CTRL_REG4_FS)
+            {
+                stats.range_changes++;
+            }
+            registers[address] = data;
+            break;
+        case REG_CTRL_REG5:
+        case REG_FIFO_CTRL_REG:
+        {
+            uint8_t old_mode = LIS3DH_Model_FifoMode();
+            registers[address] = data;
+            if (LIS3DH_Model_FifoMode() == FIFO_MODE_BYPASS || old_mode == FIFO_MODE_BYPASS)
+            {
+                // Going through bypass mode resets the FIFO
+                LIS3DH_Model_FifoClear();
+            }
+            break;
+        }
+        default:
+            if (address >= REG_OUT_X_L && address <= REG_OUT_Z_H)
+            {
+                break;
+            }
+            registers[address] = data;
+            break;
+    }
+}
+
+/*
+* Bookkeeping when the high byte of an axis is read.
+*/
+static void LIS3DH_Model_AxisRead(LIS3DH_Model_Sample* sample, uint8_t axis)
+{
+    sample->h_reads[axis]++;
+    if (sample->h_reads[axis] == 2 && !sample->double_reported)
+    {
+        sample->double_reported = 1;
+        stats.samples_double_read++;
+        LIS3DH_Model_Trace("double-read", sample);
+    }
+    // A sample is read completely once all the enabled axes have been read
+    uint8_t enabled = registers[REG_CTRL_REG1] & CTRL_REG1_XYZEN;
+    if (!sample->read_reported &&
+        (sample->h_reads[0] || !(enabled & 0x01)) &&
+        (sample->h_reads[1] || !(enabled & 0x02)) &&
+        (sample->h_reads[2] || !(enabled & 0x04)))
+    {
+        uint64_t latency_ns = VirtualTime_Now() - sample->t_ns;
+        sample->read_reported = 1;
+        last_read_sample_ns = sample->t_ns;
+        if (stats.samples_read == 0)
+        {
+            stats.first_read_ns = VirtualTime_Now();
+        }
+        stats.samples_read++;
+        stats.total_read_latency_ns += latency_ns;
+        if (latency_ns > stats.max_read_latency_ns)
+        {
+            stats.max_read_latency_ns = latency_ns;
+        }
+    }
+}
+
+static uint8_t LIS3DH_Model_ReadOutput(uint8_t address)
+{
+    uint8_t axis = (address - REG_OUT_X_L) / 2;
+    uint8_t high = (address - REG_OUT_X_L) % 2;
+    uint8_t fifo_mode = LIS3DH_Model_FifoMode() != FIFO_MODE_BYPASS;
+    LIS3DH_Model_Sample* sample = LIS3DH_Model_Head();
+    uint16_t word = sample != NULL ? (uint16_t)sample->out[axis] : 0;
+
+    if (!high)
+    {
+        axis_locked[axis] = (registers[REG_CTRL_REG4] & CTRL_REG4_BDU) ? 1 : 0;
+        return (uint8_t)(word & 0xFF);
+    }
+
+    axis_locked[axis] = 0;
+    if (sample != NULL)
+    {
+        LIS3DH_Model_AxisRead(sample, axis);
+    }
+    if (fifo_mode)
+    {
+        // The FIFO moves on once the last output register is read
+        if (axis == 2 && fifo_count > 0)
+        {
+            LIS3DH_Model_FifoDrop();
+            fifo_overrun = 0;
+        }
+    }
+    else
+    {
+        registers[REG_STATUS_REG] &= (uint8_t)~((STATUS_XDA | STATUS_XOR) << axis);
+        if ((registers[REG_STATUS_REG] & 0x07) == 0)
+        {
+            registers[REG_STATUS_REG] &= (uint8_t)~STATUS_ZYXDA;
+        }
+        if ((registers[REG_STATUS_REG] & 0x70) == 0)
+        {
+            registers[REG_STATUS_REG] &= (uint8_t)~STATUS_ZYXOR;
+        }
+        if (bdu_pending_valid && !axis_locked[0] && !axis_locked[1] && !axis_locked[2])
+        {
+            bdu_pending_valid = 0;
+            LIS3DH_Model_Present(&bdu_pending);
+        }
+    }
+    return (uint8_t)(word >> 8);
+}
+
+static uint8_t LIS3DH_Model_ReadRegister(uint8_t address)
+{
+    if (address >= REG_OUT_X_L && address <= REG_OUT_Z_H)
+    {
+        return LIS3DH_Model_ReadOutput(address);
+    }
+
+    switch (address)
+    {
+        case REG_STATUS_REG:
+            if (LIS3DH_Model_FifoMode() != FIFO_MODE_BYPASS)
+            {
+                return (fifo_count > 0 ? 0x0F : 0x00) | (fifo_overrun ? 0xF0 : 0x00);
+            }
+            return registers[REG_STATUS_REG];
+        case REG_FIFO_SRC_REG:
+        {
+            uint8_t src = fifo_count >= LIS3DH_MODEL_FIFO_DEPTH ? 0x1F : fifo_count;
+            if (fifo_count > (registers[REG_FIFO_CTRL_REG] & 0x1F))
+            {
+                src |= FIFO_SRC_WTM;
+            }
+            if (fifo_overrun)
+            {
+                src |= FIFO_SRC_OVRN;
+            }
+            if (fifo_count == 0)
+            {
+                src |= FIFO_SRC_EMPTY;
+            }
+            return src;
+        }
+        case REG_INT1_SRC:
+        case REG_CLICK_SRC:
+        {
+            // Reading the source clears a latched interrupt
+            uint8_t src = registers[address];
+            registers[address] = 0;
+            return src;
+        }
+        case REG_REFERENCE:
+            // In normal mode the read resets the high-pass filter to the last acceleration
+            if ((registers[REG_CTRL_REG2] & CTRL_REG2_HPM) == 0)
+            {
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    output_lowpass_mg[axis] = output_input_mg[axis];
+                }
+                stats.filter_resets++;
+            }
+            return registers[address];
+        case REG_OUT_ADC3_L:
+        case REG_OUT_ADC3_H:
+        {
+            // Temperature delta, 1 digit/degC, left-justified
+            uint16_t word = 0;
+            if ((registers[REG_TEMP_CFG_REG] & (TEMP_CFG_ADC_EN | TEMP_CFG_TEMP_EN)) ==
+                (TEMP_CFG_ADC_EN | TEMP_CFG_TEMP_EN))
+            {
+                word = (uint16_t)((temperature_c - TEMPERATURE_REFERENCE_C) * 256);
+            }
+            return address == REG_OUT_ADC3_L ? (uint8_t)(word & 0xFF) : (uint8_t)(word >> 8);
+        }
+        default:
+            return registers[address];
+    }
+}
+
+uint8_t LIS3DH_Model_PeekRegister(uint8_t address)
+{
+    return registers[address & 0x3F];
+}
+
+void LIS3DH_Model_I2CStart(uint8_t read)
+{
+    LIS3DH_Model_Update();
+    expecting_subaddress = read ? 0 : 1;
+}
+
+/*
+* Move to the next register of a multiple-byte transfer.
+*/
+static void LIS3DH_Model_NextRegister(void)
+{
+    if (!auto_increment)
+    {
+        return;
+    }
+    if (register_pointer == REG_OUT_Z_H && LIS3DH_Model_FifoMode() != FIFO_MODE_BYPASS)
+    {
+        // Roll back to OUT_X_L so that the FIFO can be read in one burst
+        register_pointer = REG_OUT_X_L;
+        return;
+    }
+    register_pointer = (register_pointer + 1) & 0x3F;
+}
+
+void LIS3DH_Model_I2CWrite(uint8_t data)
+{
+    LIS3DH_Model_Update();
+    if (expecting_subaddress)
+    {
+        register_pointer = data & 0x3F;
+        auto_increment = (data & SUBADDRESS_AUTO_INCREMENT) ? 1 : 0;
+        expecting_subaddress = 0;
+        return;
+    }
+    LIS3DH_Model_WriteRegister(register_pointer, data);
+    LIS3DH_Model_NextRegister();
+}
+
+uint8_t LIS3DH_Model_I2CRead(void)
+{
+    LIS3DH_Model_Update();
+    uint8_t value = LIS3DH_Model_ReadRegister(register_pointer);
+    stats.register_reads++;
+    LIS3DH_Model_NextRegister();
+    return value;
+}
+
+void LIS3DH_Model_I2CStop(void)
+{
+    LIS3DH_Model_Update();
+    expecting_subaddress = 0;
+}
+
+uint64_t LIS3DH_Model_LastReadSampleTime(void)
+{
+    return last_read_sample_ns;
+}
+
+const LIS3DH_Model_Stats* LIS3DH_Model_GetStats(void)
+{
+    return &stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,185 @@
+/**
+*   \file LIS3DH_Model.h
+*   \brief Software model of the LIS3DH accelerometer.
+*
+*   The model implements the I2C slave side of the register map used by
+*   the firmware (WHO_AM_I, STATUS_REG, CTRL_REG1/4/5, TEMP_CFG_REG,
+*   OUT_ADC3, OUT_X/Y/Z, FIFO_CTRL_REG/FIFO_SRC_REG, ACT_THS/ACT_DUR,
+*   INT1_CFG/SRC/THS/DURATION, CLICK_CFG/SRC/THS, TIME_LIMIT/LATENCY/WINDOW)
+*   with sub-address auto-increment, the sleep-to-wake engine, interrupt
+*   generator 1 and the click engine. New samples are produced at the configured output data
+*   rate in virtual time from a waveform source, and every sample is
+*   followed until it is read, so that missed and double-read samples can
+*   be reported with their timestamps.
+*/
+
+#ifndef __LIS3DH_MODEL_H
+    #define __LIS3DH_MODEL_H
+
+    #include <stdint.h>
+    #include <stdio.h>
+
+    /**
+    *   \brief 7-bit I2C address of the modeled device (SA0 low).
+    */
+    #define LIS3DH_MODEL_ADDRESS 0x18
+
+    /**
+    *   \brief Depth of the embedded FIFO.
+    */
+    #define LIS3DH_MODEL_FIFO_DEPTH 32
+
+    /**
+    *   \brief Counters collected while the model is running.
+    */
+    typedef struct {
+        uint32_t samples_generated;     ///< Samples produced at the ODR
+        uint32_t samples_read;          ///< Samples read completely (all axes)
+        uint32_t samples_missed;        ///< Samples overwritten before being read
+        uint32_t samples_double_read;   ///< Samples read more than once
+        uint32_t status_overruns;       ///< Times ZYXOR has been raised
+        uint32_t fifo_overruns;         ///< Samples lost for a full FIFO
+        uint32_t activity_sleeps;       ///< Falls back to 10 Hz for inactivity
+        uint32_t activity_wakes;        ///< Returns to the configured ODR
+        uint32_t int1_events;           ///< Times interrupt generator 1 has gone active
+        uint32_t clicks;                ///< Single clicks detected
+        uint32_t double_clicks;         ///< Double clicks detected
+        uint32_t range_changes;         ///< Writes changing the full scale
+        uint32_t values_clipped;        ///< Axis values clipped at the full scale
+        uint32_t filter_resets;         ///< REFERENCE reads resetting the high-pass filter
+        uint32_t register_reads;        ///< Bytes read by the master
+        uint32_t register_writes;       ///< Bytes written by the master
+        uint64_t max_read_latency_ns;   ///< Worst time from sample to read
+        uint64_t total_read_latency_ns; ///< Sum of the sample-to-read times
+        uint64_t first_read_ns;         ///< Time the first sample has been read completely
+    } LIS3DH_Model_Stats;
+
+    /**
+    *   \brief Acceleration applied to the device, as a function of time.
+    *
+    *   Each axis is offset + amplitude * sin(2 pi f t) + uniform noise.
+    *   With burst_on_s set, the sine is applied for burst_on_s seconds
+    *   out of every burst_on_s + burst_off_s, and the device is still in
+    *   between. Taps (10 ms half-sine pulses on Z) and free falls (all the
+    *   axes at zero) happen halfway through each of their periods. With
+    *   tumble_s set, from tumble_at_s the device is turned with +X, -X, +Y,
+    *   -Y, +Z and -Z up for tumble_s seconds each, 1 g replacing the
+    *   offsets, then laid flat again.
+    */
+    typedef struct {
+        int32_t offset_mg[3];           ///< Static acceleration per axis
+        int32_t amplitude_mg[3];        ///< Sine amplitude per axis
+        double frequency_hz[3];         ///< Sine frequency per axis
+        int32_t noise_mg;               ///< Peak uniform noise on every axis
+        double burst_on_s;              ///< Length of the sine bursts (0 for continuous)
+        double burst_off_s;             ///< Still time between the bursts
+        double tap_every_s;             ///< Period of the taps (0 for none)
+        int32_t tap_mg;                 ///< Peak of the taps
+        double fall_every_s;            ///< Period of the free falls (0 for none)
+        double fall_s;                  ///< Length of the free falls
+        double tumble_at_s;             ///< Start of the six-position tumble
+        double tumble_s;                ///< Time in each position (0 for no tumble)
+    } LIS3DH_Model_Waveform;
+
+    /**
+    *   \brief Custom acceleration source, overriding the waveform.
+    *   \param t_ns Virtual time of the sample.
+    *   \param mg Acceleration of the X, Y and Z axes to be filled in.
+    */
+    typedef void (*LIS3DH_Model_Source)(uint64_t t_ns, int32_t mg[3]);
+
+    /**
+    *   \brief Bring the model to its power-on state.
+    *
+    *   The waveform is reset to the device lying flat (1 g on Z).
+    */
+    void LIS3DH_Model_Reset(void);
+
+    /**
+    *   \brief Set the acceleration waveform applied to the device.
+    */
+    void LIS3DH_Model_SetWaveform(const LIS3DH_Model_Waveform* waveform);
+
+    /**
+    *   \brief Set the offset (mg) and gain (percent) errors of each axis,
+    *   applied to the acceleration before it is converted.
+    */
+    void LIS3DH_Model_SetErrors(const int32_t offset_mg[3], const double gain_percent[3]);
+
+    /**
+    *   \brief Set a custom acceleration source (NULL to use the waveform).
+    */
+    void LIS3DH_Model_SetSource(LIS3DH_Model_Source source);
+
+    /**
+    *   \brief Set the die temperature reported through OUT_ADC3.
+    */
+    void LIS3DH_Model_SetTemperature(int32_t celsius);
+
+    /**
+    *   \brief Set the time the device takes to boot from now: its address
+    *   is not acknowledged until then (the device is ready at reset).
+    */
+    void LIS3DH_Model_SetBootTime(uint64_t ns);
+
+    /**
+    *   \brief Set the error of the device clock, in ppm (positive when the
+    *   samples come faster than the ODR). It is kept across resets.
+    */
+    void LIS3DH_Model_SetOdrError(int32_t ppm);
+
+    /**
+    *   \brief Non-zero once the device has booted and answers on the bus.
+    */
+    uint8_t LIS3DH_Model_Ready(void);
+
+    /**
+    *   \brief Log every missed and double-read sample to the given file.
+    */
+    void LIS3DH_Model_SetTrace(FILE* file);
+
+    /**
+    *   \brief Start of a transfer addressed to the device.
+    *   \param read Non-zero for a read transfer.
+    */
+    void LIS3DH_Model_I2CStart(uint8_t read);
+
+    /**
+    *   \brief Byte written by the master (sub-address, then data).
+    */
+    void LIS3DH_Model_I2CWrite(uint8_t data);
+
+    /**
+    *   \brief Byte read by the master.
+    */
+    uint8_t LIS3DH_Model_I2CRead(void);
+
+    /**
+    *   \brief Stop condition on the bus.
+    */
+    void LIS3DH_Model_I2CStop(void);
+
+    /**
+    *   \brief Current output data rate in Hz (0 in power-down).
+    *
+    *   While asleep for inactivity this is the 10 Hz of low-power mode.
+    */
+    uint32_t LIS3DH_Model_GetOdrHz(void);
+
+    /**
+    *   \brief Current value of a register, without side effects.
+    */
+    uint8_t LIS3DH_Model_PeekRegister(uint8_t address);
+
+    /**
+    *   \brief Generation time of the last sample read completely.
+    */
+    uint64_t LIS3DH_Model_LastReadSampleTime(void);
+
+    /**
+    *   \brief Counters collected since the last reset.
+    */
+    const LIS3DH_Model_Stats* LIS3DH_Model_GetStats(void);
+
+#endif
+/* [] END OF FILE */
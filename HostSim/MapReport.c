@@ -0,0 +1,487 @@
+/*
+* This file includes the size report: it reads the map file written by the
+* GNU linker of PSoC Creator and prints the flash and SRAM taken by each
+* object, library members included, together with the totals of the two
+* memory regions.
+*
+* Usage: map_report [-c] [-n rows] [-l log_bytes] project.map
+*
+* Flash is the sum of the sections placed in the rom region plus the
+* initial values of .data, SRAM the sum of the sections placed in the ram
+* region. The bytes of an output section that belong to no object, such as
+* the heap, the stack and the alignment padding, are listed under the name
+* of the section in brackets. With link time optimization the code
+* of the project is merged into ltrans units, which are listed as "(LTO)".
+* -c prints CSV instead of a table, -n limits the table to the largest
+* objects. -l gives the bytes kept at the top of the rom region for the
+* flash log (see FlashLog.h), which the linker script knows nothing of:
+* the report fails if the image reaches into them.
+*
+* The totals match the "Flash used" and "SRAM used" lines of BUILD.log.
+* The Release configuration of the projects is the production one: -Os,
+* link time optimization and unused sections removed. Its -O2 variant is
+* the same configuration with the Optimization Level set to Speed.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+*   \brief Longest line of the map file, longer ones are cut.
+*/
+#define MAP_MAX_LINE 1024
+
+/**
+*   \brief Largest number of objects and memory regions.
+*/
+#define MAP_MAX_OBJECTS 512
+#define MAP_MAX_REGIONS 8
+
+/**
+*   \brief Longest object name kept, path excluded.
+*/
+#define MAP_MAX_NAME 64
+
+/**
+*   \brief A memory region of the linker script.
+*/
+typedef struct {
+    char name[MAP_MAX_NAME];
+    uint32_t origin;
+    uint32_t length;
+} Map_Region;
+
+/**
+*   \brief Bytes taken by one object.
+*/
+typedef struct {
+    char name[MAP_MAX_NAME];
+    uint32_t flash;
+    uint32_t sram;
+} Map_Object;
+
+/**
+*   \brief Output section being read.
+*/
+typedef struct {
+    char name[MAP_MAX_NAME];
+    uint32_t size;
+    uint32_t covered;           ///< Bytes accounted for by its input sections
+    uint8_t in_flash;           ///< Placed in the rom region
+    uint8_t in_sram;            ///< Placed in the ram region
+    uint8_t loaded;             ///< Initial values stored in the rom region
+} Map_Section;
+
+static Map_Region regions[MAP_MAX_REGIONS];
+static uint32_t region_count;
+static Map_Object objects[MAP_MAX_OBJECTS];
+static uint32_t object_count;
+static uint32_t flash_total;
+static uint32_t sram_total;
+static uint32_t flash_end;
+
+/*
+* Find the region of the given name, NULL if the script has none.
+*/
+static const Map_Region* Map_FindRegion(const char* name)
+{
+    for (uint32_t i = 0; i < region_count; i++)
+    {
+        if (strcmp(regions[i].name, name) == 0)
+        {
+            return &regions[i];
+        }
+    }
+    return NULL;
+}
+
+static uint8_t Map_InRegion(const Map_Region* region, uint32_t address)
+{
+    return region != NULL && address >= region->origin &&
+           address - region->origin < region->length;
+}
+
+/*
+* Sections that are not allocated, such as the debug information, are
+* printed at address 0 as the vectors: they are told apart by name.
+*/
+static uint8_t Map_IsAllocated(const char* section)
+{
+    static const char* const skipped[] = {".debug", ".stab", ".comment", ".line",
+                                          ".note", ".ARM.attributes"};
+
+    for (size_t i = 0; i < sizeof(skipped) / sizeof(skipped[0]); i++)
+    {
+        if (strncmp(section, skipped[i], strlen(skipped[i])) == 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+* Sections in ram which show a load address but take no flash.
+*/
+static uint8_t Map_IsNoLoad(const char* section)
+{
+    return strncmp(section, ".bss", 4) == 0 || strcmp(section, ".heap") == 0 ||
+           strcmp(section, ".stack") == 0 || strcmp(section, ".noinit") == 0;
+}
+
+/*
+* Name under which an input file is reported: the path is dropped, the
+* archive is kept in front of its member.
+*/
+static void Map_ObjectName(const char* file, char* name)
+{
+    const char* start = file;
+    const char* member = strrchr(file, '(');
+
+    if (strstr(file, ".ltrans") != NULL)
+    {
+        strcpy(name, "(LTO)");
+        return;
+    }
+    if (member != NULL && file[strlen(file) - 1] != ')')
+    {
+        member = NULL;
+    }
+    for (const char* c = file; *c != '\0' && (member == NULL || c < member); c++)
+    {
+        if (*c == '/' || *c == '\\')
+        {
+            start = c + 1;
+        }
+    }
+    snprintf(name, MAP_MAX_NAME, "%s", start);
+}
+
+static void Map_Add(const char* name, const Map_Section* section, uint32_t size)
+{
+    uint32_t i;
+
+    if (size == 0 || (!section->in_flash && !section->in_sram))
+    {
+        return;
+    }
+    for (i = 0; i < object_count; i++)
+    {
+        if (strcmp(objects[i].name, name) == 0)
+        {
+            break;
+        }
+    }
+    if (i == object_count)
+    {
+        if (object_count == MAP_MAX_OBJECTS)
+        {
+            i = object_count - 1;
+            snprintf(objects[i].name, MAP_MAX_NAME, "(others)");
+        }
+        else
+        {
+            snprintf(objects[object_count++].name, MAP_MAX_NAME, "%s", name);
+        }
+    }
+    if (section->in_flash || section->loaded)
+    {
+        objects[i].flash += size;
+        flash_total += size;
+    }
+    if (section->in_sram)
+    {
+        objects[i].sram += size;
+        sram_total += size;
+    }
+}
+
+/*
+* Close the output section: whatever its input sections left out is
+* reported under its own name.
+*/
+static void Map_CloseSection(Map_Section* section)
+{
+    char name[MAP_MAX_NAME + 2];
+
+    if (section->size > section->covered)
+    {
+        snprintf(name, sizeof(name), "[%s]", section->name);
+        Map_Add(name, section, section->size - section->covered);
+    }
+    memset(section, 0, sizeof(*section));
+}
+
+static void Map_OpenSection(Map_Section* section, const char* name, uint32_t address,
+                            uint32_t size, const char* rest)
+{
+    const Map_Region* rom = Map_FindRegion("rom");
+    const Map_Region* ram = Map_FindRegion("ram");
+    unsigned int load;
+
+    snprintf(section->name, MAP_MAX_NAME, "%s", name);
+    section->size = size;
+    if (!Map_IsAllocated(name))
+    {
+        return;
+    }
+    section->in_flash = Map_InRegion(rom, address);
+    section->in_sram = Map_InRegion(ram, address);
+    if (section->in_sram && !Map_IsNoLoad(name) &&
+        sscanf(rest, " load address %x", &load) == 1)
+    {
+        section->loaded = Map_InRegion(rom, load);
+    }
+
+    // First byte of the rom region above the image
+    if (size > 0 && section->in_flash && address + size > flash_end)
+    {
+        flash_end = address + size;
+    }
+    if (size > 0 && section->loaded && load + size > flash_end)
+    {
+        flash_end = load + size;
+    }
+}
+
+static int Map_CompareObjects(const void* a, const void* b)
+{
+    const Map_Object* first = a;
+    const Map_Object* second = b;
+
+    if (first->flash != second->flash)
+    {
+        return first->flash < second->flash ? 1 : -1;
+    }
+    if (first->sram != second->sram)
+    {
+        return first->sram < second->sram ? 1 : -1;
+    }
+    return strcmp(first->name, second->name);
+}
+
+/*
+* Parse "0xADDRESS 0xSIZE rest" at the start of text.
+*/
+static uint8_t Map_ParseRange(const char* text, uint32_t* address, uint32_t* size,
+                              const char** rest)
+{
+    unsigned int a, s;
+    int used = 0;
+
+    if (sscanf(text, " 0x%x 0x%x%n", &a, &s, &used) != 2)
+    {
+        return 0;
+    }
+    *address = a;
+    *size = s;
+    *rest = text + used;
+    while (**rest == ' ')
+    {
+        (*rest)++;
+    }
+    return 1;
+}
+
+static int Map_Read(FILE* map)
+{
+    char line[MAP_MAX_LINE];
+    char next[MAP_MAX_LINE];
+    char token[MAP_MAX_LINE];
+    char name[MAP_MAX_NAME];
+    Map_Section section;
+    uint8_t regions_read = 0, layout_read = 0, pending = 0;
+    uint32_t address, size;
+    const char* rest;
+
+    memset(&section, 0, sizeof(section));
+    while (pending || fgets(line, sizeof(line), map) != NULL)
+    {
+        pending = 0;
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (strcmp(line, "Memory Configuration") == 0)
+        {
+            regions_read = 1;
+            continue;
+        }
+        if (strcmp(line, "Linker script and memory map") == 0)
+        {
+            regions_read = 0;
+            layout_read = 1;
+            continue;
+        }
+        if (regions_read)
+        {
+            unsigned int origin, length;
+            if (region_count < MAP_MAX_REGIONS &&
+                sscanf(line, "%63s 0x%x 0x%x", regions[region_count].name, &origin, &length) == 3)
+            {
+                regions[region_count].origin = origin;
+                regions[region_count].length = length;
+                region_count++;
+            }
+            continue;
+        }
+        if (!layout_read || line[0] == '\0' || sscanf(line, "%s", token) != 1)
+        {
+            continue;
+        }
+
+        // Long section names are alone on their line, the range follows
+        if (!Map_ParseRange(line + strspn(line, " ") + strlen(token), &address, &size, &rest))
+        {
+            if (line[0] == ' ' && line[1] != ' ' && token[0] != '*' &&
+                fgets(next, sizeof(next), map) != NULL)
+            {
+                next[strcspn(next, "\r\n")] = '\0';
+                if (!Map_ParseRange(next, &address, &size, &rest))
+                {
+                    strcpy(line, next);
+                    pending = 1;
+                    continue;
+                }
+            }
+            else if (line[0] != ' ' && fgets(next, sizeof(next), map) != NULL)
+            {
+                next[strcspn(next, "\r\n")] = '\0';
+                if (!Map_ParseRange(next, &address, &size, &rest))
+                {
+                    Map_CloseSection(&section);
+                    strcpy(line, next);
+                    pending = 1;
+                    continue;
+                }
+            }
+            else
+            {
+                continue;
+            }
+        }
+
+        if (line[0] != ' ')
+        {
+            // Output section
+            Map_CloseSection(&section);
+            Map_OpenSection(&section, token, address, size, rest);
+        }
+        else if (line[1] != ' ')
+        {
+            // Input section, the padding between two of them is left to the section
+            if (strcmp(token, "*fill*") != 0)
+            {
+                Map_ObjectName(rest, name);
+                Map_Add(name, &section, size);
+                section.covered += size;
+            }
+        }
+    }
+    Map_CloseSection(&section);
+    return layout_read && region_count > 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* path = NULL;
+    uint8_t csv = 0;
+    uint32_t rows = MAP_MAX_OBJECTS;
+    uint32_t log_bytes = 0;
+    FILE* map;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0)
+        {
+            csv = 1;
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            rows = (uint32_t)atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            log_bytes = (uint32_t)atol(argv[++i]);
+        }
+        else if (argv[i][0] != '-' && path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL)
+    {
+        fprintf(stderr, "Usage: %s [-c] [-n rows] [-l log_bytes] project.map\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    map = fopen(path, "r");
+    if (map == NULL)
+    {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    if (!Map_Read(map))
+    {
+        fprintf(stderr, "%s: no memory map found\n", path);
+        fclose(map);
+        return EXIT_FAILURE;
+    }
+    fclose(map);
+
+    const Map_Region* rom = Map_FindRegion("rom");
+    const Map_Region* ram = Map_FindRegion("ram");
+    uint32_t log_start = 0;
+
+    if (rom != NULL && log_bytes > 0)
+    {
+        log_start = (log_bytes < rom->length) ? rom->origin + rom->length - log_bytes : rom->origin;
+    }
+
+    qsort(objects, object_count, sizeof(objects[0]), Map_CompareObjects);
+    if (csv)
+    {
+        printf("object,flash,sram\n");
+        for (uint32_t i = 0; i < object_count; i++)
+        {
+            printf("%s,%u,%u\n", objects[i].name, objects[i].flash, objects[i].sram);
+        }
+        printf("total,%u,%u\n", flash_total, sram_total);
+    }
+    else
+    {
+        printf("%-56s %8s %8s\n", "Object", "Flash", "SRAM");
+        for (uint32_t i = 0; i < object_count && i < rows; i++)
+        {
+            printf("%-56s %8u %8u\n", objects[i].name, objects[i].flash, objects[i].sram);
+        }
+        if (rows < object_count)
+        {
+            printf("%-56s %8s %8s\n", "...", "", "");
+        }
+        if (rom != NULL)
+        {
+            printf("%-56s %8u of %u bytes (%.1f %%)\n", "Flash used", flash_total,
+                   rom->length, 100.0 * flash_total / rom->length);
+        }
+        if (ram != NULL)
+        {
+            printf("%-56s %8u of %u bytes (%.1f %%)\n", "SRAM used", sram_total,
+                   ram->length, 100.0 * sram_total / ram->length);
+        }
+    }
+    if (rom != NULL && log_bytes > 0 && flash_end > log_start)
+    {
+        fprintf(stderr, "%s: the image ends at 0x%08X, inside the flash log from 0x%08X\n",
+                path, flash_end, log_start);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
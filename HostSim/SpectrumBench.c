@@ -0,0 +1,193 @@
+/*
+* This file includes the Spectrum benchmark: for each block size it
+* transforms a test signal with the fixed-point code compiled for the
+* firmware, compares band values and peaks with a floating-point reference
+* and reports the time taken per block and the RAM of the buffers.
+*
+* Usage: spectrum_bench [-r rate_hz] [-n blocks] [-e max_mg]
+*
+* With -e the run fails when a band is further than max_mg from the
+* floating-point reference, for any block size.
+*
+* The test signal is 1 g of gravity, a 700 mg tone at 0.23 times the
+* sample rate, an 80 mg tone at 0.37 times it and 3 mg of noise. The cost
+* is given as the time taken on the host and as an estimate of the
+* Cortex-M3 cycles; the firmware prints the figure measured with the DWT
+* at start-up when ACQ_BENCHMARK and ACQ_FFT_POINTS are set.
+*/
+
+#include "Spectrum.h"
+#include "AcquisitionConfig.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+*   \brief Estimated Cortex-M3 cycles: per butterfly (four LDRSH, two MUL
+*   and two MLA, the shifts, four STRH and the loop), per input sample
+*   (mean, peak, window and bit reversal) and per bin reduced.
+*/
+#define BENCH_M3_CYCLES_PER_BUTTERFLY 28
+#define BENCH_M3_CYCLES_PER_SAMPLE 30
+#define BENCH_M3_CYCLES_PER_BIN 14
+
+/*
+* Test signal, in mg.
+*/
+static void SpectrumBench_Signal(int16_t* samples, uint16_t points, double rate_hz)
+{
+    for (uint16_t i = 0; i < points; i++)
+    {
+        double t = i / rate_hz;
+        double noise = 3.0 * ((double)rand() / RAND_MAX * 2.0 - 1.0) * sqrt(3.0);
+        samples[i] = (int16_t)lround(1000.0 + 700.0 * sin(2.0 * M_PI * 0.23 * rate_hz * t) +
+                                     80.0 * sin(2.0 * M_PI * 0.37 * rate_hz * t + 1.0) + noise);
+    }
+}
+
+/*
+* Band values computed in double precision with the same window and
+* scaling as the fixed-point code.
+*/
+static void SpectrumBench_Reference(const int16_t* samples, uint16_t points, double bands[SPECTRUM_BANDS])
+{
+    double mean = 0.0;
+    uint16_t width = points / (2 * SPECTRUM_BANDS);
+
+    for (uint16_t i = 0; i < points; i++)
+    {
+        mean += samples[i];
+    }
+    mean /= points;
+    for (uint16_t band = 0; band < SPECTRUM_BANDS; band++)
+    {
+        double power = 0.0;
+        for (uint16_t k = band * width; k < (band + 1) * width; k++)
+        {
+            double re = 0.0, im = 0.0;
+            if (k == 0)
+            {
+                continue;
+            }
+            for (uint16_t i = 0; i < points; i++)
+            {
+                double x = (samples[i] - mean) * 0.5 * (1.0 - cos(2.0 * M_PI * i / points));
+                re += x * cos(2.0 * M_PI * k * i / points);
+                im -= x * sin(2.0 * M_PI * k * i / points);
+            }
+            power += (re * re + im * im) / ((double)points * points);
+        }
+        bands[band] = sqrt(power * 16.0 / 3.0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    static const uint16_t sizes[] = {128, 256, 512};
+    static int16_t samples[SPECTRUM_MAX_POINTS];
+    static Spectrum_Complex bins[SPECTRUM_MAX_POINTS];
+    uint16_t rate_hz = ACQ_OUTPUT_HZ;
+    uint32_t blocks = 2000;
+    double max_error_mg = -1.0;
+    int failed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            rate_hz = (uint16_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            blocks = (uint32_t)atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+        {
+            max_error_mg = atof(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-r rate_hz] [-n blocks] [-e max_mg]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("Sample rate %u Hz, tones of 700 mg at %.2f Hz and 80 mg at %.2f Hz\n",
+           rate_hz, 0.23 * rate_hz, 0.37 * rate_hz);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        uint16_t points = sizes[s];
+        uint16_t bands[SPECTRUM_BANDS];
+        uint16_t peaks[2 * SPECTRUM_PEAKS];
+        double reference[SPECTRUM_BANDS];
+        double band_error = 0.0;
+        int8_t scale;
+
+        srand(1);
+        SpectrumBench_Signal(samples, points, rate_hz);
+        scale = Spectrum_Transform(samples, points, bins);
+        Spectrum_Bands(bins, points, scale, bands);
+        SpectrumBench_Reference(samples, points, reference);
+
+        printf("\n%u points (%.2f Hz per bin, block of %.2f s)\n", points,
+               (double)rate_hz / points, (double)points / rate_hz);
+        printf("  Bands (mg):");
+        for (int band = 0; band < SPECTRUM_BANDS; band++)
+        {
+            printf(" %5u", bands[band]);
+            if (fabs(bands[band] - reference[band]) > band_error)
+            {
+                band_error = fabs(bands[band] - reference[band]);
+            }
+        }
+        printf("\n  Largest band error against floating point: %.2f mg\n", band_error);
+        if (max_error_mg >= 0.0 && band_error > max_error_mg)
+        {
+            printf("  FAIL: band error above %.2f mg\n", max_error_mg);
+            failed = 1;
+        }
+
+        Spectrum_Peaks(bins, points, scale, rate_hz, peaks);
+        printf("  Peaks:");
+        for (int p = 0; p < SPECTRUM_PEAKS; p++)
+        {
+            printf("  %.2f Hz %u mg", peaks[2 * p] / 100.0, peaks[2 * p + 1]);
+        }
+        printf("\n");
+
+        struct timespec start, end;
+        volatile uint32_t sink = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t b = 0; b < blocks; b++)
+        {
+            samples[b % points] ^= 1;
+            scale = Spectrum_Transform(samples, points, bins);
+            Spectrum_Bands(bins, points, scale, bands);
+            sink += bands[0];
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double host_us = ((end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3) / blocks;
+        int stages = 0;
+        while ((1 << stages) < points)
+        {
+            stages++;
+        }
+        double m3_cycles = (double)BENCH_M3_CYCLES_PER_BUTTERFLY * points / 2 * stages +
+                           (double)BENCH_M3_CYCLES_PER_SAMPLE * points +
+                           (double)BENCH_M3_CYCLES_PER_BIN * points / 2;
+        double period_cycles = (double)ACQ_BUS_CLK_HZ * points / rate_hz;
+        long ram = 3L * 2 * points + 4L * points;
+        printf("  Host time           : %.1f us per axis\n", host_us);
+        printf("  Cortex-M3 estimate  : %.0f cycles per axis, %.2f ms for 3 axes (%.3f %% of the block)\n",
+               m3_cycles, 3.0 * m3_cycles * 1e3 / ACQ_BUS_CLK_HZ, 300.0 * m3_cycles / period_cycles);
+        printf("  RAM                 : %ld bytes of buffers, %ld of %d bytes with the rest of the firmware\n",
+               ram, ram + ACQ_RAM_BASE_BYTES, ACQ_SRAM_BYTES);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,56 @@
+/*
+* This file includes the host substitute of the firmware StackProbe: there
+* is no linker-defined stack, so a region of STACK_PROBE_SIM_SIZE bytes
+* below the caller of StackProbe_Paint is painted on the stack of the host
+* thread. The high-water mark is the one of the host build, whose frames
+* are larger than the ARM ones: it follows the call depth of the firmware,
+* not its byte count on the target.
+*/
+
+#include "StackProbe.h"
+
+#include <stdint.h>
+
+/**
+*   \brief Bytes of host stack watched below the caller of the paint.
+*/
+#define STACK_PROBE_SIM_SIZE 32768
+
+/**
+*   \brief Words left unpainted below the frame of StackProbe_Paint.
+*/
+#define STACK_PROBE_MARGIN 16
+
+static volatile uint32* stack_limit;
+static volatile uint32* stack_top;
+
+__attribute__((noinline)) void StackProbe_Paint(void)
+{
+    volatile uint32 here;
+    uintptr_t end = (uintptr_t)&here - STACK_PROBE_MARGIN * sizeof(uint32);
+
+    stack_top = (volatile uint32*)((uintptr_t)__builtin_frame_address(0) & ~(uintptr_t)3);
+    stack_limit = stack_top - STACK_PROBE_SIM_SIZE / sizeof(uint32);
+    for (volatile uint32* word = stack_limit; (uintptr_t)word < end; word++)
+    {
+        *word = STACK_PROBE_PATTERN;
+    }
+}
+
+uint32 StackProbe_Size(void)
+{
+    return STACK_PROBE_SIM_SIZE;
+}
+
+uint32 StackProbe_HighWater(void)
+{
+    volatile uint32* word = stack_limit;
+
+    while (word < stack_top && *word == STACK_PROBE_PATTERN)
+    {
+        word++;
+    }
+    return (uint32)((stack_top - word) * sizeof(uint32));
+}
+
+/* [] END OF FILE */
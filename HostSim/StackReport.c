@@ -0,0 +1,495 @@
+/*
+* This file includes the stack report: it builds the call graph of the
+* firmware from the assembler listings written by PSoC Creator (.lst) and
+* reports the worst-case stack depth of main and of each interrupt
+* service routine, with the call chain that reaches it.
+*
+* Usage: stack_report [-p] [-r root]... build_directory
+*
+* The frame of each function is taken from the -fstack-usage output (.su)
+* when the directory has it, otherwise from the largest CFA offset of the
+* function in its listing, which is the same number for code without
+* variable length arrays or alloca. Calls are the bl and b instructions to
+* a named symbol; calls through a register cannot be followed and are
+* listed. Functions without a listing, such as the C library, count as 0
+* bytes and are listed too, so that the figure is a lower bound whenever
+* they are reached.
+*
+* The roots are main and the functions nobody calls whose name ends with
+* ISR, _Interrupt or Handler, plus those given with -r. An interrupt adds
+* the 32 bytes stacked by the core on entry. The total assumes that the
+* interrupts cannot preempt each other, as with the equal priorities that
+* PSoC Creator assigns by default: -p sums all of them instead.
+*
+* Static functions of different files with the same name are merged and
+* take the larger frame.
+*/
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+*   \brief Longest line of a listing, longer ones are cut.
+*/
+#define STACK_MAX_LINE 1024
+
+/**
+*   \brief Largest number of functions, calls and roots.
+*/
+#define STACK_MAX_FUNCTIONS 2048
+#define STACK_MAX_CALLS 16384
+#define STACK_MAX_ROOTS 32
+
+/**
+*   \brief Longest function name.
+*/
+#define STACK_MAX_NAME 64
+
+/**
+*   \brief Bytes stacked by the Cortex-M3 on exception entry.
+*/
+#define STACK_EXCEPTION_FRAME 32
+
+/**
+*   \brief A function of the call graph.
+*/
+typedef struct {
+    char name[STACK_MAX_NAME];
+    uint32_t frame;             ///< Bytes of its own frame
+    uint8_t defined;            ///< Found in a listing or in a .su file
+    uint8_t from_su;            ///< Frame taken from the -fstack-usage output
+    uint8_t dynamic;            ///< Frame not bounded according to -fstack-usage
+    uint8_t indirect;           ///< Makes calls through a register
+    uint8_t called;             ///< Called by some other function
+    uint8_t state;              ///< 0 not visited, 1 on the path, 2 done
+    uint32_t depth;             ///< Worst-case depth, own frame included
+    int32_t deepest;            ///< Callee on the worst-case path, -1 if none
+} Stack_Function;
+
+/**
+*   \brief A call from a function to another, by index.
+*/
+typedef struct {
+    uint32_t caller;
+    uint32_t callee;
+} Stack_Call;
+
+static Stack_Function functions[STACK_MAX_FUNCTIONS];
+static uint32_t function_count;
+static Stack_Call calls[STACK_MAX_CALLS];
+static uint32_t call_count;
+static uint8_t recursive;
+
+/*
+* Index of the function of the given name, added if missing.
+*/
+static uint32_t Stack_Function_Index(const char* name)
+{
+    uint32_t i;
+
+    for (i = 0; i < function_count; i++)
+    {
+        if (strcmp(functions[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    if (function_count == STACK_MAX_FUNCTIONS)
+    {
+        fprintf(stderr, "More than %u functions\n", STACK_MAX_FUNCTIONS);
+        exit(EXIT_FAILURE);
+    }
+    snprintf(functions[i].name, STACK_MAX_NAME, "%.*s", STACK_MAX_NAME - 1, name);
+    functions[i].deepest = -1;
+    return function_count++;
+}
+
+static void Stack_AddCall(uint32_t caller, uint32_t callee)
+{
+    for (uint32_t i = 0; i < call_count; i++)
+    {
+        if (calls[i].caller == caller && calls[i].callee == callee)
+        {
+            return;
+        }
+    }
+    if (call_count == STACK_MAX_CALLS)
+    {
+        fprintf(stderr, "More than %u calls\n", STACK_MAX_CALLS);
+        exit(EXIT_FAILURE);
+    }
+    calls[call_count].caller = caller;
+    calls[call_count].callee = callee;
+    call_count++;
+    if (caller != callee)
+    {
+        functions[callee].called = 1;
+    }
+}
+
+static uint8_t Stack_IsSymbol(const char* text)
+{
+    if (!(text[0] == '_' || (text[0] >= 'A' && text[0] <= 'Z') || (text[0] >= 'a' && text[0] <= 'z')))
+    {
+        return 0;
+    }
+    for (; *text != '\0'; text++)
+    {
+        if (!(*text == '_' || *text == '.' || (*text >= '0' && *text <= '9') ||
+              (*text >= 'A' && *text <= 'Z') || (*text >= 'a' && *text <= 'z')))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+* Branches that transfer control to another function: bl, and b with any
+* condition or width suffix for the tail calls.
+*/
+static uint8_t Stack_IsCall(const char* mnemonic)
+{
+    static const char* const others[] = {"bic", "bics", "bfi", "bfc", "bkpt", "bx", "blx"};
+
+    if (mnemonic[0] != 'b' || strlen(mnemonic) > 5)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++)
+    {
+        if (strcmp(mnemonic, others[i]) == 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+* Read the functions of one assembler listing: their frames from the CFA
+* offsets, their calls from the branches to named symbols.
+*/
+static void Stack_ReadListing(FILE* listing)
+{
+    char line[STACK_MAX_LINE];
+    char type[STACK_MAX_NAME] = "";
+    char mnemonic[STACK_MAX_NAME + 2];
+    char operand[STACK_MAX_LINE];
+    int32_t current = -1;
+
+    while (fgets(line, sizeof(line), listing) != NULL)
+    {
+        char* code = strchr(line, '\t');
+        size_t length;
+        unsigned int offset;
+
+        // Lines of C source are quoted with "****", the code follows the first tab
+        if (strstr(line, "****") != NULL || code == NULL)
+        {
+            continue;
+        }
+        code += strspn(code, "\t");
+        code[strcspn(code, "\r\n")] = '\0';
+        length = strcspn(code, " \t");
+        if (length == 0 || length >= sizeof(mnemonic))
+        {
+            continue;
+        }
+        memcpy(mnemonic, code, length);
+        mnemonic[length] = '\0';
+        code += length;
+        snprintf(operand, sizeof(operand), "%s", code + strspn(code, " \t"));
+
+        if (strcmp(mnemonic, ".type") == 0 && strstr(operand, "%function") != NULL)
+        {
+            snprintf(type, sizeof(type), "%.*s", (int)strcspn(operand, ","), operand);
+        }
+        else if (type[0] != '\0' && strncmp(mnemonic, type, strlen(type)) == 0 &&
+                 strcmp(mnemonic + strlen(type), ":") == 0)
+        {
+            current = (int32_t)Stack_Function_Index(type);
+            functions[current].defined = 1;
+            type[0] = '\0';
+        }
+        else if (current < 0)
+        {
+            continue;
+        }
+        else if (strcmp(mnemonic, ".size") == 0)
+        {
+            current = -1;
+        }
+        else if (strcmp(mnemonic, ".cfi_def_cfa_offset") == 0 && sscanf(operand, "%u", &offset) == 1)
+        {
+            if (!functions[current].from_su && offset > functions[current].frame)
+            {
+                functions[current].frame = offset;
+            }
+        }
+        else if ((strcmp(mnemonic, "blx") == 0 || strcmp(mnemonic, "bx") == 0) &&
+                 strcmp(operand, "lr") != 0)
+        {
+            functions[current].indirect = 1;
+        }
+        else if (Stack_IsCall(mnemonic) && Stack_IsSymbol(operand))
+        {
+            Stack_AddCall((uint32_t)current, Stack_Function_Index(operand));
+        }
+    }
+}
+
+/*
+* Read the -fstack-usage output of one file: "file:line:column:name bytes
+* qualifiers", one function per line.
+*/
+static void Stack_ReadUsage(FILE* usage)
+{
+    char line[STACK_MAX_LINE];
+    char qualifiers[STACK_MAX_LINE];
+    unsigned int bytes;
+
+    while (fgets(line, sizeof(line), usage) != NULL)
+    {
+        char* tab = strchr(line, '\t');
+        char* name;
+
+        if (tab == NULL || sscanf(tab, "%u %s", &bytes, qualifiers) != 2)
+        {
+            continue;
+        }
+        *tab = '\0';
+        name = strrchr(line, ':');
+        name = (name != NULL) ? name + 1 : line;
+
+        Stack_Function* function = &functions[Stack_Function_Index(name)];
+        if (!function->from_su || bytes > function->frame)
+        {
+            function->frame = bytes;
+        }
+        function->from_su = 1;
+        function->defined = 1;
+        function->dynamic |= (strstr(qualifiers, "dynamic") != NULL &&
+                              strstr(qualifiers, "bounded") == NULL);
+    }
+}
+
+static uint32_t Stack_Depth(uint32_t index)
+{
+    Stack_Function* function = &functions[index];
+    uint32_t deepest = 0;
+
+    if (function->state == 2)
+    {
+        return function->depth;
+    }
+    if (function->state == 1)
+    {
+        // Recursion: the depth cannot be bounded, the loop is counted once
+        recursive = 1;
+        return 0;
+    }
+    function->state = 1;
+    for (uint32_t i = 0; i < call_count; i++)
+    {
+        if (calls[i].caller == index)
+        {
+            uint32_t depth = Stack_Depth(calls[i].callee);
+            if (depth > deepest || function->deepest < 0)
+            {
+                deepest = depth;
+                function->deepest = (int32_t)calls[i].callee;
+            }
+        }
+    }
+    function->depth = function->frame + deepest;
+    function->state = 2;
+    return function->depth;
+}
+
+static uint8_t Stack_IsInterrupt(const char* name)
+{
+    static const char* const suffixes[] = {"ISR", "_Interrupt", "Handler"};
+    size_t length = strlen(name);
+
+    for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++)
+    {
+        size_t suffix = strlen(suffixes[i]);
+        if (length >= suffix && strcmp(name + length - suffix, suffixes[i]) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void Stack_PrintPath(uint32_t index)
+{
+    int32_t next = (int32_t)index;
+    uint32_t count = 0;
+
+    while (next >= 0 && count++ < STACK_MAX_FUNCTIONS)
+    {
+        printf("%s%s(%u)", count > 1 ? " > " : "", functions[next].name, functions[next].frame);
+        next = functions[next].deepest;
+    }
+    printf("\n");
+}
+
+/*
+* Read every listing and -fstack-usage file of the directory, the latter
+* first so that their frames take precedence.
+*/
+static uint32_t Stack_ReadDirectory(const char* path, const char* extension)
+{
+    char file_path[STACK_MAX_LINE];
+    struct dirent* entry;
+    uint32_t files = 0;
+    DIR* directory = opendir(path);
+
+    if (directory == NULL)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    while ((entry = readdir(directory)) != NULL)
+    {
+        size_t length = strlen(entry->d_name);
+        if (length <= strlen(extension) ||
+            strcmp(entry->d_name + length - strlen(extension), extension) != 0)
+        {
+            continue;
+        }
+        snprintf(file_path, sizeof(file_path), "%s/%s", path, entry->d_name);
+        FILE* file = fopen(file_path, "r");
+        if (file == NULL)
+        {
+            perror(file_path);
+            continue;
+        }
+        if (strcmp(extension, ".su") == 0)
+        {
+            Stack_ReadUsage(file);
+        }
+        else
+        {
+            Stack_ReadListing(file);
+        }
+        fclose(file);
+        files++;
+    }
+    closedir(directory);
+    return files;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* roots[STACK_MAX_ROOTS];
+    uint32_t root_count = 0;
+    const char* path = NULL;
+    uint8_t preemption = 0;
+    uint32_t main_depth = 0, interrupt_depth = 0, unknown = 0, indirect = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-p") == 0)
+        {
+            preemption = 1;
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc && root_count < STACK_MAX_ROOTS)
+        {
+            roots[root_count++] = argv[++i];
+        }
+        else if (argv[i][0] != '-' && path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL)
+    {
+        fprintf(stderr, "Usage: %s [-p] [-r root]... build_directory\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t usage_files = Stack_ReadDirectory(path, ".su");
+    uint32_t listing_files = Stack_ReadDirectory(path, ".lst");
+    if (listing_files == 0)
+    {
+        fprintf(stderr, "%s: no listings, enable Create Listing File in the build settings\n", path);
+        return EXIT_FAILURE;
+    }
+    printf("%u functions from %u listings, frames from %s\n\n", function_count, listing_files,
+           usage_files > 0 ? "-fstack-usage" : "the CFA offsets of the listings");
+
+    printf("%-32s %6s  %s\n", "Root", "Bytes", "Deepest call chain (own frame)");
+    for (uint32_t i = 0; i < function_count; i++)
+    {
+        uint8_t is_main = strcmp(functions[i].name, "main") == 0;
+        uint8_t is_root = is_main || (!functions[i].called && Stack_IsInterrupt(functions[i].name));
+
+        for (uint32_t r = 0; r < root_count; r++)
+        {
+            is_root |= strcmp(functions[i].name, roots[r]) == 0;
+        }
+        if (!is_root || !functions[i].defined)
+        {
+            continue;
+        }
+
+        uint32_t depth = Stack_Depth(i);
+        if (is_main)
+        {
+            main_depth = depth;
+        }
+        else
+        {
+            depth += STACK_EXCEPTION_FRAME;
+            interrupt_depth = preemption ? interrupt_depth + depth :
+                              (depth > interrupt_depth ? depth : interrupt_depth);
+        }
+        printf("%-32s %6u  ", functions[i].name, depth);
+        Stack_PrintPath(i);
+    }
+
+    printf("\nWorst case: %u bytes (main %u + %s %u)\n", main_depth + interrupt_depth, main_depth,
+           preemption ? "all interrupts" : "deepest interrupt", interrupt_depth);
+
+    for (uint32_t i = 0; i < function_count; i++)
+    {
+        if (functions[i].state == 2 && !functions[i].defined)
+        {
+            printf("%s%s", unknown++ == 0 ? "Not measured (0 bytes): " : ", ", functions[i].name);
+        }
+    }
+    if (unknown > 0)
+    {
+        printf("\n");
+    }
+    for (uint32_t i = 0; i < function_count; i++)
+    {
+        if (functions[i].state == 2 && (functions[i].indirect || functions[i].dynamic))
+        {
+            printf("%s%s%s", indirect++ == 0 ? "Not bounded (indirect calls or dynamic frames): " : ", ",
+                   functions[i].name, functions[i].dynamic ? " (dynamic)" : "");
+        }
+    }
+    if (indirect > 0)
+    {
+        printf("\n");
+    }
+    if (recursive)
+    {
+        printf("Recursion found: the depth of the recursive calls is counted once\n");
+    }
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,35 @@
+/**
+*   \file CyFlash.h
+*   \brief Host replacement of the PSoC Creator flash programming API.
+*/
+
+#ifndef __CYFLASH_H
+    #define __CYFLASH_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Flash of the CY8C5888, in arrays of 256 rows of 256 bytes.
+    *
+    *   The flash is mapped on an array of the simulation, blank (all
+    *   zeros) unless loaded from a file by the harness.
+    */
+    extern uint8 HostSim_Flash[];
+
+    #define CY_FLASH_BASE           ((uintptr_t)HostSim_Flash)
+    #define CY_FLASH_SIZE           (0x40000u)
+    #define CY_FLASH_SIZEOF_ARRAY   (0x10000u)
+    #define CY_FLASH_SIZEOF_ROW     (256u)
+
+    /**
+    *   \brief Read the die temperature needed by the flash programming.
+    */
+    cystatus CySetTemp(void);
+
+    /**
+    *   \brief Erase and program a row of the flash.
+    */
+    cystatus CyWriteRowData(uint8 arrayId, uint16 rowAddress, const uint8* rowData);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,40 @@
+/**
+*   \file CyLib.h
+*   \brief Host replacement of the PSoC Creator system library.
+*/
+
+#ifndef __CYLIB_H
+    #define __CYLIB_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Bus clock the simulated part is running at.
+    */
+    #define BCLK__BUS_CLK__HZ 24000000u
+
+    void HostSim_GlobalIntEnable(void);
+    void HostSim_GlobalIntDisable(void);
+
+    #define CyGlobalIntEnable  HostSim_GlobalIntEnable()
+    #define CyGlobalIntDisable HostSim_GlobalIntDisable()
+
+    void CyDelay(uint32 milliseconds);
+    void CyDelayUs(uint16 microseconds);
+
+    void CyFlushCache(void);
+
+    uint8 CyEnterCriticalSection(void);
+    void CyExitCriticalSection(uint8 savedIntrStatus);
+
+    /**
+    *   \brief Interrupts of the controller, and priority they start at.
+    */
+    #define CY_INT_NUMBER_MAX 31u
+    #define CY_INT_DEFAULT_PRIORITY 7u
+
+    void CyIntSetPriority(uint8 number, uint8 priority);
+    uint8 CyIntGetPriority(uint8 number);
+
+#endif
+/* [] END OF FILE */
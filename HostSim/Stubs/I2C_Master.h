@@ -0,0 +1,42 @@
+/**
+*   \file I2C_Master.h
+*   \brief Host replacement of the I2C_Master component API.
+*
+*   The blocking master functions are backed by the LIS3DH model and cost
+*   the virtual time of the corresponding bus transfer.
+*/
+
+#ifndef __I2C_MASTER_H
+    #define __I2C_MASTER_H
+
+    #include "cytypes.h"
+
+    #define I2C_Master_WRITE_XFER_MODE          (0x00u)
+    #define I2C_Master_READ_XFER_MODE           (0x01u)
+
+    #define I2C_Master_ACK_DATA                 (0x01u)
+    #define I2C_Master_NAK_DATA                 (0x00u)
+
+    #define I2C_Master_MSTR_NO_ERROR            (0x00u)
+    #define I2C_Master_MSTR_BUS_BUSY            (0x01u)
+    #define I2C_Master_MSTR_NOT_READY           (0x02u)
+    #define I2C_Master_MSTR_ERR_LB_NAK          (0x03u)
+    #define I2C_Master_MSTR_ERR_ARB_LOST        (0x04u)
+    #define I2C_Master_MSTR_ERR_ABORT_START_GEN (0x05u)
+
+    /**
+    *   \brief Interrupt of the fixed-function I2C block.
+    */
+    #define I2C_Master_ISR_NUMBER               (15u)
+
+    void I2C_Master_Start(void);
+    void I2C_Master_Stop(void);
+
+    uint8 I2C_Master_MasterSendStart(uint8 slaveAddress, uint8 R_nW);
+    uint8 I2C_Master_MasterSendRestart(uint8 slaveAddress, uint8 R_nW);
+    uint8 I2C_Master_MasterSendStop(void);
+    uint8 I2C_Master_MasterWriteByte(uint8 theByte);
+    uint8 I2C_Master_MasterReadByte(uint8 acknNak);
+
+#endif
+/* [] END OF FILE */
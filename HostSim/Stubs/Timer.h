@@ -0,0 +1,33 @@
+/**
+*   \file Timer.h
+*   \brief Host replacement of the Timer component API.
+*
+*   The timer is clocked by timer_clock (20 kHz) and, with the period set
+*   in TopDesign, raises its terminal count at 200 Hz.
+*/
+
+#ifndef __TIMER_H
+    #define __TIMER_H
+
+    #include "cytypes.h"
+
+    /**
+    *   \brief Frequency of timer_clock as set in TopDesign.
+    */
+    #define Timer_CLOCK_HZ              (20000u)
+
+    #define Timer_INIT_PERIOD           (99u)
+
+    #define Timer_STATUS_TC             (0x01u)
+
+    void Timer_Start(void);
+    void Timer_Stop(void);
+
+    uint8 Timer_ReadStatusRegister(void);
+
+    uint16 Timer_ReadPeriod(void);
+    void Timer_WritePeriod(uint16 period);
+    uint16 Timer_ReadCounter(void);
+
+#endif
+/* [] END OF FILE */
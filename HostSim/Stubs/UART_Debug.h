@@ -0,0 +1,30 @@
+/**
+*   \file UART_Debug.h
+*   \brief Host replacement of the UART_Debug component API.
+*
+*   Transmitted bytes are serialized at the configured baud rate in
+*   virtual time and captured by the host harness; received bytes are
+*   queued by the harness with the time they arrive at.
+*/
+
+#ifndef __UART_DEBUG_H
+    #define __UART_DEBUG_H
+
+    #include "cytypes.h"
+
+    void UART_Debug_Start(void);
+    void UART_Debug_Stop(void);
+
+    void UART_Debug_PutChar(uint8 txDataByte);
+    void UART_Debug_PutString(const char8 string[]);
+    void UART_Debug_PutArray(const uint8 string[], uint8 byteCount);
+    void UART_Debug_PutCRLF(uint8 txDataByte);
+
+    uint8 UART_Debug_GetTxBufferSize(void);
+    void UART_Debug_ClearTxBuffer(void);
+
+    uint8 UART_Debug_GetChar(void);
+    uint8 UART_Debug_GetRxBufferSize(void);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,21 @@
+/**
+*   \file UART_Debug_IntClock.h
+*   \brief Host replacement of the clock of the UART_Debug component.
+*
+*   The divider of the bus clock sets the baud rate of the simulated
+*   UART, which samples each bit eight times.
+*/
+
+#ifndef __UART_DEBUG_INTCLOCK_H
+    #define __UART_DEBUG_INTCLOCK_H
+
+    #include "cytypes.h"
+
+    void UART_Debug_IntClock_SetDividerRegister(uint16 clkDivider, uint8 restart);
+    uint16 UART_Debug_IntClock_GetDividerRegister(void);
+
+    #define UART_Debug_IntClock_SetDividerValue(clkDivider) \
+        UART_Debug_IntClock_SetDividerRegister((clkDivider) - 1u, 1u)
+
+#endif
+/* [] END OF FILE */
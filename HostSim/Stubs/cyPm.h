@@ -0,0 +1,33 @@
+/**
+*   \file cyPm.h
+*   \brief Host replacement of the PSoC Creator power management API.
+*
+*   Only the halt of the CPU is modeled, by WFI or Alternate Active: the
+*   CPU is halted until the next interrupt, and the time spent halted is
+*   counted as idle.
+*/
+
+#ifndef __CYPM_H
+    #define __CYPM_H
+
+    #include "cytypes.h"
+
+    #define PM_ALT_ACT_TIME_NONE    (0x0000u)
+    #define PM_ALT_ACT_SRC_NONE     (0x0000u)
+
+    /**
+    *   \brief Halt the CPU until an interrupt is pending.
+    *
+    *   As WFI, it returns when an interrupt becomes pending even if
+    *   interrupts are globally disabled.
+    */
+    void CyPmAltAct(uint16 wakeupTime, uint16 wakeupSource);
+
+    /**
+    *   \brief Wait for interrupt, halting the CPU as CyPmAltAct().
+    */
+    #define CY_PM_WFI HostSim_WaitForInterrupt()
+    void HostSim_WaitForInterrupt(void);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/**
+*   \file cy_em_eeprom.h
+*   \brief Host replacement of the Emulated EEPROM library.
+*
+*   The contents are kept by the simulation, not in the flash array given
+*   as userFlashStartAddr, which the firmware declares const. Each write
+*   takes the time of the flash rows it programs.
+*/
+
+#ifndef __CY_EM_EEPROM_H
+    #define __CY_EM_EEPROM_H
+
+    #include "cytypes.h"
+    #include "CyFlash.h"
+
+    /**
+    *   \brief Largest wear leveling factor.
+    */
+    #define CY_EM_EEPROM_MAX_WEAR_LEVELING_FACTOR   (10u)
+
+    /**
+    *   \brief EEPROM bytes kept in a flash row: the other half holds the
+    *   header and the last data written.
+    */
+    #define CY_EM_EEPROM_EEPROM_DATA_LEN            (CY_FLASH_SIZEOF_ROW / 2u)
+
+    #define CY_EM_EEPROM_GET_NUM_ROWS_IN_EEPROM(dataSize) \
+        (((dataSize) + CY_EM_EEPROM_EEPROM_DATA_LEN - 1u) / CY_EM_EEPROM_EEPROM_DATA_LEN)
+
+    /**
+    *   \brief Bytes of flash to be reserved for an EEPROM of the given size.
+    */
+    #define CY_EM_EEPROM_GET_PHYSICAL_SIZE(dataSize, wearLevelingFactor, redundantCopy) \
+        (CY_EM_EEPROM_GET_NUM_ROWS_IN_EEPROM(dataSize) * CY_FLASH_SIZEOF_ROW * \
+         (wearLevelingFactor) * (1u + (redundantCopy)))
+
+    typedef enum {
+        CY_EM_EEPROM_SUCCESS,
+        CY_EM_EEPROM_BAD_PARAM,
+        CY_EM_EEPROM_BAD_CHECKSUM,
+        CY_EM_EEPROM_BAD_DATA,
+        CY_EM_EEPROM_WRITE_FAIL
+    } cy_en_em_eeprom_status_t;
+
+    typedef struct {
+        uint32 eepromSize;
+        uint32 wearLevelingFactor;
+        uint8 redundantCopy;
+        uint8 blockingWrite;
+        uintptr_t userFlashStartAddr;
+    } cy_stc_eeprom_config_t;
+
+    typedef struct {
+        uint32 eepromSize;
+        uint32 numberOfRows;
+        uint32 wearLevelingFactor;
+        uint8 redundantCopy;
+        uint8 blockingWrite;
+        uintptr_t userFlashStartAddr;
+    } cy_stc_eeprom_context_t;
+
+    cy_en_em_eeprom_status_t Cy_Em_EEPROM_Init(cy_stc_eeprom_config_t* config, cy_stc_eeprom_context_t* context);
+    cy_en_em_eeprom_status_t Cy_Em_EEPROM_Read(uint32 addr, void* eepromData, uint32 size,
+                                               cy_stc_eeprom_context_t* context);
+    cy_en_em_eeprom_status_t Cy_Em_EEPROM_Write(uint32 addr, void* eepromData, uint32 size,
+                                                cy_stc_eeprom_context_t* context);
+#endif
+/* [] END OF FILE */
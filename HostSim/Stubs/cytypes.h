@@ -0,0 +1,48 @@
+/**
+*   \file cytypes.h
+*   \brief Host replacement of the PSoC Creator cytypes.h.
+*
+*   Only the types and macros used by the firmware sources are provided.
+*/
+
+#ifndef __CYTYPES_H
+    #define __CYTYPES_H
+
+    #include <stdint.h>
+    #include <stddef.h>
+
+    typedef unsigned char   uint8;
+    typedef unsigned short  uint16;
+    typedef unsigned int    uint32;
+    typedef signed char     int8;
+    typedef signed short    int16;
+    typedef signed int      int32;
+    typedef float           float32;
+    typedef double          float64;
+    typedef char            char8;
+    typedef uint8           CYBIT;
+    typedef uint32          cystatus;
+
+    typedef volatile uint8  reg8;
+    typedef volatile uint16 reg16;
+    typedef volatile uint32 reg32;
+
+    typedef void (* cyisraddress)(void);
+
+    #define CY_ISR(FuncName)        void FuncName (void)
+    #define CY_ISR_PROTO(FuncName)  void FuncName (void)
+
+    #define CY_NOINIT
+    #define CY_INLINE               inline
+    #define CY_ALIGN(align)         __attribute__ ((aligned (align)))
+
+    #define CYRET_SUCCESS           (0x00u)
+    #define CYRET_BAD_PARAM         (0x01u)
+
+    #define LO8(x)                  ((uint8) ((x) & 0xFFu))
+    #define HI8(x)                  ((uint8) ((uint16)(x) >> 8))
+    #define LO16(x)                 ((uint16) ((x) & 0xFFFFu))
+    #define HI16(x)                 ((uint16) ((uint32)(x) >> 16))
+
+#endif
+/* [] END OF FILE */
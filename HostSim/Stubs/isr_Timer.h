@@ -0,0 +1,27 @@
+/**
+*   \file isr_Timer.h
+*   \brief Host replacement of the isr_Timer interrupt component API.
+*/
+
+#ifndef __ISR_TIMER_H
+    #define __ISR_TIMER_H
+
+    #include "cytypes.h"
+
+    void isr_Timer_Start(void);
+    void isr_Timer_StartEx(cyisraddress address);
+    void isr_Timer_Stop(void);
+
+    void isr_Timer_Enable(void);
+    void isr_Timer_Disable(void);
+
+    /**
+    *   \brief Priority of the interrupt as set in the design.
+    */
+    #define isr_Timer_INTC_PRIOR_NUMBER 7u
+
+    void isr_Timer_SetPriority(uint8 priority);
+    uint8 isr_Timer_GetPriority(void);
+
+#endif
+/* [] END OF FILE */
@@ -0,0 +1,23 @@
+/**
+*   \file project.h
+*   \brief Host replacement of the PSoC Creator generated project.h.
+*
+*   Includes the simulated components of the AY1920_II_HW_05 designs.
+*/
+
+#ifndef __PROJECT_H
+    #define __PROJECT_H
+
+    #include "cytypes.h"
+    #include "CyLib.h"
+    #include "CyFlash.h"
+    #include "cy_em_eeprom.h"
+    #include "cyPm.h"
+    #include "I2C_Master.h"
+    #include "UART_Debug.h"
+    #include "UART_Debug_IntClock.h"
+    #include "Timer.h"
+    #include "isr_Timer.h"
+
+#endif
+/* [] END OF FILE */
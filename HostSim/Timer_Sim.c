@@ -0,0 +1,147 @@
+/*
+* This file includes the simulated Timer and isr_Timer components. The
+* terminal count is a periodic virtual time event that sets the status
+* register and, if enabled, calls the interrupt handler. As in the UDB
+* Timer, a period written while it runs is loaded at the next terminal
+* count.
+*/
+
+#include "Timer.h"
+#include "isr_Timer.h"
+#include "HostSim.h"
+#include "HostSim_Private.h"
+#include "VirtualTime.h"
+
+static int timer_event = -1;
+static uint16 timer_period = Timer_INIT_PERIOD;
+static uint16 timer_loaded = Timer_INIT_PERIOD;
+static uint64_t timer_started_ns;
+static uint8 timer_status;
+static cyisraddress isr_handler;
+static uint8 isr_enabled;
+static uint8 isr_priority = isr_Timer_INTC_PRIOR_NUMBER;
+
+static uint64_t Timer_Sim_PeriodNs(void)
+{
+    return ((uint64_t)timer_loaded + 1u) * VIRTUAL_TIME_NS_PER_S / Timer_CLOCK_HZ;
+}
+
+/*
+* Interrupt entry, counting the handler calls whether they are serviced at
+* once or left pending while interrupts are disabled.
+*/
+static void Timer_Sim_Isr(void)
+{
+    host_sim_stats.timer_isr_calls++;
+    isr_handler();
+}
+
+static void Timer_Sim_TerminalCount(void)
+{
+    host_sim_stats.timer_ticks++;
+    timer_started_ns = VirtualTime_Now();
+    timer_status |= Timer_STATUS_TC;
+    if (timer_loaded != timer_period)
+    {
+        timer_loaded = timer_period;
+        VirtualTime_SetPeriod(timer_event, Timer_Sim_PeriodNs());
+    }
+    if (isr_enabled && isr_handler != NULL)
+    {
+        HostSim_RaiseInterrupt(Timer_Sim_Isr);
+    }
+}
+
+void HostSim_TimerReset(void)
+{
+    timer_event = -1;
+    timer_period = Timer_INIT_PERIOD;
+    timer_loaded = Timer_INIT_PERIOD;
+    timer_status = 0;
+    isr_handler = NULL;
+    isr_enabled = 0;
+    isr_priority = isr_Timer_INTC_PRIOR_NUMBER;
+}
+
+void Timer_Start(void)
+{
+    if (timer_event < 0)
+    {
+        timer_started_ns = VirtualTime_Now();
+        timer_loaded = timer_period;
+        timer_event = VirtualTime_AddPeriodic(Timer_Sim_PeriodNs(), Timer_Sim_TerminalCount);
+    }
+}
+
+void Timer_Stop(void)
+{
+    VirtualTime_Remove(timer_event);
+    timer_event = -1;
+}
+
+uint8 Timer_ReadStatusRegister(void)
+{
+    uint8 status = timer_status;
+    timer_status = 0;
+    return status;
+}
+
+uint16 Timer_ReadPeriod(void)
+{
+    return timer_period;
+}
+
+void Timer_WritePeriod(uint16 period)
+{
+    timer_period = period;
+}
+
+uint16 Timer_ReadCounter(void)
+{
+    // Down counter holding 0 for the count of the terminal count, then
+    // reloaded with the period
+    uint64_t elapsed = (VirtualTime_Now() - timer_started_ns) * Timer_CLOCK_HZ / VIRTUAL_TIME_NS_PER_S;
+    if (elapsed == 0 || elapsed > timer_loaded)
+    {
+        return 0;
+    }
+    return (uint16)(timer_loaded + 1 - elapsed);
+}
+
+void isr_Timer_Start(void)
+{
+    isr_enabled = 1;
+}
+
+void isr_Timer_StartEx(cyisraddress address)
+{
+    isr_handler = address;
+    isr_enabled = 1;
+}
+
+void isr_Timer_Stop(void)
+{
+    isr_enabled = 0;
+}
+
+void isr_Timer_Enable(void)
+{
+    isr_enabled = 1;
+}
+
+void isr_Timer_Disable(void)
+{
+    isr_enabled = 0;
+}
+
+void isr_Timer_SetPriority(uint8 priority)
+{
+    isr_priority = priority & 0x07u;
+}
+
+uint8 isr_Timer_GetPriority(void)
+{
+    return isr_priority;
+}
+
+/* [] END OF FILE */
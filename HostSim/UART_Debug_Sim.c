@@ -0,0 +1,235 @@
+/*
+* This file includes the simulated UART_Debug component: transmitted bytes
+* are serialized at the configured baud rate, and PutChar blocks while the
+* hardware FIFO is full, as the real component does. Received bytes come
+* from a queue filled by the harness. The divider of UART_Debug_IntClock
+* changes the baud rate, as the bus clock it divides does.
+*/
+
+#include "UART_Debug.h"
+#include "UART_Debug_IntClock.h"
+#include "HostSim.h"
+#include "HostSim_Private.h"
+#include "VirtualTime.h"
+
+/**
+*   \brief Bits on the line per byte: start, 8 data bits, stop.
+*/
+#define UART_BITS_PER_BYTE 10u
+
+/**
+*   \brief Divider of the bus clock closest to a baud rate, minus one as in the register.
+*/
+#define UART_DIVIDER_REGISTER(clock, rate) \
+    (((clock) + HOST_SIM_UART_OVERSAMPLE * (rate) / 2) / (HOST_SIM_UART_OVERSAMPLE * (rate)) - 1u)
+
+static uint32_t bus_clk_hz = HOST_SIM_BUS_CLK_HZ;
+static uint32_t baud = HOST_SIM_DEFAULT_BAUD;
+static uint16_t divider = UART_DIVIDER_REGISTER(HOST_SIM_BUS_CLK_HZ, HOST_SIM_DEFAULT_BAUD);
+static uint8_t tx_data[HOST_SIM_UART_TX_DEPTH];
+static uint64_t tx_done_ns[HOST_SIM_UART_TX_DEPTH];
+static uint8_t tx_head;
+static uint8_t tx_count;
+static uint8_t rx_data[HOST_SIM_UART_RX_DEPTH];
+static uint64_t rx_at_ns[HOST_SIM_UART_RX_DEPTH];
+static uint8_t rx_head;
+static uint8_t rx_count;
+static FILE* capture;
+static HostSim_UartSink sink;
+
+void HostSim_SetBaudRate(uint32_t rate)
+{
+    baud = rate;
+    divider = UART_DIVIDER_REGISTER(bus_clk_hz, rate);
+}
+
+void HostSim_SetBusClock(uint32_t hz)
+{
+    bus_clk_hz = hz;
+    baud = bus_clk_hz / (HOST_SIM_UART_OVERSAMPLE * ((uint32_t)divider + 1u));
+}
+
+void HostSim_SetUartCapture(FILE* file)
+{
+    capture = file;
+}
+
+void HostSim_SetUartSink(HostSim_UartSink callback)
+{
+    sink = callback;
+}
+
+/*
+* Hand the byte at the head of the FIFO over to the line.
+*/
+static void UART_Debug_Sim_Pop(void)
+{
+    uint8_t data = tx_data[tx_head];
+    host_sim_stats.uart_bytes++;
+    if (capture != NULL)
+    {
+        fputc(data, capture);
+    }
+    if (sink != NULL)
+    {
+        sink(data, tx_done_ns[tx_head]);
+    }
+    tx_head = (tx_head + 1) % HOST_SIM_UART_TX_DEPTH;
+    tx_count--;
+}
+
+/*
+* Remove from the FIFO all the bytes already sent.
+*/
+static void UART_Debug_Sim_Drain(void)
+{
+    while (tx_count > 0 && tx_done_ns[tx_head] <= VirtualTime_Now())
+    {
+        UART_Debug_Sim_Pop();
+    }
+}
+
+void HostSim_UartReset(void)
+{
+    bus_clk_hz = HOST_SIM_BUS_CLK_HZ;
+    baud = HOST_SIM_DEFAULT_BAUD;
+    divider = UART_DIVIDER_REGISTER(HOST_SIM_BUS_CLK_HZ, HOST_SIM_DEFAULT_BAUD);
+    tx_head = 0;
+    tx_count = 0;
+    rx_head = 0;
+    rx_count = 0;
+}
+
+uint8_t HostSim_UartReceive(uint8_t data, uint64_t at_ns)
+{
+    if (rx_count >= HOST_SIM_UART_RX_DEPTH)
+    {
+        return 1;
+    }
+    uint8_t slot = (rx_head + rx_count) % HOST_SIM_UART_RX_DEPTH;
+    rx_data[slot] = data;
+    rx_at_ns[slot] = at_ns;
+    rx_count++;
+    return 0;
+}
+
+void HostSim_UartFlush(void)
+{
+    while (tx_count > 0)
+    {
+        UART_Debug_Sim_Pop();
+    }
+}
+
+void UART_Debug_Start(void)
+{
+}
+
+void UART_Debug_Stop(void)
+{
+}
+
+void UART_Debug_PutChar(uint8 txDataByte)
+{
+    UART_Debug_Sim_Drain();
+    while (tx_count >= HOST_SIM_UART_TX_DEPTH)
+    {
+        // FIFO full: wait for the byte being shifted out
+        uint64_t wait_ns = tx_done_ns[tx_head] - VirtualTime_Now();
+        host_sim_stats.uart_blocked_ns += wait_ns;
+        VirtualTime_Advance(wait_ns);
+        UART_Debug_Sim_Drain();
+    }
+
+    uint64_t byte_ns = (uint64_t)UART_BITS_PER_BYTE * VIRTUAL_TIME_NS_PER_S / baud;
+    uint64_t start_ns = VirtualTime_Now();
+    if (tx_count > 0)
+    {
+        uint8_t last = (tx_head + tx_count - 1) % HOST_SIM_UART_TX_DEPTH;
+        start_ns = tx_done_ns[last];
+    }
+    uint8_t slot = (tx_head + tx_count) % HOST_SIM_UART_TX_DEPTH;
+    tx_data[slot] = txDataByte;
+    tx_done_ns[slot] = start_ns + byte_ns;
+    tx_count++;
+}
+
+void UART_Debug_PutString(const char8 string[])
+{
+    for (uint32_t i = 0; string[i] != 0; i++)
+    {
+        UART_Debug_PutChar((uint8)string[i]);
+    }
+}
+
+void UART_Debug_PutArray(const uint8 string[], uint8 byteCount)
+{
+    for (uint8 i = 0; i < byteCount; i++)
+    {
+        UART_Debug_PutChar(string[i]);
+    }
+}
+
+void UART_Debug_PutCRLF(uint8 txDataByte)
+{
+    UART_Debug_PutChar(txDataByte);
+    UART_Debug_PutChar('\r');
+    UART_Debug_PutChar('\n');
+}
+
+uint8 UART_Debug_GetTxBufferSize(void)
+{
+    UART_Debug_Sim_Drain();
+    if (tx_count > 0)
+    {
+        // Let a polling loop see the bytes go out
+        VirtualTime_Advance(HOST_SIM_STATUS_POLL_NS);
+    }
+    return tx_count;
+}
+
+void UART_Debug_ClearTxBuffer(void)
+{
+    tx_count = 0;
+}
+
+void UART_Debug_IntClock_SetDividerRegister(uint16 clkDivider, uint8 restart)
+{
+    (void)restart;
+    divider = clkDivider;
+    baud = bus_clk_hz / (HOST_SIM_UART_OVERSAMPLE * ((uint32_t)clkDivider + 1u));
+}
+
+uint16 UART_Debug_IntClock_GetDividerRegister(void)
+{
+    return divider;
+}
+
+uint8 UART_Debug_GetRxBufferSize(void)
+{
+    uint8 count = 0;
+
+    while (count < rx_count && rx_at_ns[(rx_head + count) % HOST_SIM_UART_RX_DEPTH] <= VirtualTime_Now())
+    {
+        count++;
+    }
+    return count;
+}
+
+uint8 UART_Debug_GetChar(void)
+{
+    uint8 data;
+
+    // Zero when no byte has arrived, as the real component
+    if (UART_Debug_GetRxBufferSize() == 0)
+    {
+        return 0;
+    }
+    data = rx_data[rx_head];
+    rx_head = (rx_head + 1) % HOST_SIM_UART_RX_DEPTH;
+    rx_count--;
+    host_sim_stats.uart_rx_bytes++;
+    return data;
+}
+
+/* [] END OF FILE */
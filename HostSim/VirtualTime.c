@@ -0,0 +1,153 @@
+/*
+* This file includes the virtual clock shared by all the simulated
+* peripherals.
+*/
+
+#include "VirtualTime.h"
+
+#include <setjmp.h>
+
+/**
+*   \brief State of a periodic event.
+*/
+typedef struct {
+    uint8_t active;                 ///< Event slot in use
+    uint64_t period_ns;             ///< Period of the event
+    uint64_t next_ns;               ///< Next expiration time
+    VirtualTime_Handler handler;    ///< Callback to be fired
+} VirtualTime_Event;
+
+static uint64_t now_ns;
+static uint64_t deadline_ns = UINT64_MAX;
+static VirtualTime_Event events[VIRTUAL_TIME_MAX_EVENTS];
+static jmp_buf run_exit;
+static uint8_t running;
+static uint8_t in_handler;
+
+void VirtualTime_Reset(void)
+{
+    now_ns = 0;
+    deadline_ns = UINT64_MAX;
+    for (int i = 0; i < VIRTUAL_TIME_MAX_EVENTS; i++)
+    {
+        events[i].active = 0;
+    }
+}
+
+uint64_t VirtualTime_Now(void)
+{
+    return now_ns;
+}
+
+/*
+* Return the index of the first event to expire not later than limit_ns,
+* or -1 if there is none.
+*/
+static int VirtualTime_NextEvent(uint64_t limit_ns)
+{
+    int next = -1;
+    for (int i = 0; i < VIRTUAL_TIME_MAX_EVENTS; i++)
+    {
+        if (events[i].active && events[i].next_ns <= limit_ns &&
+            (next < 0 || events[i].next_ns < events[next].next_ns))
+        {
+            next = i;
+        }
+    }
+    return next;
+}
+
+static void VirtualTime_CheckDeadline(void)
+{
+    if (running && now_ns >= deadline_ns)
+    {
+        running = 0;
+        longjmp(run_exit, 1);
+    }
+}
+
+void VirtualTime_Advance(uint64_t ns)
+{
+    uint64_t target_ns = now_ns + ns;
+    int next;
+
+    // Fire the events in order; handlers may advance time on their own,
+    // but events expiring meanwhile stay pending as nested interrupts would
+    while (!in_handler && (next = VirtualTime_NextEvent(target_ns)) >= 0)
+    {
+        if (events[next].next_ns > now_ns)
+        {
+            now_ns = events[next].next_ns;
+        }
+        events[next].next_ns += events[next].period_ns;
+        VirtualTime_CheckDeadline();
+        in_handler = 1;
+        events[next].handler();
+        in_handler = 0;
+    }
+    if (target_ns > now_ns)
+    {
+        now_ns = target_ns;
+    }
+    VirtualTime_CheckDeadline();
+}
+
+void VirtualTime_AdvanceToNextEvent(void)
+{
+    int next = VirtualTime_NextEvent(UINT64_MAX);
+    if (next < 0)
+    {
+        // Nothing will ever wake the CPU up: the run is over
+        now_ns = deadline_ns;
+        VirtualTime_CheckDeadline();
+        return;
+    }
+    VirtualTime_Advance(events[next].next_ns > now_ns ? events[next].next_ns - now_ns : 0);
+}
+
+int VirtualTime_AddPeriodic(uint64_t period_ns, VirtualTime_Handler handler)
+{
+    for (int i = 0; i < VIRTUAL_TIME_MAX_EVENTS; i++)
+    {
+        if (!events[i].active)
+        {
+            events[i].active = 1;
+            events[i].period_ns = period_ns;
+            events[i].next_ns = now_ns + period_ns;
+            events[i].handler = handler;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void VirtualTime_SetPeriod(int event_id, uint64_t period_ns)
+{
+    if (event_id >= 0 && event_id < VIRTUAL_TIME_MAX_EVENTS)
+    {
+        events[event_id].period_ns = period_ns;
+        events[event_id].next_ns = now_ns + period_ns;
+    }
+}
+
+void VirtualTime_Remove(int event_id)
+{
+    if (event_id >= 0 && event_id < VIRTUAL_TIME_MAX_EVENTS)
+    {
+        events[event_id].active = 0;
+    }
+}
+
+void VirtualTime_Run(void (*entry)(void), uint64_t duration_ns)
+{
+    deadline_ns = now_ns + duration_ns;
+    running = 1;
+    in_handler = 0;
+    if (setjmp(run_exit) == 0)
+    {
+        entry();
+    }
+    running = 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/**
+*   \file VirtualTime.h
+*   \brief Virtual time base of the host simulation.
+*
+*   The firmware runs on the host as fast as the host CPU allows, while
+*   every simulated peripheral advances a common virtual clock by the time
+*   the real operation would take on the PSoC (I2C bits, UART bytes,
+*   CyDelay, ...). Periodic events (e.g. the Timer terminal count) are
+*   fired from here, so that interrupts are delivered at the right virtual
+*   instant, at the granularity of the peripheral calls.
+*/
+
+#ifndef __VIRTUAL_TIME_H
+    #define __VIRTUAL_TIME_H
+
+    #include <stdint.h>
+
+    /**
+    *   \brief Nanoseconds in one second.
+    */
+    #define VIRTUAL_TIME_NS_PER_S 1000000000ull
+
+    /**
+    *   \brief Maximum number of periodic events that can be registered.
+    */
+    #define VIRTUAL_TIME_MAX_EVENTS 8
+
+    /**
+    *   \brief Callback invoked when a periodic event expires.
+    */
+    typedef void (*VirtualTime_Handler)(void);
+
+    /**
+    *   \brief Reset the virtual clock to zero and remove all the events.
+    */
+    void VirtualTime_Reset(void);
+
+    /**
+    *   \brief Current virtual time in nanoseconds.
+    */
+    uint64_t VirtualTime_Now(void);
+
+    /**
+    *   \brief Let the given amount of virtual time elapse.
+    *
+    *   All the events expiring in the interval are fired in order. If the
+    *   run deadline is reached, control goes back to VirtualTime_Run().
+    *   \param ns Nanoseconds to be elapsed.
+    */
+    void VirtualTime_Advance(uint64_t ns);
+
+    /**
+    *   \brief Jump to the next event and fire it.
+    *
+    *   Used to model a CPU that is halted until the next interrupt.
+    */
+    void VirtualTime_AdvanceToNextEvent(void);
+
+    /**
+    *   \brief Register a periodic event.
+    *   \param period_ns Period of the event in nanoseconds.
+    *   \param handler Function called at each expiration.
+    *   \retval Identifier of the event, negative if no slot is left.
+    */
+    int VirtualTime_AddPeriodic(uint64_t period_ns, VirtualTime_Handler handler);
+
+    /**
+    *   \brief Change the period of an event, restarting it from now.
+    */
+    void VirtualTime_SetPeriod(int event_id, uint64_t period_ns);
+
+    /**
+    *   \brief Stop a periodic event.
+    */
+    void VirtualTime_Remove(int event_id);
+
+    /**
+    *   \brief Run the firmware entry point until the deadline is reached.
+    *
+    *   The entry point is expected never to return, as a firmware main loop.
+    *   \param entry Firmware entry point.
+    *   \param duration_ns Virtual time after which the run is stopped.
+    */
+    void VirtualTime_Run(void (*entry)(void), uint64_t duration_ns);
+
+#endif
+/* [] END OF FILE */